@@ -44,6 +44,59 @@ static char copyright[] =
 
 #define	CMDRXINCR	32		/* CmdRx[] allocation increment */
 
+#if	defined(HASPARDIRWALK) && defined(HASSPECDEVD)
+/*
+ * A HASSPECDEVD function needn't be thread safe, so the directory walk stays
+ * serial.
+ */
+#undef	HASPARDIRWALK
+#endif	/* defined(HASPARDIRWALK) && defined(HASSPECDEVD) */
+
+#if	defined(HASPARDIRWALK)
+#define	DWBATCH		4096		/* directory walk entries a thread
+					 * collects before publishing them */
+#define	DWTHRENV	"LSOFDIRWALKTHREADS"
+					/* environment variable that sets the
+					 * number of directory walk threads */
+#define	DWTHRMAX	64		/* maximum directory walk threads */
+
+
+/*
+ * Local structures
+ */
+
+struct dwent {				/* directory walk entry */
+	char *path;			/* path name */
+	dev_t dev;			/* device */
+	dev_t rdev;			/* raw device */
+	INODETYPE ino;			/* inode number */
+	mode_t mode;			/* mode */
+};
+
+struct dwbatch {			/* published directory walk entries */
+	struct dwent *e;		/* entries */
+	int n;				/* entries used */
+	int na;				/* entries allocated */
+	struct dwbatch *next;		/* next batch */
+};
+
+struct dwq {				/* parallel directory walk queue */
+	pthread_mutex_t mtx;		/* queue lock */
+	pthread_cond_t cv;		/* progress condition */
+	pthread_cond_t wcv;		/* work available condition */
+	char **stk;			/* directories left to walk */
+	int ns;				/* stk[] entries used */
+	int nsa;			/* stk[] entries allocated */
+	struct dwbatch *b;		/* published entry batches */
+	int nb;				/* batches published (progress) */
+	int nbusy;			/* threads walking a directory */
+	int nthr;			/* number of running threads */
+	int expired;			/* the walk has been abandoned */
+	dev_t ddev;			/* device of the top directory */
+	int descend;			/* descend into subdirectories */
+};
+#endif	/* defined(HASPARDIRWALK) */
+
 
 /*
  * Local static variables
@@ -59,9 +112,19 @@ static int NCmdRxA = 0;			/* space allocated to CmdRx[] */
 _PROTOTYPE(static int ckfd_range,(char *first, char *dash, char *last, int *lo, int *hi));
 _PROTOTYPE(static int enter_fd_lst,(char *nm, int lo, int hi, int excl));
 _PROTOTYPE(static int enter_nwad,(struct nwad *n, int sp, int ep, char *s, struct hostent *he));
+_PROTOTYPE(static void enter_selidx,(struct selidx *h, unsigned long id, int ix));
 _PROTOTYPE(static struct hostent *lkup_hostnm,(char *hn, struct nwad *n));
 _PROTOTYPE(static char *isIPv4addr,(char *hn, unsigned char *a, int al));
 
+#if	defined(HASPARDIRWALK)
+_PROTOTYPE(static void pub_dwbatch,(struct dwq *q, struct dwbatch *b, char **sd,
+				    int nsd));
+_PROTOTYPE(static void walk_dir,(struct dwq *q, char *dn));
+_PROTOTYPE(static int walk_dir_par,(char *dn, dev_t ddev, int descend,
+				    int nt));
+_PROTOTYPE(static void *walk_dir_thr,(void *arg));
+#endif	/* defined(HASPARDIRWALK) */
+
 
 /*
  * ckfd_range() - check fd range
@@ -784,6 +847,7 @@ enter_efsys(e, rdlnk)
 	ep->path = path;
 	ep->pathl = i;
 	ep->rdlnk = rdlnk;
+	ep->hung = 0;
 	ep->mp = (struct mounts *)NULL;
 	ep->next = Efsysl;
 	Efsysl = ep;
@@ -996,6 +1060,12 @@ enter_dir(d, descend)
 	MALLOC_S fpl = (MALLOC_S)0;
 	MALLOC_S fpli = (MALLOC_S)0;
 	struct stat sb;
+
+#if	defined(HASPARDIRWALK)
+	char *cp;
+	int nt;
+#endif	/* defined(HASPARDIRWALK) */
+
 /*
  * Check the directory path; reduce symbolic links; stat(2) it; make sure it's
  * really a directory.
@@ -1051,6 +1121,26 @@ enter_dir(d, descend)
 	    av[0] = (char *)NULL;
 	    fct++;
 	}
+
+#if	defined(HASPARDIRWALK)
+/*
+ * Walk the tree with threads, unless the DWTHRENV environment variable asks
+ * for no more than one.  The threads leave the directory stack empty, so the
+ * serial walk below has nothing to do.
+ */
+	if ((cp = getenv(DWTHRENV)))
+	    nt = atoi(cp);
+	else
+	    nt = HASPARDIRWALK;
+	if (nt > 1) {
+	    dn = Dstk[--Dstkx];
+	    Dstk[Dstkx] = (char *)NULL;
+	    fct += walk_dir_par(dn, ddev, descend,
+				(nt > DWTHRMAX) ? DWTHRMAX : nt);
+	    dn = (char *)NULL;
+	}
+#endif	/* defined(HASPARDIRWALK) */
+
 /*
  * Unstack the next directory and examine it.
  */
@@ -1256,6 +1346,86 @@ enter_dir(d, descend)
 }
 
 
+#if	defined(HASDIRPFX)
+/*
+ * enter_dir_pfx() - enter a directory whose files are to be selected by path
+ *		     name prefix
+ */
+
+int
+enter_dir_pfx(d)
+	char *d;			/* directory path name pointer */
+{
+	struct dirpfx *dp;
+	char *dn;
+	int en;
+	size_t nl;
+	struct stat sb;
+/*
+ * Check the directory path; reduce symbolic links; stat(2) it; make sure it's
+ * really a directory.
+ */
+	if (!d || !*d || *d == '+' || *d == '-') {
+	    if (!Fwarn)
+		(void) fprintf(stderr,
+		    "%s: +B not followed by a directory path\n", Pn);
+	    return(1);
+	}
+	if (!(dn = Readlink(d)))
+	    return(1);
+	if (statsafely(dn, &sb)) {
+	    if (!Fwarn) {
+		en = errno;
+		(void) fprintf(stderr, "%s: WARNING: can't stat(", Pn);
+		safestrprt(dn, stderr, 0);
+		(void) fprintf(stderr, "): %s\n", strerror(en));
+	    }
+	    if (dn != d)
+		(void) free((FREE_P *)dn);
+	    return(1);
+	}
+	if ((sb.st_mode & S_IFMT) != S_IFDIR) {
+	    if (!Fwarn) {
+		(void) fprintf(stderr, "%s: WARNING: not a directory: ", Pn);
+		safestrprt(dn, stderr, 1);
+	    }
+	    if (dn != d)
+		(void) free((FREE_P *)dn);
+	    return(1);
+	}
+	if ((dn == d) && !(dn = mkstrcpy(d, (MALLOC_S *)NULL))) {
+	    (void) fprintf(stderr, "%s: no space for +B name: ", Pn);
+	    safestrprt(d, stderr, 1);
+	    Exit(1);
+	}
+/*
+ * Remove trailing '/' characters, leaving "/" alone, so that the name can be
+ * compared to the paths of the files below it.
+ */
+	for (nl = strlen(dn); (nl > 1) && (dn[nl - 1] == '/'); nl--) {
+	    dn[nl - 1] = '\0';
+	}
+/*
+ * Add the directory to the prefix list.
+ */
+	if (!(dp = (struct dirpfx *)malloc(sizeof(struct dirpfx)))) {
+	    (void) fprintf(stderr, "%s: no space for +B entry: ", Pn);
+	    safestrprt(d, stderr, 1);
+	    Exit(1);
+	}
+	dp->aname = d;
+	dp->name = dn;
+	dp->nl = nl;
+	dp->dev = sb.st_dev;
+	dp->xdev = (dev_t *)NULL;
+	dp->nxdev = dp->xdevs = dp->f = 0;
+	dp->next = Dirpfx;
+	Dirpfx = dp;
+	return(0);
+}
+#endif	/* defined(HASDIRPFX) */
+
+
 /*
  * enter_id() - enter PGID or PID for searching
  */
@@ -1266,7 +1436,8 @@ enter_id(ty, p)
 	char *p;			/* process group ID string pointer */
 {
 	char *cp;
-	int err, i, id, j, mx, n, ni, nx, x;
+	int err, i, id, mx, n, ni, nx, x;
+	struct selidx *h;
 	struct int_lst *s;
 
 	if (!p) {
@@ -1284,6 +1455,7 @@ enter_id(ty, p)
 	    ni = Npgidi;
 	    nx = Npgidx;
 	    s = Spgid;
+	    h = &HbySpgid;
 	    break;
 	case PID:
 	    mx = Mxpid;
@@ -1291,6 +1463,7 @@ enter_id(ty, p)
 	    ni = Npidi;
 	    nx = Npidx;
 	    s = Spid;
+	    h = &HbySpid;
 	    break;
 	default:
 	    (void) fprintf(stderr, "%s: enter_id \"", Pn);
@@ -1334,28 +1507,23 @@ enter_id(ty, p)
 	/*
 	 * Avoid entering duplicates and conflicts.
 	 */
-	    for (i = j = 0; i < n; i++) {
-		if (id == s[i].i) {
-		    if (x == s[i].x) {
-			j = 1;
-			continue;
-		    }
+	    if ((i = find_selidx(h, (unsigned long)id)) >= 0) {
+		if (x != s[i].x) {
 		    (void) fprintf(stderr,
 			"%s: P%sID %d has been included and excluded.\n",
 			Pn,
 			(ty == PGID) ? "G" : "",
 			id);
-		    err = j = 1;
-		    break;
+		    err = 1;
 		}
-	    }
-	    if (j)
 		continue;
+	    }
 	/*
-	 * Allocate table table space.
+	 * Allocate table table space, doubling it so that long lists don't
+	 * cost a realloc() per IDINCR IDs.
 	 */
 	    if (n >= mx) {
-		mx += IDINCR;
+		mx = mx ? (mx * 2) : IDINCR;
 		if (!s)
 		    s = (struct int_lst *)malloc(
 			(MALLOC_S)(sizeof(struct int_lst) * mx));
@@ -1370,7 +1538,8 @@ enter_id(ty, p)
 	    }
 	    s[n].f = 0;
 	    s[n].i = id;
-	    s[n++].x = x;
+	    s[n].x = x;
+	    (void) enter_selidx(h, (unsigned long)id, n++);
 	    if (x)
 		nx++;
 	    else
@@ -1885,8 +2054,8 @@ enter_nwad(n, sp, ep, s, he)
 		return(1);
 	    }
 	/*
-	 * Limit the network address chain length to MAXNWAD for reasons of
-	 * search efficiency.
+	 * Limit the network address chain length to MAXNWAD, to bound the
+	 * space of the index_nwad() index.
 	 */
 	    if (na >= MAXNWAD) {
 		(void) fprintf(stderr,
@@ -1947,6 +2116,54 @@ enter_nwad(n, sp, ep, s, he)
 }
 
 
+/*
+ * enter_selidx() - enter a selection ID in its index
+ */
+
+static void
+enter_selidx(h, id, ix)
+	struct selidx *h;		/* index */
+	unsigned long id;		/* PID, PGID or UID */
+	int ix;				/* its selection table index */
+{
+	int i, j, sz;
+	struct selident *t;
+/*
+ * Double the slots when the index would become more than half full.
+ */
+	if ((h->n + 1) * 2 > h->sz) {
+	    sz = h->sz ? (h->sz * 2) : SELIDXMIN;
+	    if (!(t = (struct selident *)malloc(
+		      (MALLOC_S)(sz * sizeof(struct selident)))))
+	    {
+		(void) fprintf(stderr, "%s: no space for %d ID index slots\n",
+		    Pn, sz);
+		Exit(1);
+	    }
+	    for (i = 0; i < sz; i++) {
+		t[i].ix = -1;
+	    }
+	    for (i = 0; i < h->sz; i++) {
+		if (h->t[i].ix < 0)
+		    continue;
+		for (j = SELIDHASH(h->t[i].id, sz); t[j].ix >= 0;
+		     j = (j + 1) & (sz - 1))
+		    ;
+		t[j] = h->t[i];
+	    }
+	    if (h->t)
+		(void) free((FREE_P *)h->t);
+	    h->t = t;
+	    h->sz = sz;
+	}
+	for (j = SELIDHASH(id, h->sz); h->t[j].ix >= 0; j = (j + 1) & (h->sz - 1))
+	    ;
+	h->t[j].id = id;
+	h->t[j].ix = ix;
+	h->n++;
+}
+
+
 #if	defined(HASTCPUDPSTATE)
 /*
  * enter_state_spec() -- enter TCP and UDP state specifications
@@ -2317,26 +2534,20 @@ enter_uid(us)
 	/*
 	 * Avoid entering duplicates.
 	 */
-	    for (i = j = 0; i < Nuid; i++) {
-		if (uid != Suid[i].uid)
-		    continue;
-		if (Suid[i].excl == excl) {
-		    j = 1;
-		    continue;
+	    if ((i = find_selidx(&HbySuid, (unsigned long)uid)) >= 0) {
+		if (Suid[i].excl != excl) {
+		    (void) fprintf(stderr,
+			"%s: UID %d has been included and excluded.\n",
+			    Pn, (int)uid);
+		    err = 1;
 		}
-		(void) fprintf(stderr,
-		    "%s: UID %d has been included and excluded.\n",
-			Pn, (int)uid);
-		err = j = 1;
-		break;
-	    }
-	    if (j)
 		continue;
+	    }
 	/*
 	 * Allocate space for User IDentifier.
 	 */
 	    if (Nuid >= Mxuid) {
-		Mxuid += UIDINCR;
+		Mxuid = Mxuid ? (Mxuid * 2) : UIDINCR;
 		len = (MALLOC_S)(Mxuid * sizeof(struct seluid));
 		if (!Suid)
 		    Suid = (struct seluid *)malloc(len);
@@ -2357,7 +2568,8 @@ enter_uid(us)
 	    } else
 		Suid[Nuid].lnm = (char *)NULL;
 	    Suid[Nuid].uid = uid;
-	    Suid[Nuid++].excl = excl;
+	    Suid[Nuid].excl = excl;
+	    (void) enter_selidx(&HbySuid, (unsigned long)uid, Nuid++);
 	    if (excl)
 		Nuidexcl++;
 	    else
@@ -2502,3 +2714,425 @@ lkup_hostnm(hn, n)
 	    zeromem((char *)&n->a[4], ln);
 	return(he);
 }
+
+
+#if	defined(HASPARDIRWALK)
+/*
+ * pub_dwbatch() - publish a directory walk thread's entries and the
+ *		   subdirectories it found
+ */
+
+static void
+pub_dwbatch(q, b, sd, nsd)
+	struct dwq *q;			/* walk queue */
+	struct dwbatch *b;		/* entry batch (may be NULL) */
+	char **sd;			/* subdirectory paths */
+	int nsd;			/* number of subdirectory paths */
+{
+	int i;
+	MALLOC_S len;
+
+	(void) pthread_mutex_lock(&q->mtx);
+	if (q->expired) {
+
+	/*
+	 * The walk has been abandoned, so nothing more is wanted.
+	 */
+	    (void) pthread_mutex_unlock(&q->mtx);
+	    if (b) {
+		for (i = 0; i < b->n; i++) {
+		    (void) free((FREE_P *)b->e[i].path);
+		}
+		(void) free((FREE_P *)b->e);
+		(void) free((FREE_P *)b);
+	    }
+	    for (i = 0; i < nsd; i++) {
+		(void) free((FREE_P *)sd[i]);
+	    }
+	    return;
+	}
+	if (b) {
+	    b->next = q->b;
+	    q->b = b;
+	}
+	if (nsd) {
+	    if ((q->ns + nsd) > q->nsa) {
+		q->nsa = q->ns + nsd + 128;
+		len = (MALLOC_S)(q->nsa * sizeof(char *));
+		if (q->stk)
+		    q->stk = (char **)realloc((MALLOC_P *)q->stk, len);
+		else
+		    q->stk = (char **)malloc(len);
+		if (!q->stk) {
+		    (void) fprintf(stderr,
+			"%s: no space for directory walk stack\n", Pn);
+		    Exit(1);
+		}
+	    }
+	    for (i = 0; i < nsd; i++) {
+		q->stk[q->ns++] = sd[i];
+	    }
+	    (void) pthread_cond_broadcast(&q->wcv);
+	}
+	q->nb++;
+	(void) pthread_cond_signal(&q->cv);
+	(void) pthread_mutex_unlock(&q->mtx);
+}
+
+
+/*
+ * walk_dir() - walk one directory for walk_dir_thr()
+ *
+ * The entries are examined with fstatat() relative to the directory's
+ * descriptor, instead of with lstatsafely() and statsafely() in a child
+ * process.  Otherwise they are selected as enter_dir() selects them.
+ */
+
+static void
+walk_dir(q, dn)
+	struct dwq *q;			/* walk queue */
+	char *dn;			/* directory path (freed here) */
+{
+	struct dwbatch *b = (struct dwbatch *)NULL;
+	MALLOC_S dnamlen, dnl, len;
+	DIR *dfp;
+	struct DIRTYPE *dp;
+	struct dwent *e;
+	int en, fd, sl;
+	char *fp;
+	int nsd = 0;
+	int nsda = 0;
+	struct stat sb;
+	char **sd = (char **)NULL;
+
+	if (((fd = open(dn, O_RDONLY | O_DIRECTORY)) < 0)
+	||  !(dfp = fdopendir(fd)))
+	{
+	    en = errno;
+	    if (fd >= 0)
+		(void) close(fd);
+	    if (!Fwarn && (en != ENOENT)) {
+		(void) pthread_mutex_lock(&q->mtx);
+		(void) fprintf(stderr, "%s: WARNING: can't opendir(", Pn);
+		safestrprt(dn, stderr, 0);
+		(void) fprintf(stderr, "): %s\n", strerror(en));
+		(void) pthread_mutex_unlock(&q->mtx);
+	    }
+	    (void) free((FREE_P *)dn);
+	    return;
+	}
+	dnl = strlen(dn);
+	sl = ((dnl > 0) && (*(dn + dnl - 1) == '/')) ? 0 : 1;
+	while ((dp = readdir(dfp))) {
+
+	/*
+	 * Skip entries with no inode number, with a zero length name, "."
+	 * and "..".
+	 */
+	    if (!dp->d_ino)
+		continue;
+	    if (!(dnamlen = (MALLOC_S)strlen(dp->d_name)))
+		continue;
+	    if (dnamlen <= 2 && dp->d_name[0] == '.') {
+		if (dnamlen == 1)
+		    continue;
+		if (dp->d_name[1] == '.')
+		    continue;
+	    }
+	/*
+	 * Examine the entry without following a symbolic link.  Skip it if
+	 * it's on another file system, unless "-x" or "-x f" was specified.
+	 */
+	    if (fstatat(fd, dp->d_name, &sb, AT_SYMLINK_NOFOLLOW)) {
+		if (!Fwarn && ((en = errno) != ENOENT)) {
+		    (void) pthread_mutex_lock(&q->mtx);
+		    (void) fprintf(stderr, "%s: WARNING: can't lstat(", Pn);
+		    safestrprt(dn, stderr, 0);
+		    if (sl)
+			putc('/', stderr);
+		    safestrprt(dp->d_name, stderr, 0);
+		    (void) fprintf(stderr, "): %s\n", strerror(en));
+		    (void) pthread_mutex_unlock(&q->mtx);
+		}
+		continue;
+	    }
+	    if (!(Fxover & XO_FILESYS) && (sb.st_dev != q->ddev))
+		continue;
+	    if ((sb.st_mode & S_IFMT) == S_IFLNK) {
+
+	    /*
+	     * Follow a symbolic link if "-x" or "-x l" was specified;
+	     * otherwise skip it.
+	     */
+		if (!(Fxover & XO_SYMLINK))
+		    continue;
+		if (fstatat(fd, dp->d_name, &sb, 0)) {
+		    if (!Fwarn && ((en = errno) != ENOENT)) {
+			(void) pthread_mutex_lock(&q->mtx);
+			(void) fprintf(stderr, "%s: WARNING: can't stat(", Pn);
+			safestrprt(dn, stderr, 0);
+			if (sl)
+			    putc('/', stderr);
+			safestrprt(dp->d_name, stderr, 0);
+			(void) fprintf(stderr, ") symbolic link: %s\n",
+			    strerror(en));
+			(void) pthread_mutex_unlock(&q->mtx);
+		    }
+		    continue;
+		}
+	    }
+	/*
+	 * Form the entry's path name and add the entry to the batch.
+	 */
+	    len = dnl + sl + dnamlen + 1;
+	    if (!(fp = (char *)malloc(len))) {
+		(void) fprintf(stderr, "%s: no space for: ", Pn);
+		safestrprt(dn, stderr, 0);
+		putc('/', stderr);
+		safestrprt(dp->d_name, stderr, 1);
+		Exit(1);
+	    }
+	    (void) snpf(fp, (size_t)len, "%s%s%s", dn, sl ? "/" : "",
+			dp->d_name);
+	    if (!b) {
+		if (!(b = (struct dwbatch *)malloc(sizeof(struct dwbatch)))) {
+		    (void) fprintf(stderr,
+			"%s: no space for directory walk entries\n", Pn);
+		    Exit(1);
+		}
+		b->e = (struct dwent *)NULL;
+		b->n = b->na = 0;
+	    }
+	    if (b->n >= b->na) {
+		b->na = b->na ? (b->na * 2) : 32;
+		len = (MALLOC_S)(b->na * sizeof(struct dwent));
+		if (b->e)
+		    b->e = (struct dwent *)realloc((MALLOC_P *)b->e, len);
+		else
+		    b->e = (struct dwent *)malloc(len);
+		if (!b->e) {
+		    (void) fprintf(stderr,
+			"%s: no space for directory walk entries\n", Pn);
+		    Exit(1);
+		}
+	    }
+	    e = &b->e[b->n++];
+	    e->path = fp;
+	    e->dev = sb.st_dev;
+	    e->rdev = sb.st_rdev;
+	    e->ino = (INODETYPE)sb.st_ino;
+	    e->mode = sb.st_mode;
+	/*
+	 * Save the path of a subdirectory to be walked.
+	 */
+	    if (((sb.st_mode & S_IFMT) == S_IFDIR) && q->descend) {
+		if (nsd >= nsda) {
+		    nsda += 32;
+		    len = (MALLOC_S)(nsda * sizeof(char *));
+		    if (sd)
+			sd = (char **)realloc((MALLOC_P *)sd, len);
+		    else
+			sd = (char **)malloc(len);
+		    if (!sd) {
+			(void) fprintf(stderr,
+			    "%s: no space for directory walk stack\n", Pn);
+			Exit(1);
+		    }
+		}
+		if (!(sd[nsd++] = mkstrcpy(fp, (MALLOC_S *)NULL))) {
+		    (void) fprintf(stderr, "%s: no space for: ", Pn);
+		    safestrprt(fp, stderr, 1);
+		    Exit(1);
+		}
+	    }
+	/*
+	 * Publish a full batch, so that a large directory shows progress and
+	 * its subdirectories can be walked by other threads.
+	 */
+	    if (b->n >= DWBATCH) {
+		(void) pub_dwbatch(q, b, sd, nsd);
+		b = (struct dwbatch *)NULL;
+		nsd = 0;
+	    }
+	}
+	(void) closedir(dfp);
+	(void) free((FREE_P *)dn);
+	(void) pub_dwbatch(q, b, sd, nsd);
+	if (sd)
+	    (void) free((FREE_P *)sd);
+}
+
+
+/*
+ * walk_dir_par() - walk a directory tree for enter_dir() with threads
+ *
+ * return: the number of files recorded for searching
+ *
+ * The walk is abandoned if it makes no progress for TmLimit seconds -- e.g.,
+ * because its threads are blocked on an unresponsive file system.  The files
+ * found until then are recorded.
+ */
+
+static int
+walk_dir_par(dn, ddev, descend, nt)
+	char *dn;			/* top directory path (freed here) */
+	dev_t ddev;			/* top directory's device */
+	int descend;			/* descend into subdirectories */
+	int nt;				/* number of threads */
+{
+	char *av[2];
+	struct dwbatch *b, *bn;
+	int fct = 0;
+	int i, lnb, rv;
+	sigset_t nm, om;
+	pthread_attr_t pa;
+	struct dwq *q;
+	struct stat sb;
+	pthread_t t;
+	struct timespec ts;
+/*
+ * Create the queue with the top directory on its stack.
+ */
+	if (!(q = (struct dwq *)malloc(sizeof(struct dwq)))
+	||  !(q->stk = (char **)malloc(128 * sizeof(char *)))
+	||  !(q->stk[0] = mkstrcpy(dn, (MALLOC_S *)NULL)))
+	{
+	    (void) fprintf(stderr, "%s: no space for directory walk\n", Pn);
+	    Exit(1);
+	}
+	q->ns = 1;
+	q->nsa = 128;
+	q->b = (struct dwbatch *)NULL;
+	q->nb = q->nbusy = q->nthr = q->expired = 0;
+	q->ddev = ddev;
+	q->descend = descend;
+	(void) pthread_mutex_init(&q->mtx, (pthread_mutexattr_t *)NULL);
+	(void) pthread_cond_init(&q->cv, (pthread_condattr_t *)NULL);
+	(void) pthread_cond_init(&q->wcv, (pthread_condattr_t *)NULL);
+/*
+ * Start the walk threads.  They inherit a mask that blocks all signals, so
+ * that the SIGALRM of doinchild() is delivered to the main thread.
+ */
+	(void) pthread_attr_init(&pa);
+	(void) pthread_attr_setdetachstate(&pa, PTHREAD_CREATE_DETACHED);
+	(void) sigfillset(&nm);
+	(void) pthread_sigmask(SIG_BLOCK, &nm, &om);
+	(void) pthread_mutex_lock(&q->mtx);
+	for (i = 0; i < nt; i++) {
+	    if (pthread_create(&t, &pa, walk_dir_thr, (void *)q))
+		break;
+	    q->nthr++;
+	}
+	(void) pthread_sigmask(SIG_SETMASK, &om, (sigset_t *)NULL);
+	(void) pthread_attr_destroy(&pa);
+	if (!q->nthr) {
+
+	/*
+	 * No thread could be started, so walk the tree in this one.
+	 */
+	    q->nthr = 1;
+	    (void) pthread_mutex_unlock(&q->mtx);
+	    (void) walk_dir_thr((void *)q);
+	    (void) pthread_mutex_lock(&q->mtx);
+	}
+/*
+ * Wait for the threads to finish, as long as they make progress.
+ */
+	for (lnb = -1; q->nthr && (q->nb != lnb);) {
+	    lnb = q->nb;
+	    (void) clock_gettime(CLOCK_REALTIME, &ts);
+	    ts.tv_sec += TmLimit;
+	    for (rv = 0; q->nthr && (q->nb == lnb) && (rv != ETIMEDOUT);) {
+		rv = pthread_cond_timedwait(&q->cv, &q->mtx, &ts);
+	    }
+	}
+	q->expired = 1;
+	if (q->nthr && !Fwarn) {
+	    (void) fprintf(stderr,
+		"%s: WARNING: directory walk made no progress in %d seconds;",
+		Pn, TmLimit);
+	    (void) fprintf(stderr, " files may be missing under: ");
+	    safestrprt(dn, stderr, 1);
+	}
+	(void) free((FREE_P *)dn);
+	b = q->b;
+	q->b = (struct dwbatch *)NULL;
+	while (q->ns > 0) {
+	    (void) free((FREE_P *)q->stk[--q->ns]);
+	}
+/*
+ * Threads still blocked in a system call are abandoned; they reference the
+ * queue, so it may be released only when none remain.
+ */
+	i = q->nthr;
+	(void) pthread_mutex_unlock(&q->mtx);
+	if (!i) {
+	    (void) pthread_cond_destroy(&q->wcv);
+	    (void) pthread_cond_destroy(&q->cv);
+	    (void) pthread_mutex_destroy(&q->mtx);
+	    (void) free((FREE_P *)q->stk);
+	    (void) free((FREE_P *)q);
+	}
+/*
+ * Use ck_file_arg() to record the entries for searching, as enter_dir()
+ * does.
+ */
+	av[1] = (char *)NULL;
+	for (; b; b = bn) {
+	    bn = b->next;
+	    for (i = 0; i < b->n; i++) {
+		zeromem((char *)&sb, sizeof(sb));
+		sb.st_dev = b->e[i].dev;
+		sb.st_rdev = b->e[i].rdev;
+		sb.st_ino = (ino_t)b->e[i].ino;
+		sb.st_mode = b->e[i].mode;
+		av[0] = b->e[i].path;
+		if (!ck_file_arg(0, 1, av, 1, 1, &sb))
+		    fct++;
+		else
+		    (void) free((FREE_P *)av[0]);
+	    }
+	    (void) free((FREE_P *)b->e);
+	    (void) free((FREE_P *)b);
+	}
+	return(fct);
+}
+
+
+/*
+ * walk_dir_thr() - directory walk thread
+ */
+
+static void *
+walk_dir_thr(arg)
+	void *arg;			/* walk queue */
+{
+	char *dn;
+	struct dwq *q = (struct dwq *)arg;
+
+	(void) pthread_mutex_lock(&q->mtx);
+	for (;;) {
+
+	/*
+	 * Wait for a directory to walk.  The walk is done when there are
+	 * none and no other thread is walking one that may yield more.
+	 */
+	    while (!q->expired && !q->ns && q->nbusy) {
+		(void) pthread_cond_wait(&q->wcv, &q->mtx);
+	    }
+	    if (q->expired || !q->ns)
+		break;
+	    dn = q->stk[--q->ns];
+	    q->nbusy++;
+	    (void) pthread_mutex_unlock(&q->mtx);
+	    (void) walk_dir(q, dn);
+	    (void) pthread_mutex_lock(&q->mtx);
+	    if ((--q->nbusy == 0) && !q->ns)
+		(void) pthread_cond_broadcast(&q->wcv);
+	}
+	if (--q->nthr == 0)
+	    (void) pthread_cond_signal(&q->cv);
+	(void) pthread_mutex_unlock(&q->mtx);
+	return((void *)NULL);
+}
+#endif	/* defined(HASPARDIRWALK) */
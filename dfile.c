@@ -0,0 +1 @@
+dialects/linux/dfile.c
\ No newline at end of file
@@ -47,6 +47,13 @@ struct hsfile {
 	struct hsfile *next;		/* the next hash bucket entry */
 };
 
+struct sysdevnm {			/* sysfs device name memo entry */
+	dev_t rdev;			/* device number */
+	int blk;			/* 1 = block device */
+	char *nm;			/* /dev path (NULL = no sysfs name) */
+	struct sysdevnm *next;		/* the next hash bucket entry */
+};
+
 /*
  * Local static variables
  */
@@ -54,38 +61,191 @@ struct hsfile {
 static struct hsfile *HbyFdi =		/* hash by file (dev,ino) buckets */
 	(struct hsfile *)NULL;
 static int HbyFdiCt = 0;		/* HbyFdi entry count */
+static int HbyFdiSz = 0;		/* HbyFdi bucket count */
 static struct hsfile *HbyFrd =		/* hash by file raw device buckets */
 	(struct hsfile *)NULL;
 static int HbyFrdCt = 0;		/* HbyFrd entry count */
+static int HbyFrdSz = 0;		/* HbyFrd bucket count */
 static struct hsfile *HbyFsd =		/* hash by file system buckets */
 	(struct hsfile *)NULL;
 static int HbyFsdCt = 0;		/* HbyFsd entry count */
+static int HbyFsdSz = 0;		/* HbyFsd bucket count */
 static struct hsfile *HbyNm =		/* hash by name buckets */
 	(struct hsfile *)NULL;
 static int HbyNmCt = 0;			/* HbyNm entry count */
+static int HbyNmSz = 0;			/* HbyNm bucket count */
+static struct sysdevnm **SysDevNm =	/* sysfs device name memo buckets */
+	(struct sysdevnm **)NULL;
 
 
 /*
  * Local definitions
  */
 
-#define	SFDIHASH	4094		/* Sfile hash by (device,inode) number
-					 * pair bucket count (power of 2!) */
-#define	SFFSHASH	1024		/* Sfile hash by file system device
-					 * number bucket count (power of 2!) */
-#define SFHASHDEVINO(maj, min, ino, mod) ((int)(((int)((((int)(maj+1))*((int)((min+1))))+ino)*31415)&(mod-1)))
-					/* hash for Sfile by major device,
-					 * minor device, and inode, modulo mod
-					 * (mod must be a power of 2) */
-#define	SFRDHASH	1024		/* Sfile hash by raw device number
-					 * bucket count (power of 2!) */
-#define SFHASHRDEVI(maj, min, rmaj, rmin, ino, mod) ((int)(((int)((((int)(maj+1))*((int)((min+1))))+((int)(rmaj+1)*(int)(rmin+1))+ino)*31415)&(mod-1)))
-					/* hash for Sfile by major device,
-					 * minor device, major raw device,
-					 * minor raw device, and inode, modulo
-					 * mod (mod must be a power of 2) */
-#define	SFNMHASH	4096		/* Sfile hash by name bucket count
-					 * (must be a power of 2!) */
+#define	SFHASHLOAD	4		/* average Sfile hash chain length */
+#define	SFHASHMIN	64		/* minimum Sfile hash bucket count
+					 * (power of 2!) */
+#define	SYSDEVHASH	64		/* sysfs device name memo bucket count
+					 * (power of 2!) */
+
+
+/*
+ * Local function prototypes
+ */
+
+_PROTOTYPE(static struct hsfile *alloc_sfhash,(int ct, int *sz, char *ty));
+_PROTOTYPE(static char *get_sysdevnm,(dev_t rdev, int blk));
+_PROTOTYPE(static int hash_sfdev,(dev_t dev, dev_t rdev, INODETYPE ino, int mod));
+_PROTOTYPE(static int hash_sfnm,(char *nm, int mod));
+
+
+/*
+ * alloc_sfhash() - allocate Sfile hash buckets for an entry count
+ */
+
+static struct hsfile *
+alloc_sfhash(ct, sz, ty)
+	int ct;				/* entry count */
+	int *sz;			/* returned bucket count */
+	char *ty;			/* hash type, for error messages */
+{
+	struct hsfile *h;
+	int n;
+/*
+ * Make the bucket count the smallest power of 2 that keeps the average chain
+ * no longer than SFHASHLOAD entries.  (Longer chains would make every open
+ * file's search slower; more buckets would make building the hashes for a
+ * large +D tree slower, as they would no longer fit in the cache.)
+ */
+	for (n = SFHASHMIN; (n < ct / SFHASHLOAD) && (n < (INT_MAX / 2));
+	     n <<= 1)
+	    ;
+	if (!(h = (struct hsfile *)calloc((MALLOC_S)n, sizeof(struct hsfile))))
+	{
+	    (void) fprintf(stderr,
+		"%s: can't allocate space for %d %s hash buckets\n",
+		Pn, n, ty);
+	    Exit(1);
+	}
+	*sz = n;
+	return(h);
+}
+
+
+/*
+ * get_sysdevnm() - get a device's /dev path from sysfs
+ *
+ * The DEVNAME= line of /sys/dev/{block,char}/<major>:<minor>/uevent names the
+ * device under /dev.  Names, and their absence, are remembered.
+ */
+
+static char *
+get_sysdevnm(rdev, blk)
+	dev_t rdev;			/* device number */
+	int blk;			/* 1 = block device */
+{
+	char buf[MAXPATHLEN], *cp;
+	int h;
+	FILE *fs;
+	MALLOC_S len;
+	struct sysdevnm *sp;
+
+	if (!SysDevNm) {
+	    if (!(SysDevNm = (struct sysdevnm **)calloc(SYSDEVHASH,
+						sizeof(struct sysdevnm *))))
+	    {
+		(void) fprintf(stderr,
+		    "%s: no space for sysfs device name hash buckets\n", Pn);
+		Exit(1);
+	    }
+	}
+	h = (int)((GET_MAJ_DEV(rdev) * 31 + GET_MIN_DEV(rdev))
+		  & (SYSDEVHASH - 1));
+	for (sp = SysDevNm[h]; sp; sp = sp->next) {
+	    if ((sp->rdev == rdev) && (sp->blk == blk))
+		return(sp->nm);
+	}
+	if (!(sp = (struct sysdevnm *)malloc(sizeof(struct sysdevnm)))) {
+	    (void) fprintf(stderr,
+		"%s: no space for sysfs device name entry\n", Pn);
+	    Exit(1);
+	}
+	sp->rdev = rdev;
+	sp->blk = blk;
+	sp->nm = (char *)NULL;
+	sp->next = SysDevNm[h];
+	SysDevNm[h] = sp;
+	(void) snpf(buf, sizeof(buf), "/sys/dev/%s/%d:%d/uevent",
+		    blk ? "block" : "char",
+		    (int)GET_MAJ_DEV(rdev), (int)GET_MIN_DEV(rdev));
+	if (!(fs = open_proc_stream(buf, "r", (char **)NULL, (size_t *)NULL,
+				    0)))
+	    return((char *)NULL);
+	while (fgets(buf, sizeof(buf), fs)) {
+	    if (strncmp(buf, "DEVNAME=", 8) || !buf[8])
+		continue;
+	    if ((cp = strchr(&buf[8], '\n')))
+		*cp = '\0';
+	    len = (MALLOC_S)(strlen(&buf[8]) + sizeof("/dev/"));
+	    if (!(sp->nm = (char *)malloc(len))) {
+		(void) fprintf(stderr,
+		    "%s: no space for sysfs device name: /dev/%s\n",
+		    Pn, &buf[8]);
+		Exit(1);
+	    }
+	    (void) snpf(sp->nm, (size_t)len, "/dev/%s", &buf[8]);
+	    break;
+	}
+	(void) fclose(fs);
+	return(sp->nm);
+}
+
+
+/*
+ * hash_sfdev() - hash Sfile device, raw device and inode numbers
+ *
+ * The numbers are mixed with a 64 bit finalizer, so that the low order bits
+ * that select the bucket depend on all of them.
+ */
+
+static int
+hash_sfdev(dev, rdev, ino, mod)
+	dev_t dev;			/* device */
+	dev_t rdev;			/* raw device */
+	INODETYPE ino;			/* inode number */
+	int mod;			/* bucket count (power of 2) */
+{
+	unsigned long long h;
+
+	h = ((unsigned long long)dev * 0x9e3779b97f4a7c15ULL)
+	  ^ (unsigned long long)rdev;
+	h = (h * 0x9e3779b97f4a7c15ULL) ^ (unsigned long long)ino;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return((int)(h & (unsigned long long)(mod - 1)));
+}
+
+
+/*
+ * hash_sfnm() - hash an Sfile name (FNV-1a)
+ */
+
+static int
+hash_sfnm(nm, mod)
+	char *nm;			/* name */
+	int mod;			/* bucket count (power of 2) */
+{
+	unsigned int h = 2166136261U;
+
+	for (; *nm; nm++) {
+	    h = (h ^ (unsigned int)(unsigned char)*nm) * 16777619U;
+	}
+	h ^= h >> 15;
+	return((int)(h & (unsigned int)(mod - 1)));
+}
 
 
 /*
@@ -96,51 +256,46 @@ void
 hashSfile()
 {
 	static int hs = 0;
-	int i;
+	int i, n;
 	struct sfile *s;
 	struct hsfile *sh, *sn;
+	struct hsfile *sp = (struct hsfile *)NULL;
 /*
  * Do nothing if there are no file search arguments cached or if the
  * hashes have already been constructed.
  */
 	if (!Sfile || hs)
 	    return;
+	hs++;
 /*
- * Allocate hash buckets by (device,inode), file system device, and file name.
+ * Count the entries of each hash, so that its buckets can be sized to fit.
  */
-	if (!(HbyFdi = (struct hsfile *)calloc((MALLOC_S)SFDIHASH,
-					       sizeof(struct hsfile))))
-	{
-	    (void) fprintf(stderr,
-		"%s: can't allocate space for %d (dev,ino) hash buckets\n",
-		Pn, SFDIHASH);
-	    Exit(1);
+	for (n = 0, s = Sfile; s; s = s->next) {
+	    if (s->aname)
+		HbyNmCt++;
+	    if (s->type)
+		HbyFdiCt++;
+	    else
+		HbyFsdCt++;
+	    if ((s->mode == S_IFCHR) || (s->mode == S_IFBLK))
+		HbyFrdCt++;
 	}
-	if (!(HbyFrd = (struct hsfile *)calloc((MALLOC_S)SFRDHASH,
-					       sizeof(struct hsfile))))
-	{
-	    (void) fprintf(stderr,
-		"%s: can't allocate space for %d rdev hash buckets\n",
-		Pn, SFRDHASH);
-	    Exit(1);
-	}
-	if (!(HbyFsd = (struct hsfile *)calloc((MALLOC_S)SFFSHASH,
-					       sizeof(struct hsfile))))
-	{
-	    (void) fprintf(stderr,
-		"%s: can't allocate space for %d file sys hash buckets\n",
-		Pn, SFFSHASH);
-	    Exit(1);
-	}
-	if (!(HbyNm = (struct hsfile *)calloc((MALLOC_S)SFNMHASH,
-					      sizeof(struct hsfile))))
+	n = HbyNmCt + HbyFdiCt + HbyFsdCt + HbyFrdCt;
+/*
+ * Allocate hash buckets by (device,inode), file system device, and file name,
+ * and space for the chain entries beyond the buckets' first ones.
+ */
+	HbyFdi = alloc_sfhash(HbyFdiCt, &HbyFdiSz, "(dev,ino)");
+	HbyFrd = alloc_sfhash(HbyFrdCt, &HbyFrdSz, "rdev");
+	HbyFsd = alloc_sfhash(HbyFsdCt, &HbyFsdSz, "file sys");
+	HbyNm = alloc_sfhash(HbyNmCt, &HbyNmSz, "name");
+	if (!(sp = (struct hsfile *)malloc((MALLOC_S)(n * sizeof(struct hsfile)))))
 	{
 	    (void) fprintf(stderr,
-		"%s: can't allocate space for %d name hash buckets\n",
-		Pn, SFNMHASH);
+		"%s: can't allocate space for %d hsfile chain entries\n",
+		Pn, n);
 	    Exit(1);
 	}
-	hs++;
 /*
  * Scan the Sfile chain, building file, file system, raw device, and file
  * name hash bucket chains.
@@ -151,53 +306,32 @@ hashSfile()
 		case 0:			/* hash by name */
 		    if (!s->aname)
 			continue;
-		    sh = &HbyNm[hashbyname(s->aname, SFNMHASH)];
-		    HbyNmCt++;
+		    sh = &HbyNm[hash_sfnm(s->aname, HbyNmSz)];
 		    break;
 		case 1:			/* hash by device and inode, or file
 					 * system device */
-		    if (s->type) {
-			sh = &HbyFdi[SFHASHDEVINO(GET_MAJ_DEV(s->dev),
-						  GET_MIN_DEV(s->dev), s->i,
-						  SFDIHASH)];
-			HbyFdiCt++;
-		    } else {
-			sh = &HbyFsd[SFHASHDEVINO(GET_MAJ_DEV(s->dev),
-						  GET_MIN_DEV(s->dev),
-						  0,
-						  SFFSHASH)];
-			HbyFsdCt++;
-		    }
+		    if (s->type)
+			sh = &HbyFdi[hash_sfdev(s->dev, 0, s->i, HbyFdiSz)];
+		    else
+			sh = &HbyFsd[hash_sfdev(s->dev, 0, 0, HbyFsdSz)];
 		    break;
 		case 2:			/* hash by file's raw device */
 		    if ((s->mode == S_IFCHR) || (s->mode == S_IFBLK)) {
-			sh = &HbyFrd[SFHASHRDEVI(GET_MAJ_DEV(s->dev),
-						 GET_MIN_DEV(s->dev),
-						 GET_MAJ_DEV(s->rdev),
-						 GET_MIN_DEV(s->rdev),
-						 s->i,
-						 SFRDHASH)];
-			HbyFrdCt++;
+			sh = &HbyFrd[hash_sfdev(s->dev, s->rdev, s->i,
+						HbyFrdSz)];
 		    } else
 			continue;
 		}
 	    /*
-	     * Add hash to the bucket's chain, allocating new entries for
-	     * all after the first.
+	     * Add hash to the bucket's chain, taking entries for all after
+	     * the first from the chain entry space.
 	     */
 		if (!sh->s) {
 		    sh->s = s;
 		    sh->next = (struct hsfile *)NULL;
 		    continue;
 		} else {
-		    if (!(sn = (struct hsfile *)malloc(
-				(MALLOC_S)sizeof(struct hsfile))))
-		    {
-			(void) fprintf(stderr,
-			    "%s: can't allocate hsfile bucket for: %s\n",
-			    Pn, s->aname);
-			Exit(1);
-		    }
+		    sn = sp++;
 		    sn->s = s;
 		    sn->next = sh->next;
 		    sh->next = sn;
@@ -239,7 +373,7 @@ is_file_named(ty, p, mp, cd)
  * Check for a path name match, as requested.
  */
 	if ((ty == 2) && p && HbyNmCt) {
-	    for (sh = &HbyNm[hashbyname(p, SFNMHASH)]; sh; sh = sh->next) {
+	    for (sh = &HbyNm[hash_sfnm(p, HbyNmSz)]; sh; sh = sh->next) {
 		if ((s = sh->s) && strcmp(p, s->aname) == 0) {
 		    f = 2;
 		    break;
@@ -252,10 +386,7 @@ is_file_named(ty, p, mp, cd)
 	if (!f && (ty < 2) && HbyFdiCt && Lf->dev_def
 	&& (Lf->inp_ty == 1 || Lf->inp_ty == 3))
 	{
-	    for (sh = &HbyFdi[SFHASHDEVINO(GET_MAJ_DEV(Lf->dev),
-					   GET_MIN_DEV(Lf->dev),
-					   Lf->inode,
-					   SFDIHASH)];
+	    for (sh = &HbyFdi[hash_sfdev(Lf->dev, 0, Lf->inode, HbyFdiSz)];
 		 sh;
 		 sh = sh->next)
 	    {
@@ -270,9 +401,7 @@ is_file_named(ty, p, mp, cd)
  * Check for a file system match.
  */
 	if (!f && (ty == 1) && HbyFsdCt && Lf->dev_def) {
-	    for (sh = &HbyFsd[SFHASHDEVINO(GET_MAJ_DEV(Lf->dev),
-	    				   GET_MIN_DEV(Lf->dev), 0,
-					   SFFSHASH)];
+	    for (sh = &HbyFsd[hash_sfdev(Lf->dev, 0, 0, HbyFsdSz)];
 		 sh;
 		 sh = sh->next)
 	    {
@@ -315,11 +444,8 @@ is_file_named(ty, p, mp, cd)
 	&&  Lf->rdev_def
 	&& (Lf->inp_ty == 1 || Lf->inp_ty == 3))
 	{
-	    for (sh = &HbyFrd[SFHASHRDEVI(GET_MAJ_DEV(Lf->dev),
-					  GET_MIN_DEV(Lf->dev),
-					  GET_MAJ_DEV(Lf->rdev),
-					  GET_MIN_DEV(Lf->rdev),
-					  Lf->inode, SFRDHASH)];
+	    for (sh = &HbyFrd[hash_sfdev(Lf->dev, Lf->rdev, Lf->inode,
+					 HbyFrdSz)];
 		 sh;
 		 sh = sh->next)
 	    {
@@ -361,12 +487,92 @@ is_file_named(ty, p, mp, cd)
 }
 
 
+#if	defined(HASDIRPFX)
+/*
+ * is_file_pfx() - is this file below a +B directory?
+ *
+ * The path is the one /proc reports, so it has no symbolic links and needs no
+ * stat(2) of the directory tree.  As +D does, select only files on the
+ * directory's file system, or, when "-x f" was specified, also those on the
+ * file systems mounted below it.
+ */
+
+int
+is_file_pfx(p, dev, dd)
+	char *p;			/* path name */
+	dev_t dev;			/* device */
+	int dd;				/* dev is defined */
+{
+	dev_t *dvp;
+	struct dirpfx *dp;
+	int f = 0;
+	int i, n;
+	struct mounts *mp;
+
+	if (!p || (*p != '/'))
+	    return(0);
+	for (dp = Dirpfx; dp; dp = dp->next) {
+
+	/*
+	 * The path must be the directory's name, or its name followed by a
+	 * '/'.
+	 */
+	    if ((dp->nl > 1)
+	    &&  (strncmp(p, dp->name, dp->nl)
+	    ||   (p[dp->nl] && (p[dp->nl] != '/'))))
+		continue;
+	    if (dd && (dev != dp->dev)) {
+		if (!(Fxover & XO_FILESYS))
+		    continue;
+	    /*
+	     * Build the list of the devices of the file systems mounted below
+	     * the directory once, from the mount table.
+	     */
+		if (!dp->xdevs) {
+		    for (mp = readmnt(), n = 0; mp; mp = mp->next) {
+			if (!(mp->ds & SB_DEV) || !mp->dir
+			||  ((dp->nl > 1)
+			&&   (strncmp(mp->dir, dp->name, dp->nl)
+			||    (mp->dir[dp->nl] && (mp->dir[dp->nl] != '/')))))
+			    continue;
+			if (n >= dp->nxdev) {
+			    dp->nxdev += 16;
+			    if (!(dvp = (dev_t *)realloc((MALLOC_P *)dp->xdev,
+					(MALLOC_S)(dp->nxdev * sizeof(dev_t)))))
+			    {
+				(void) fprintf(stderr,
+				    "%s: no space for +B devices: ", Pn);
+				safestrprt(dp->aname, stderr, 1);
+				Exit(1);
+			    }
+			    dp->xdev = dvp;
+			}
+			dp->xdev[n++] = mp->dev;
+		    }
+		    dp->nxdev = n;
+		    dp->xdevs = 1;
+		}
+		for (i = 0; i < dp->nxdev; i++) {
+		    if (dp->xdev[i] == dev)
+			break;
+		}
+		if (i >= dp->nxdev)
+		    continue;
+	    }
+	    dp->f = f = 1;
+	}
+	return(f);
+}
+#endif	/* defined(HASDIRPFX) */
+
+
 /*
  * printdevname() - print character device name
  *
  * Note: this function should not be needed in /proc-based lsof, but
  *	 since it is called by printname() in print.c, an ersatz one
- *	 is provided here.
+ *	 is provided here.  It names the device from sysfs, or failing that,
+ *	 by its major and minor numbers.
  */
 
 int
@@ -376,8 +582,12 @@ printdevname(dev, rdev, f, nty)
         int f;                          /* 1 = follow with '\n' */
 	int nty;			/* node type: N_BLK or N_chr */
 {
-	char buf[128];
+	char buf[128], *nm;
 
+	if ((nm = get_sysdevnm(*rdev, (nty == N_BLK) ? 1 : 0))) {
+	    safestrprt(nm, stdout, f);
+	    return(1);
+	}
 	(void) snpf(buf, sizeof(buf), "%s device: %d,%d",
 		    (nty == N_BLK) ? "BLK" : "CHR",
 		    (int)GET_MAJ_DEV(*rdev), (int)GET_MIN_DEV(*rdev));
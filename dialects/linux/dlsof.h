@@ -179,7 +179,8 @@ typedef struct pxinfo {			/* hashed pipe, UNIX socket or pseudo-
 	INODETYPE ino;			/* file's inode */
 	struct lfile *lf;		/* connected peer file */
 	int lpx;			/* connected process index */
-	struct pxinfo *next;		/* next entry for hashed inode */
+	struct pxinfo *next;		/* next file with the same endpoint
+					 * ID */
 } pxinfo_t;
 # endif	/* defined(HASEPTOPTS) */
 
@@ -47,12 +47,41 @@ static char copyright[] =
 					 * !!!MUST BE A POWER OF 2!!! */
 #endif	/* defined(HASMNTSUP) */
 
+#if	defined(HASMNTDEVIX)
+#define	MNTIXMIN	64		/* minimum mount index hash bucket
+					 * count -- !!!MUST BE A POWER OF 2!!! */
+#define	MNTPFXMAX	64		/* maximum path prefixes find_mntdev()
+					 * probes */
+#endif	/* defined(HASMNTDEVIX) */
+
+#if	defined(HASMNTNS)
+#define	MNTNSHASH	128		/* mount namespace hash bucket count
+					 * !!!MUST BE A POWER OF 2!!! */
+#endif	/* defined(HASMNTNS) */
+
+#define	MNTDIRHASH	1024		/* mounted directory and file system
+					 * name hash bucket count
+					 * !!!MUST BE A POWER OF 2!!! */
+
 
 /*
  * Local function prototypes
  */
 
 _PROTOTYPE(static char *cvtoe,(char *os));
+_PROTOTYPE(static int get_mntinfo,(char *ln, int tr, char **fs, char **dir, char **ty, dev_t *dev));
+_PROTOTYPE(static int hash_mntnm,(char *nm));
+_PROTOTYPE(static int is_mntinfo_dev,(char *ty));
+
+_PROTOTYPE(static struct mounts *read_mnt,(int pid));
+
+#if	defined(HASMNTDEVIX)
+_PROTOTYPE(static struct mounts *find_mnt_ns,(struct mntns *nsp, dev_t dev, char *p));
+_PROTOTYPE(static struct mntns *get_mntns,(void));
+_PROTOTYPE(static unsigned int hash_mntdev,(dev_t dev));
+_PROTOTYPE(static void index_mnt,(struct mntns *nsp));
+_PROTOTYPE(static int is_mnt_pfx,(struct mounts *mp, char *p));
+#endif	/* defined(HASMNTDEVIX) */
 
 #if	defined(HASMNTSUP)
 _PROTOTYPE(static int getmntdev,(char *dn, size_t dnl, struct stat *s, int *ss));
@@ -64,6 +93,33 @@ _PROTOTYPE(static int hash_mnt,(char *dn));
  * Local structure definitions.
  */
 
+typedef struct mnthash {		/* readmnt() name hash entry */
+	struct mounts *mp;		/* mount entry */
+	struct mnthash *next;		/* next bucket entry */
+} mnthash_t;
+
+#if	defined(HASMNTDEVIX)
+typedef struct mntix {			/* mount index entry */
+	struct mounts *mp;		/* mount entry */
+	struct mntix *dnext;		/* next entry of the device hash
+					 * bucket, in table order */
+	struct mntix *pnext;		/* next entry of the (device, directory)
+					 * hash bucket */
+} mntix_t;
+
+typedef struct mntns {			/* mount namespace */
+	INODETYPE ino;			/* /proc/<pid>/ns/mnt inode number */
+	struct mounts *lmi;		/* mount table (NULL if unreadable) */
+	mntix_t **mixdev;		/* lmi entries hashed by device */
+	mntix_t **mixpfx;		/* lmi entries hashed by device and
+					 * directory */
+	mntix_t *mix;			/* mixdev[] and mixpfx[] entries */
+	int mixsz;			/* mixdev[] and mixpfx[] bucket count */
+	int nfs;			/* lmi has an NFS mount */
+	struct mntns *next;		/* next Mntnsh[] bucket entry */
+} mntns_t;
+#endif	/* defined(HASMNTDEVIX) */
+
 #if	defined(HASMNTSUP)
 typedef struct mntsup {
 	char *dn;			/* mounted directory name */
@@ -84,6 +140,63 @@ static int Lmist = 0;					/* Lmi status */
 static mntsup_t **MSHash = (mntsup_t **)NULL;		/* mount supplement
 							 * hash buckets */
 
+#if	defined(HASMNTDEVIX)
+static mntns_t Mntself;					/* lsof's own mount
+							 * namespace, whose
+							 * table is Lmi */
+#endif	/* defined(HASMNTDEVIX) */
+
+#if	defined(HASMNTNS)
+static int Mntselfi = 0;				/* Mntself.ino status */
+static mntns_t **Mntnsh = (mntns_t **)NULL;		/* other mount
+							 * namespaces, hashed
+							 * by inode number */
+#endif	/* defined(HASMNTNS) */
+
+
+#if	defined(HASMNTNS)
+/*
+ * clr_mntns() - clear the tables of other mount namespaces
+ *
+ * They're read again when next needed, so that each repeat cycle sees the
+ * namespaces' current mounts.
+ */
+
+void
+clr_mntns()
+{
+	int h;
+	struct mounts *mp, *mpn;
+	mntns_t *nsp, *nspn;
+
+	if (!Mntnsh)
+	    return;
+	for (h = 0; h < MNTNSHASH; h++) {
+	    for (nsp = Mntnsh[h]; nsp; nsp = nspn) {
+		nspn = nsp->next;
+		for (mp = nsp->lmi; mp; mp = mpn) {
+		    mpn = mp->next;
+		    if (mp->dir)
+			(void) free((FREE_P *)mp->dir);
+		    if (mp->fsname)
+			(void) free((FREE_P *)mp->fsname);
+		    if (mp->fsnmres)
+			(void) free((FREE_P *)mp->fsnmres);
+		    (void) free((FREE_P *)mp);
+		}
+		if (nsp->mixdev)
+		    (void) free((FREE_P *)nsp->mixdev);
+		if (nsp->mixpfx)
+		    (void) free((FREE_P *)nsp->mixpfx);
+		if (nsp->mix)
+		    (void) free((FREE_P *)nsp->mix);
+		(void) free((FREE_P *)nsp);
+	    }
+	    Mntnsh[h] = (mntns_t *)NULL;
+	}
+}
+#endif	/* defined(HASMNTNS) */
+
 
 /*
  * cvtoe() -- convert octal-escaped characters in string
@@ -174,6 +287,294 @@ cvtoe(os)
 }
 
 
+#if	defined(HASMNTDEVIX)
+/*
+ * find_mnt_ns() - find the mount of a device in a mount namespace's table
+ *
+ * Without a path, the table's first entry for the device is returned, as a
+ * scan of the table would find it.  With one, it's the entry whose directory
+ * is the longest path component prefix of the path -- i.e., the bind mount
+ * the file was reached through -- or NULL if there's none.
+ */
+
+static struct mounts *
+find_mnt_ns(nsp, dev, p)
+	mntns_t *nsp;			/* mount namespace */
+	dev_t dev;			/* device */
+	char *p;			/* file path (NULL if none) */
+{
+	unsigned int dh, h;
+	unsigned int ph[MNTPFXMAX];	/* prefix hashes */
+	size_t pl[MNTPFXMAX];		/* prefix lengths */
+	int i, n, np;
+	mntix_t *mx, *mxf;
+	struct mounts *mp;
+
+	if (!nsp->mixsz)
+	    return((struct mounts *)NULL);
+	dh = hash_mntdev(dev);
+	for (mxf = (mntix_t *)NULL, n = 0, mx = nsp->mixdev[dh & (nsp->mixsz - 1)];
+	     mx;
+	     mx = mx->dnext)
+	{
+	    if (mx->mp->dev == dev) {
+		if (!mxf)
+		    mxf = mx;
+		n++;
+	    }
+	}
+	if (!mxf || !p)
+	    return(mxf ? mxf->mp : (struct mounts *)NULL);
+	if (n == 1)
+	    return(is_mnt_pfx(mxf->mp, p) ? mxf->mp : (struct mounts *)NULL);
+/*
+ * The device has several mounts.  Hash the path's prefixes that end at
+ * component boundaries, and probe for them from the longest.  A path too
+ * deep for the prefix arrays is matched by a scan of the device's mounts.
+ */
+	if (*p != '/')
+	    return((struct mounts *)NULL);
+	for (h = 2166136261U, i = np = 0; ; i++) {
+	    if (((i == 1) || !p[i] || (p[i] == '/')) && i) {
+		if (np >= MNTPFXMAX)
+		    break;
+		ph[np] = h;
+		pl[np++] = (size_t)i;
+	    }
+	    if (!p[i])
+		break;
+	    h = (h ^ (unsigned int)(unsigned char)p[i]) * 16777619U;
+	}
+	if (np >= MNTPFXMAX) {
+	    for (mp = (struct mounts *)NULL, mx = mxf; mx; mx = mx->dnext) {
+		if ((mx->mp->dev == dev) && is_mnt_pfx(mx->mp, p)
+		&&  (!mp || (mx->mp->dirl > mp->dirl)))
+		    mp = mx->mp;
+	    }
+	    return(mp);
+	}
+	while (np-- > 0) {
+	    for (mx = nsp->mixpfx[(ph[np] ^ dh) & (nsp->mixsz - 1)];
+		 mx;
+		 mx = mx->pnext)
+	    {
+		mp = mx->mp;
+		if ((mp->dev == dev) && (mp->dirl == pl[np])
+		&&  !strncmp(mp->dir, p, pl[np]))
+		    return(mp);
+	    }
+	}
+	return((struct mounts *)NULL);
+}
+
+
+/*
+ * find_mntdev() - find the mount of a device
+ *
+ * The table searched is that of the mount namespace of the current process,
+ * Lp, when it can be read, or else lsof's own.  See find_mnt_ns() for the
+ * entry returned.
+ */
+
+struct mounts *
+find_mntdev(dev, p)
+	dev_t dev;			/* device */
+	char *p;			/* file path (NULL if none) */
+{
+	return(find_mnt_ns(get_mntns(), dev, p));
+}
+#endif	/* defined(HASMNTDEVIX) */
+
+
+/*
+ * find_mntpath() - find the mount of a path
+ *
+ * The entry returned is the one whose directory is the longest path component
+ * prefix of the path, and the last such one in the table -- i.e., the mount
+ * that covers the others on the same directory.  The table searched is that
+ * of find_mntdev().
+ */
+
+struct mounts *
+find_mntpath(p)
+	char *p;			/* path */
+{
+	struct mounts *mp, *mpb;
+
+#if	defined(HASMNTDEVIX)
+	mp = get_mntns()->lmi;
+#else	/* !defined(HASMNTDEVIX) */
+	mp = readmnt();
+#endif	/* defined(HASMNTDEVIX) */
+
+	for (mpb = (struct mounts *)NULL; mp; mp = mp->next) {
+	    if (!mp->dir || !mp->dirl || strncmp(mp->dir, p, mp->dirl))
+		continue;
+	    if ((mp->dirl > 1) && p[mp->dirl] && (p[mp->dirl] != '/'))
+		continue;
+	    if (!mpb || (mp->dirl >= mpb->dirl))
+		mpb = mp;
+	}
+	return(mpb);
+}
+
+
+/*
+ * find_nfsmnt() - find the NFS mount a file was reached through
+ */
+
+struct mounts *
+find_nfsmnt(dev, p)
+	dev_t dev;			/* file's device */
+	char *p;			/* file's path */
+{
+	struct mounts *mp;
+
+#if	defined(HASMNTDEVIX)
+	mntns_t *nsp;
+
+	if (!(nsp = get_mntns())->nfs)
+	    return((struct mounts *)NULL);
+	if ((mp = find_mnt_ns(nsp, dev, p))
+	&&  (mp->ty == N_NFS) && (mp->ds & SB_DEV))
+	    return(mp);
+#else	/* !defined(HASMNTDEVIX) */
+	if (HasNFS != 2)
+	    return((struct mounts *)NULL);
+	for (mp = readmnt(); mp; mp = mp->next) {
+	    if ((mp->ty == N_NFS) && (mp->ds & SB_DEV) && (dev == mp->dev)
+	    &&  mp->dir && mp->dirl && !strncmp(mp->dir, p, mp->dirl))
+		return(mp);
+	}
+#endif	/* defined(HASMNTDEVIX) */
+
+	return((struct mounts *)NULL);
+}
+
+
+#if	defined(HASMNTDEVIX)
+/*
+ * get_mntns() - get the mount namespace of the current process
+ *
+ * A namespace's table is read from the /proc/<pid>/mountinfo of the first
+ * process found in it, and is shared by all its processes.  lsof's own table
+ * serves when there is no current process, when the process' namespace can't
+ * be identified, and when its mountinfo can't be read.
+ *
+ * Other namespaces are looked up only when lsof's own table has an NFS mount.
+ * Without one, no lookup needs them, and looking them up would cost a stat(2)
+ * for every process and a mountinfo read for every namespace.
+ */
+
+static mntns_t *
+get_mntns()
+{
+
+#if	defined(HASMNTNS)
+	int h;
+	mntns_t *nsp;
+	char path[MAXPATHLEN];
+	struct stat sb;
+#endif	/* defined(HASMNTNS) */
+
+	(void) readmnt();
+
+#if	defined(HASMNTNS)
+	if (!Lp || !Mntselfi || !HasNFS)
+	    return(&Mntself);
+	if (Lp->mntns)
+	    return(Lp->mntns);
+	Lp->mntns = &Mntself;
+	(void) snpf(path, sizeof(path), "%s/%d/ns/mnt", PROCFS, Lp->pid);
+	if (stat(path, &sb) || ((INODETYPE)sb.st_ino == Mntself.ino))
+	    return(Lp->mntns);
+/*
+ * Look for the namespace.  Read and index its table, if it's new.
+ */
+	if (!Mntnsh) {
+	    if (!(Mntnsh = (mntns_t **)calloc(MNTNSHASH, sizeof(mntns_t *)))) {
+		(void) fprintf(stderr,
+		    "%s: no space for mount namespace hash buckets\n", Pn);
+		Exit(1);
+	    }
+	}
+	h = (int)((INODETYPE)sb.st_ino & (MNTNSHASH - 1));
+	for (nsp = Mntnsh[h]; nsp; nsp = nsp->next) {
+	    if (nsp->ino == (INODETYPE)sb.st_ino)
+		break;
+	}
+	if (!nsp) {
+	    if (!(nsp = (mntns_t *)calloc(1, sizeof(mntns_t)))) {
+		(void) fprintf(stderr,
+		    "%s: no space for mount namespace %" INODEPSPEC "u\n",
+		    Pn, (INODETYPE)sb.st_ino);
+		Exit(1);
+	    }
+	    nsp->ino = (INODETYPE)sb.st_ino;
+	    if ((nsp->lmi = read_mnt(Lp->pid)))
+		(void) index_mnt(nsp);
+	    nsp->next = Mntnsh[h];
+	    Mntnsh[h] = nsp;
+	}
+	if (nsp->lmi)
+	    Lp->mntns = nsp;
+	return(Lp->mntns);
+#else	/* !defined(HASMNTNS) */
+	return(&Mntself);
+#endif	/* defined(HASMNTNS) */
+
+}
+#endif	/* defined(HASMNTDEVIX) */
+
+
+/*
+ * get_mntinfo() - get the fields of a /proc/<pid>/mountinfo line
+ *
+ * The line's fields are: mount ID, parent ID, major:minor, root, mount
+ * point, mount options, optional fields, "-", file system type, mount
+ * source and super block options.
+ */
+
+static int
+get_mntinfo(ln, tr, fs, dir, ty, dev)
+	char *ln;			/* mountinfo line */
+	int tr;				/* line was truncated */
+	char **fs;			/* mount source return */
+	char **dir;			/* mount point return */
+	char **ty;			/* file system type return */
+	dev_t *dev;			/* device number return */
+{
+	char *ep, **fp;
+	int i, n;
+	unsigned long maj, min;
+
+	if ((n = get_fields(ln, (char *)NULL, &fp, (int *)NULL, 0)) < 9)
+	    return(0);
+/*
+ * Find the separator that ends the optional fields.  The mount source
+ * follows the file system type after it; if the line was truncated, the
+ * source is complete only when a super block options field follows it.
+ */
+	for (i = 6; i < n; i++) {
+	    if (!strcmp(fp[i], "-"))
+		break;
+	}
+	if ((i + (tr ? 3 : 2)) >= n)
+	    return(0);
+	maj = strtoul(fp[2], &ep, 10);
+	if ((ep == fp[2]) || (*ep != ':'))
+	    return(0);
+	min = strtoul(ep + 1, &ep, 10);
+	if (*ep)
+	    return(0);
+	*dev = (dev_t)makedev((int)maj, (int)min);
+	*dir = fp[4];
+	*ty = fp[i + 1];
+	*fs = fp[i + 2];
+	return(1);
+}
+
+
 #if	defined(HASMNTSUP)
 /*
  * getmntdev() - get mount device from mount supplement
@@ -410,43 +811,224 @@ hash_mnt(dn)
 #endif	/* defined(HASMNTSUP) */
 
 
+#if	defined(HASMNTDEVIX)
 /*
- * readmnt() - read mount table
+ * hash_mntdev() - hash a mount device number
  */
 
-struct mounts *
-readmnt()
+static unsigned int
+hash_mntdev(dev)
+	dev_t dev;			/* device */
 {
-	char buf[MAXPATHLEN], *cp, **fp;
+	unsigned long long h;
+
+	h = (unsigned long long)dev * 0x9e3779b97f4a7c15ULL;
+	return((unsigned int)(h ^ (h >> 32)));
+}
+#endif	/* defined(HASMNTDEVIX) */
+
+
+/*
+ * hash_mntnm() - hash a mounted directory or file system name
+ */
+
+static int
+hash_mntnm(nm)
+	char *nm;			/* name */
+{
+	unsigned int h;
+
+	for (h = 2166136261U; *nm; nm++)
+	    h = (h ^ (unsigned int)(unsigned char)*nm) * 16777619U;
+	return((int)(h & (MNTDIRHASH - 1)));
+}
+
+
+#if	defined(HASMNTDEVIX)
+/*
+ * index_mnt() - index a mount namespace's table by device and by device and
+ *		 directory
+ */
+
+static void
+index_mnt(nsp)
+	mntns_t *nsp;			/* mount namespace */
+{
+	char *cp;
+	unsigned int dh, h;
+	int i, n;
+	struct mounts *mp;
+	mntix_t *mx;
+
+	for (n = 0, mp = nsp->lmi; mp; mp = mp->next) {
+	    if (mp->ty == N_NFS)
+		nsp->nfs = 1;
+	    n++;
+	}
+	if (!n)
+	    return;
+	for (nsp->mixsz = MNTIXMIN; nsp->mixsz < n; nsp->mixsz <<= 1)
+	    ;
+	if (!(nsp->mixdev = (mntix_t **)calloc((MALLOC_S)nsp->mixsz,
+					       sizeof(mntix_t *)))
+	||  !(nsp->mixpfx = (mntix_t **)calloc((MALLOC_S)nsp->mixsz,
+					       sizeof(mntix_t *)))
+	||  !(mx = (mntix_t *)malloc((MALLOC_S)(n * sizeof(mntix_t)))))
+	{
+	    (void) fprintf(stderr, "%s: no space for %d mount index entries\n",
+		Pn, n);
+	    Exit(1);
+	}
+	nsp->mix = mx;
+/*
+ * Link the entries to the heads of their buckets from the end of the table,
+ * so that each device bucket lists them in table order.
+ */
+	for (i = n, mp = nsp->lmi; mp; mp = mp->next)
+	    mx[--i].mp = mp;
+	for (i = 0; i < n; i++) {
+	    mp = mx[i].mp;
+	    dh = hash_mntdev(mp->dev);
+	    mx[i].dnext = nsp->mixdev[dh & (nsp->mixsz - 1)];
+	    nsp->mixdev[dh & (nsp->mixsz - 1)] = &mx[i];
+	    for (h = 2166136261U, cp = mp->dir; *cp; cp++)
+		h = (h ^ (unsigned int)(unsigned char)*cp) * 16777619U;
+	    mx[i].pnext = nsp->mixpfx[(h ^ dh) & (nsp->mixsz - 1)];
+	    nsp->mixpfx[(h ^ dh) & (nsp->mixsz - 1)] = &mx[i];
+	}
+}
+
+
+/*
+ * is_mnt_pfx() - is a mounted directory a path component prefix of a path?
+ */
+
+static int
+is_mnt_pfx(mp, p)
+	struct mounts *mp;		/* mount entry */
+	char *p;			/* path */
+{
+	if (!mp->dir || !mp->dirl || strncmp(mp->dir, p, mp->dirl))
+	    return(0);
+	return((mp->dirl == 1) || !p[mp->dirl] || (p[mp->dirl] == '/'));
+}
+#endif	/* defined(HASMNTDEVIX) */
+
+
+/*
+ * is_mntinfo_dev() - is the mountinfo device number of a file system type
+ *		      the one stat() reports for its mounted directory?
+ *
+ * Btrfs and bcachefs give each subvolume its own anonymous device number,
+ * while mountinfo reports the super block's.
+ */
+
+static int
+is_mntinfo_dev(ty)
+	char *ty;			/* file system type */
+{
+	if (!strcmp(ty, "btrfs") || !strcmp(ty, "bcachefs"))
+	    return(0);
+	return(1);
+}
+
+
+/*
+ * read_mnt() - read a mount table
+ *
+ * The table is read from /proc/<pid>/mountinfo, whose lines give the device
+ * numbers of the mounts, so that the mounted directories needn't be passed
+ * to Readlink() and stat() -- which would block on a hung NFS or FUSE
+ * server.  Only when the device number is in doubt is the directory stat()'d.
+ *
+ * For lsof's own table /proc/mounts is read when there's no mountinfo, and
+ * the -e, +m and file system argument information is gathered.  The table of
+ * another mount namespace has only the mounted directories, device numbers,
+ * and file system names and types; its directories are stat()'d through the
+ * process' /proc/<pid>/root.
+ */
+
+static struct mounts *
+read_mnt(pid)
+	int pid;			/* process ID of the mount namespace
+					 * (0 = lsof's own) */
+{
+	char buf[MAXPATHLEN * 4], *cp, **fp;
+	int c, h, mi, tr;
 	char *dn = (char *)NULL;
 	size_t dnl;
 	int ds, ne;
+	dev_t mdev = (dev_t)0;
+	mnthash_t *mh, **mdh, **mfh;
 	char *fp0 = (char *)NULL;
 	char *fp1 = (char *)NULL;
+	char *fst, *mfs, *mdir;
 	int fr, ignrdl, ignstat;
 	char *ln;
 	struct mounts *mp;
 	FILE *ms;
+	struct mounts *lmi = (struct mounts *)NULL;
 	int nfs;
 	int mqueue;
+	char rpath[MAXPATHLEN];
 	struct stat sb;
+	char *sp;
 	static char *vbuf = (char *)NULL;
 	static size_t vsz = (size_t)0;
-
-	if (Lmi || Lmist)
-	    return(Lmi);
 /*
- * Open access to /proc/mounts, assigning a page size buffer to its stream.
+ * Open access to /proc/<pid>/mountinfo or /proc/mounts, assigning a page size
+ * buffer to its stream.
  */
-	(void) snpf(buf, sizeof(buf), "%s/mounts", PROCFS);
-	ms = open_proc_stream(buf, "r", &vbuf, &vsz, 1);
+	if (pid) {
+	    (void) snpf(buf, sizeof(buf), "%s/%d/mountinfo", PROCFS, pid);
+	    if (!(ms = open_proc_stream(buf, "r", &vbuf, &vsz, 0)))
+		return((struct mounts *)NULL);
+	    mi = 1;
+	} else {
+	    (void) snpf(buf, sizeof(buf), "%s/self/mountinfo", PROCFS);
+	    if ((ms = open_proc_stream(buf, "r", &vbuf, &vsz, 0)))
+		mi = 1;
+	    else {
+		(void) snpf(buf, sizeof(buf), "%s/mounts", PROCFS);
+		ms = open_proc_stream(buf, "r", &vbuf, &vsz, 1);
+		mi = 0;
+	    }
+	}
+/*
+ * Allocate hash buckets for finding duplicate mounted directories and
+ * mounts of file systems whose names have been resolved.
+ */
+	if (!(mdh = (mnthash_t **)calloc(MNTDIRHASH, sizeof(mnthash_t *)))
+	||  !(mfh = (mnthash_t **)calloc(MNTDIRHASH, sizeof(mnthash_t *))))
+	{
+	    (void) fprintf(stderr, "%s: no space for mount hash buckets\n",
+		Pn);
+	    Exit(1);
+	}
 /*
  * Read mount table entries.
  */
 	while (fgets(buf, sizeof(buf), ms)) {
-	    if (get_fields(buf, (char *)NULL, &fp, (int *)NULL, 0) < 3
-	    ||  !fp[0] || !fp[1] || !fp[2])
-		continue;
+
+	/*
+	 * Skip the rest of a line that is too long for the buffer.  (Long
+	 * mountinfo lines usually end with long super block options.)
+	 */
+	    if ((tr = !strchr(buf, '\n'))) {
+		while (((c = getc(ms)) != EOF) && (c != '\n'))
+		    ;
+	    }
+	    if (mi) {
+		if (!get_mntinfo(buf, tr, &mfs, &mdir, &fst, &mdev))
+		    continue;
+	    } else {
+		if (get_fields(buf, (char *)NULL, &fp, (int *)NULL, 0) < 3
+		||  !fp[0] || !fp[1] || !fp[2])
+		    continue;
+		mfs = fp[0];
+		mdir = fp[1];
+		fst = fp[2];
+	    }
 	/*
 	 * Convert octal-escaped characters in the device name and mounted-on
 	 * path name.
@@ -459,7 +1041,7 @@ readmnt()
 		(void) free((FREE_P *)fp1);
 		fp1 = (char *)NULL;
 	    }
-	    if (!(fp0 = cvtoe(fp[0])) || !(fp1 = cvtoe(fp[1])))
+	    if (!(fp0 = cvtoe(mfs)) || !(fp1 = cvtoe(mdir)))
 		continue;
 	/*
 	 * Locate any colon (':') in the device name.
@@ -472,8 +1054,8 @@ readmnt()
 	    cp = strchr(fp0, ':');
 	    if (cp && !strncasecmp(++cp, "(pid", 4))
 		continue;
-	    if (!strcasecmp(fp[2], "autofs") || !strcasecmp(fp[2], "pipefs")
-	    ||  !strcasecmp(fp[2], "sockfs"))
+	    if (!strcasecmp(fst, "autofs") || !strcasecmp(fst, "pipefs")
+	    ||  !strcasecmp(fst, "sockfs"))
 		continue;
 	/*
 	 * Interpolate a possible symbolic mounted directory link.
@@ -484,7 +1066,7 @@ readmnt()
 	    fp1 = (char *)NULL;
 
 #if	defined(HASEOPT)
-	if (Efsysl) {
+	if (Efsysl && !pid) {
 
 	/*
 	 * If there is an -e file system list, check it to decide if a stat()
@@ -506,9 +1088,10 @@ readmnt()
 	    ignrdl = ignstat = 0;
 
 	/*
-	 * Avoid Readlink() when requested.
+	 * Avoid Readlink() when requested, and for a mountinfo directory,
+	 * which the kernel has already resolved.
 	 */
-	    if (!ignrdl) {
+	    if (!ignrdl && !mi) {
 		if (!(ln = Readlink(dn))) {
 		    if (!Fwarn) {
 			(void) fprintf(stderr,
@@ -528,18 +1111,21 @@ readmnt()
 	/*
 	 * Test Mqueue directory
 	 */
-	    mqueue = strcmp(fp[2], "mqueue");
+	    mqueue = strcmp(fst, "mqueue");
 
 	/*
 	 * Test for duplicate and NFS directories.
 	 */
-	    for (mp = Lmi; mp; mp = mp->next) {
-		if ((dnl == mp->dirl) && !strcmp(dn, mp->dir))
+	    h = hash_mntnm(dn);
+	    for (mh = mdh[h], mp = (struct mounts *)NULL; mh; mh = mh->next) {
+		if ((dnl == mh->mp->dirl) && !strcmp(dn, mh->mp->dir)) {
+		    mp = mh->mp;
 		    break;
+		}
 	    }
-	    if ((nfs = strcasecmp(fp[2], "nfs"))) {
-		if ((nfs = strcasecmp(fp[2], "nfs3")))
-		    nfs = strcasecmp(fp[2], "nfs4");
+	    if ((nfs = strcasecmp(fst, "nfs"))) {
+		if ((nfs = strcasecmp(fst, "nfs3")))
+		    nfs = strcasecmp(fst, "nfs4");
 	    }
 	    if (!nfs && !HasNFS)
 		HasNFS = 1;
@@ -549,25 +1135,43 @@ readmnt()
 	     * If this duplicate directory is not root, ignore it.  If the
 	     * already remembered entry is NFS-mounted, ignore this one.  If
 	     * this one is NFS-mounted, ignore the already remembered entry.
+	     *
+	     * A later mountinfo entry covers the earlier one, so its device
+	     * number is the one stat() would have reported for the directory.
 	     */
-		if (strcmp(dn, "/"))
+		if (strcmp(dn, "/")) {
+		    if (mi && (mp->ds == SB_DEV) && is_mntinfo_dev(fst))
+			mp->dev = mdev;
 		    continue;
+		}
 		if (mp->ty == N_NFS)
 		    continue;
 		if (nfs)
 		    continue;
 	    }
 	/*
-	 * Stat() the directory.
+	 * Take the device number from mountinfo when it can be trusted, or
+	 * stat() the directory.
 	 */
-	    if (ignstat)
+	    if (mi && is_mntinfo_dev(fst)) {
+		zeromem((char *)&sb, sizeof(sb));
+		sb.st_dev = mdev;
+		ds = SB_DEV;
+		fr = 0;
+	    } else if (ignstat)
 		fr = 1;
 	    else {
-		if ((fr = statsafely(dn, &sb))) {
+		if (pid) {
+		    (void) snpf(rpath, sizeof(rpath), "%s/%d/root%s",
+			PROCFS, pid, dn);
+		    sp = rpath;
+		} else
+		    sp = dn;
+		if ((fr = statsafely(sp, &sb))) {
 		    if (!Fwarn) {
 			(void) fprintf(stderr, "%s: WARNING: can't stat() ",
 			    Pn);
-			safestrprt(fp[2], stderr, 0);
+			safestrprt(fst, stderr, 0);
 			(void) fprintf(stderr, " file system ");
 			safestrprt(dn, stderr, 1);
 			(void) fprintf(stderr,
@@ -584,7 +1188,7 @@ readmnt()
 	     * If the stat() failed or wasn't called, check the mount
 	     * supplement table, if possible.
 	     */
-		if ((MntSup == 2) && MntSupP) {
+		if ((MntSup == 2) && MntSupP && !pid) {
 		    ds = 0;
 		    if (getmntdev(dn, dnl, &sb, &ds) || !(ds & SB_DEV)) {
 			(void) fprintf(stderr,
@@ -621,18 +1225,23 @@ readmnt()
 		}
 	    } else {
 		ne = 1;
-		if (!(mp = (struct mounts *)malloc(sizeof(struct mounts)))) {
+		if (!(mp = (struct mounts *)malloc(sizeof(struct mounts)))
+		||  !(mh = (mnthash_t *)malloc(sizeof(mnthash_t))))
+		{
 		    (void) fprintf(stderr,
 			"%s: can't allocate mounts struct for: ", Pn);
 		    safestrprt(dn, stderr, 1);
 		    Exit(1);
 	        }
+		mh->mp = mp;
+		mh->next = mdh[h];
+		mdh[h] = mh;
 	    }
 	    mp->dir = dn;
 	    dn = (char *)NULL;
 	    mp->dirl = dnl;
 	    if (ne)
-		mp->next = Lmi;
+		mp->next = lmi;
 	    mp->dev = ((mp->ds = ds) & SB_DEV) ? sb.st_dev : 0;
 	    mp->rdev = (ds & SB_RDEV) ? sb.st_rdev : 0;
 	    mp->inode = (INODETYPE)((ds & SB_INO) ? sb.st_ino : 0);
@@ -643,24 +1252,12 @@ readmnt()
 		    HasNFS = 2;
 	    } else if (!mqueue) {
 		mp->ty = N_MQUEUE;
-		MqueueDev = mp->dev;
+		if (!pid)
+		    MqueueDev = mp->dev;
 	    } else {
 		mp->ty = N_REGLR;
 	    }
 
-#if	defined(HASMNTSUP)
-	/*
-	 * If support for the mount supplement file is defined and if the
-	 * +m option was supplied, print mount supplement information.
-	 */
-	    if (MntSup == 1) {
-		if (mp->dev)
-		    (void) printf("%s %#lx\n", mp->dir, (long)mp->dev);
-		else
-		    (void) printf("%s 0x0\n", mp->dir);
-	    }
-#endif	/* defined(HASMNTSUP) */
-
 	/*
 	 * Save mounted-on device or directory name.
 	 */
@@ -672,8 +1269,17 @@ readmnt()
 	 * directory name link.
 	 *
 	 * Avoid Readlink() when requested.
+	 *
+	 * Many mounts -- e.g., bind mounts -- have the same file system name;
+	 * reuse the resolution of an earlier one.
+	 *
+	 * Only lsof's own file system names are resolved, for matching to file
+	 * arguments.
 	 */
-	    if (ignrdl || (*dn != '/')) {
+	    if (pid) {
+		ln = (char *)NULL;
+		ignstat = 1;
+	    } else if (ignrdl || (*dn != '/')) {
 		if (!(ln = mkstrcpy(dn, (MALLOC_S *)NULL))) {
 		    (void) fprintf(stderr,
 			"%s: can't allocate space for: ", Pn);
@@ -681,6 +1287,21 @@ readmnt()
 		    Exit(1);
 		}
 		ignstat = 1;
+	    } else if (!ignstat) {
+		h = hash_mntnm(dn);
+		for (mh = mfh[h]; mh; mh = mh->next) {
+		    if (!strcmp(dn, mh->mp->fsname))
+			break;
+		}
+		if (mh) {
+		    mp->fsnmres = mh->mp->fsnmres;
+		    mp->fs_mode = mh->mp->fs_mode;
+		    dn = (char *)NULL;
+		    if (ne)
+			lmi = mp;
+		    continue;
+		}
+		ln = Readlink(dn);
 	    } else
 		ln = Readlink(dn);
 	    dn = (char *)NULL;
@@ -692,19 +1313,113 @@ readmnt()
 		sb.st_mode = 0;
 	    mp->fsnmres = ln;
 	    mp->fs_mode = sb.st_mode;
+	    if (!ignstat) {
+		if (!(mh = (mnthash_t *)malloc(sizeof(mnthash_t)))) {
+		    (void) fprintf(stderr,
+			"%s: can't allocate mount hash entry for: ", Pn);
+		    safestrprt(mp->fsname, stderr, 1);
+		    Exit(1);
+		}
+		mh->mp = mp;
+		mh->next = mfh[h];
+		mfh[h] = mh;
+	    }
 	    if (ne)
-		Lmi = mp;
+		lmi = mp;
 	}
 /*
  * Clean up and return the local mount info table address.
  */
 	(void) fclose(ms);
+	for (h = 0; h < MNTDIRHASH; h++) {
+	    for (mh = mdh[h]; mh; mh = mdh[h]) {
+		mdh[h] = mh->next;
+		(void) free((FREE_P *)mh);
+	    }
+	    for (mh = mfh[h]; mh; mh = mfh[h]) {
+		mfh[h] = mh->next;
+		(void) free((FREE_P *)mh);
+	    }
+	}
+	(void) free((FREE_P *)mdh);
+	(void) free((FREE_P *)mfh);
+
+#if	defined(HASMNTSUP)
+/*
+ * If support for the mount supplement file is defined and if the +m option
+ * was supplied, print mount supplement information in mount table order,
+ * now that later mounts on the same directories have been seen.
+ */
+	if ((MntSup == 1) && !pid) {
+	    struct mounts **ma = (struct mounts **)NULL;
+	    int n;
+
+	    for (n = 0, mp = lmi; mp; mp = mp->next)
+		n++;
+	    if (n
+	    &&  !(ma = (struct mounts **)malloc((MALLOC_S)(n * sizeof(struct mounts *)))))
+	    {
+		(void) fprintf(stderr,
+		    "%s: no space for %d mount supplement pointers\n",
+		    Pn, n);
+		Exit(1);
+	    }
+	    for (c = n, mp = lmi; mp; mp = mp->next)
+		ma[--c] = mp;
+	    for (c = 0; c < n; c++) {
+		if (ma[c]->dev)
+		    (void) printf("%s %#lx\n", ma[c]->dir, (long)ma[c]->dev);
+		else
+		    (void) printf("%s 0x0\n", ma[c]->dir);
+	    }
+	    if (n)
+		(void) free((FREE_P *)ma);
+	}
+#endif	/* defined(HASMNTSUP) */
+
 	if (dn)
 	    (void) free((FREE_P *)dn);
 	if (fp0)
 	    (void) free((FREE_P *)fp0);
 	if (fp1)
 	    (void) free((FREE_P *)fp1);
+	return(lmi);
+}
+
+
+/*
+ * readmnt() - read lsof's mount table
+ */
+
+struct mounts *
+readmnt()
+{
+
+#if	defined(HASMNTNS)
+	char path[MAXPATHLEN];
+	struct stat sb;
+#endif	/* defined(HASMNTNS) */
+
+	if (Lmi || Lmist)
+	    return(Lmi);
+	Lmi = read_mnt(0);
 	Lmist = 1;
+
+#if	defined(HASMNTDEVIX)
+	Mntself.lmi = Lmi;
+	(void) index_mnt(&Mntself);
+#endif	/* defined(HASMNTDEVIX) */
+
+#if	defined(HASMNTNS)
+/*
+ * Identify lsof's own mount namespace, so that processes in it use Lmi.
+ */
+	(void) snpf(path, sizeof(path), "%s/self/ns/mnt", PROCFS);
+	if (!stat(path, &sb)) {
+	    Mntself.ino = (INODETYPE)sb.st_ino;
+	    Mntselfi = 1;
+	}
+#endif	/* defined(HASMNTNS) */
+
 	return(Lmi);
 }
@@ -49,18 +49,43 @@ static char copyright[] =
 #define	OFFSET_MAX	((off_t)0x7fffffff)	/* this is defined in
 						 * .../src/fs/locks.c and not
 						 * in a header file */
-#define	PIDBUCKS	64			/* PID hash buckets */
-#define	PINFOBUCKS	512			/* pipe info hash buckets */
-#define	HASHPID(pid)	(((int)((pid * 31415) >> 3)) & (PIDBUCKS - 1))
-#define	HASHPINFO(ino)	(((int)((ino * 31415) >> 3)) & (PINFOBUCKS - 1))
+#define	LCKHLOAD	4			/* average lock hash chain
+						 * length */
+#define	LCKHMIN		64			/* minimum lock hash bucket
+						 * count (power of 2!) */
+
+#if	defined(HASEPTOPTS)
+#define	EPTHLOAD	4			/* average endpoint hash chain
+						 * length */
+#define	EPTHMIN		64			/* minimum endpoint hash bucket
+						 * count (power of 2!) */
+#endif	/* defined(HASEPTOPTS) */
 
 
 /*
  * Local structure definitions
  */
 
+#if	defined(HASEPTOPTS)
+typedef struct eptgrp {			/* files sharing an endpoint ID */
+	INODETYPE id;			/* endpoint ID */
+	pxinfo_t *head;			/* first member */
+	pxinfo_t *tail;			/* last member */
+	pxinfo_t *pfirst;		/* first member entered by the last
+					 * PID to enter one */
+	struct eptgrp *next;		/* next group of the hash bucket */
+} eptgrp_t;
+
+typedef struct epthash {		/* endpoint ID hash */
+	eptgrp_t **b;			/* buckets */
+	int sz;				/* bucket count */
+	int n;				/* group count */
+	char *nm;			/* name, for error messages */
+} epthash_t;
+#endif	/* defined(HASEPTOPTS) */
+
 struct llock {
-	int pid;
+	int pid;			/* owning PID; -1 for an OFD lock */
 	dev_t dev;
 	INODETYPE inode;
 	char type;
@@ -72,16 +97,31 @@ struct llock {
  * Local definitions
  */
 
-struct llock **LckH = (struct llock **)NULL; /* PID-hashed locks */
+static struct llock **LckH = (struct llock **)NULL;
+					/* locks hashed by (PID, device,
+					 * inode) */
+static int LckHn = 0;			/* LckH[] lock count */
+static int LckHsz = 0;			/* LckH[] bucket count */
+static int LckLd = 0;			/* LckH[] has been loaded from
+					 * LckPath */
+static int LckOFD = 0;			/* LckH[] has OFD locks */
+static char *LckPath = (char *)NULL;	/* /proc lock path */
 
 
 /*
  * Local function prototypes
  */
 
-_PROTOTYPE(static void check_lock,(void));
+_PROTOTYPE(static struct llock *find_lock,(int pid, dev_t dev, INODETYPE inode));
+_PROTOTYPE(static int hash_lock,(int pid, dev_t dev, INODETYPE inode, int mod));
+_PROTOTYPE(static void load_locks,(void));
+_PROTOTYPE(static int parse_lock,(char *ln, int *pid, dev_t *dev, INODETYPE *inode, char *type));
 
 #if	defined(HASEPTOPTS)
+_PROTOTYPE(static void endpoint_clear,(epthash_t *eh));
+_PROTOTYPE(static void endpoint_enter,(epthash_t *eh, INODETYPE id));
+_PROTOTYPE(static pxinfo_t *endpoint_find,(epthash_t *eh, int (*is_acceptable)(pxinfo_t *, int, struct lfile *), int pid, struct lfile *lf, INODETYPE id, pxinfo_t *pp));
+_PROTOTYPE(static int hash_ept,(INODETYPE id, int mod));
 _PROTOTYPE(static void enter_pinfo,(void));
 #endif	/* defined(HASEPTOPTS) */
 
@@ -91,13 +131,19 @@ _PROTOTYPE(static void enter_pinfo,(void));
  */
 
 #if	defined(HASEPTOPTS)
-static pxinfo_t **Pinfo = (pxinfo_t **)NULL;	/* pipe endpoint hash buckets */
+static epthash_t Pinfo = { NULL, 0, 0, "pipe" };
+						/* pipe endpoints, by inode */
 # if	defined(HASPTYEPT)
-static pxinfo_t **PtyInfo = (pxinfo_t **)NULL;	/* pseudoterminal endpoint hash
-						 * buckets */
+static epthash_t PtyInfo = { NULL, 0, 0, "pty" };
+						/* pseudoterminal endpoints, by
+						 * minor device number */
 # endif	/* defined(HASPTYEPT) */
-static pxinfo_t **PSXMQinfo = (pxinfo_t **)NULL;/* posix msg queue endpoint hash buckets */
-static pxinfo_t **EvtFDinfo = (pxinfo_t **)NULL;/* envetfd endpoint hash buckets */
+static epthash_t PSXMQinfo = { NULL, 0, 0, "posix mq" };
+						/* posix msg queue endpoints,
+						 * by inode */
+static epthash_t EvtFDinfo = { NULL, 0, 0, "eventfd" };
+						/* eventfd endpoints, by
+						 * eventfd ID */
 #endif	/* defined(HASEPTOPTS) */
 
 
@@ -105,113 +151,241 @@ static pxinfo_t **EvtFDinfo = (pxinfo_t **)NULL;/* envetfd endpoint hash buckets
  * check_lock() - check lock for file *Lf, process *Lp
  */
 
-static void
+void
 check_lock()
 {
-	int h;
 	struct llock *lp;
 
-	h = HASHPID(Lp->pid);
-	for (lp = LckH[h]; lp; lp = lp->next) {
-	    if (Lp->pid == lp->pid
-	    &&  Lf->dev == lp->dev
-	    &&  Lf->inode == lp->inode)
-	    {
-		Lf->lock = lp->type;
-		return;
+	if (!LckLd)
+	    (void) load_locks();
+	if ((lp = find_lock(Lp->pid, Lf->dev, Lf->inode)))
+	    Lf->lock = lp->type;
+}
+
+
+/*
+ * check_ofd_lock() - check for an OFD lock on file descriptor fd of file *Lf,
+ *		      process *Lp
+ *
+ * /proc/locks gives no PID for an open file description (OFD) lock.  When one
+ * is held on the file's device and inode, the "lock:" lines of the
+ * descriptor's fdinfo file tell if it is held through this descriptor.
+ */
+
+void
+check_ofd_lock(fd)
+	int fd;				/* file descriptor number */
+{
+	char buf[MAXPATHLEN + 1];
+	dev_t dev;
+	FILE *fs;
+	INODETYPE inode;
+	int pid;
+	char type;
+
+	if (!LckOFD || (Lf->lock != ' ') || !Lf->sf || (Lf->sf & SELEXCLF)
+	||  !Lf->dev_def || (Lf->inp_ty != 1)
+	||  !find_lock(-1, Lf->dev, Lf->inode))
+	    return;
+	(void) snpf(buf, sizeof(buf), "%s/%d/fdinfo/%d", PROCFS, Lp->pid, fd);
+	if (!(fs = fopen(buf, "r")))
+	    return;
+	while (fgets(buf, sizeof(buf), fs)) {
+	    if (strncmp(buf, "lock:", 5)
+	    ||  !parse_lock(&buf[5], &pid, &dev, &inode, &type))
+		continue;
+	    if ((pid == -1) && (dev == Lf->dev) && (inode == Lf->inode)) {
+		Lf->lock = type;
+		break;
 	    }
 	}
+	(void) fclose(fs);
+}
+
+
+/*
+ * find_lock() - find a lock by PID, device and inode
+ */
+
+static struct llock *
+find_lock(pid, dev, inode)
+	int pid;			/* PID; -1 for an OFD lock */
+	dev_t dev;			/* device */
+	INODETYPE inode;		/* inode number */
+{
+	struct llock *lp;
+
+	if (!LckHn)
+	    return((struct llock *)NULL);
+	for (lp = LckH[hash_lock(pid, dev, inode, LckHsz)]; lp; lp = lp->next)
+	{
+	    if ((lp->pid == pid) && (lp->dev == dev) && (lp->inode == inode))
+		return(lp);
+	}
+	return((struct llock *)NULL);
 }
 
 
 #if	defined(HASEPTOPTS)
+/*
+ * endpoint_clear() -- clear an endpoint hash
+ */
+
 static void
-endpoint_pxinfo_hash(pxinfo_t **pinfo_hash, const size_t nbuckets,
-		     void (* free_elt) (void *))
+endpoint_clear(eh)
+	epthash_t *eh;			/* endpoint hash */
 {
+	eptgrp_t *gp, *gn;		/* group pointers */
 	int h;				/* hash index */
-	pxinfo_t *pi, *pp;		/* temporary pointers */
+	pxinfo_t *pi, *pn;		/* member pointers */
 
-	if (!pinfo_hash)
+	if (!eh->n)
 	    return;
-	for (h = 0; h < nbuckets; h++) {
-	    if ((pi = pinfo_hash[h])) {
-		do {
-		    pp = pi->next;
-		    (void) (* free_elt)
-		    ((FREE_P *)pi);
-		    pi = pp;
-		} while (pi);
-		pinfo_hash[h] = (pxinfo_t *)NULL;
+	for (h = 0; h < eh->sz; h++) {
+	    for (gp = eh->b[h]; gp; gp = gn) {
+		gn = gp->next;
+		for (pi = gp->head; pi; pi = pn) {
+		    pn = pi->next;
+		    (void) free((FREE_P *)pi);
+		}
+		(void) free((FREE_P *)gp);
 	    }
+	    eh->b[h] = (eptgrp_t *)NULL;
 	}
+	eh->n = 0;
 }
 
+
+/*
+ * endpoint_enter() -- enter file *Lf of process *Lp in an endpoint hash
+ *
+ * The files that share an endpoint ID form a group, found by hashing the ID,
+ * and are kept in the order they were entered.  The files of a process and
+ * of its tasks are entered together, so a duplicate can only be among the
+ * members the current PID has entered.  (With -K each task has its own
+ * Lproc[] entry, but shares the process' file descriptors.)
+ */
+
 static void
-endpoint_enter(pxinfo_t **pinfo_hash, const char *table_name, int id)
+endpoint_enter(eh, id)
+	epthash_t *eh;			/* endpoint hash */
+	INODETYPE id;			/* endpoint ID */
 {
-	int h;
-	struct lfile *lf;		/* local file structure pointer */
-	struct lproc *lp;		/* local proc structure pointer */
-	pxinfo_t *np, *pi, *pe;		/* inode hash pointers */
-
-    /*
-     * Make sure this is a unique entry.
-     */
-	for (h = HASHPINFO(id), pi = pinfo_hash[h], pe = (pxinfo_t *)NULL;
-	     pi;
-	     pe = pi, pi = pi->next
-	    ) {
-	    lf = pi->lf;
-	    lp = &Lproc[pi->lpx];
-	    if (pi->ino == id) {
-		if ((lp->pid == Lp->pid) && !strcmp(lf->fd, Lf->fd))
+	eptgrp_t *gp, **nb, *gn;	/* group pointers */
+	int h, i, n;			/* hash indexes and count */
+	int lpx = (int)(Lp - Lproc);	/* Lproc[] index of Lp */
+	pxinfo_t *np, *pi;		/* member pointers */
+/*
+ * Allocate the first buckets, or double them when the average chain has
+ * grown to EPTHLOAD groups.
+ */
+	if (!eh->b || ((eh->n >= eh->sz * EPTHLOAD) && (eh->sz < (INT_MAX / 2))))
+	{
+	    n = eh->b ? (eh->sz << 1) : EPTHMIN;
+	    if (!(nb = (eptgrp_t **)calloc((MALLOC_S)n, sizeof(eptgrp_t *)))) {
+		(void) fprintf(stderr,
+		    "%s: no space for %d %s info buckets\n", Pn, n, eh->nm);
+		Exit(1);
+	    }
+	    for (i = 0; eh->b && (i < eh->sz); i++) {
+		for (gp = eh->b[i]; gp; gp = gn) {
+		    gn = gp->next;
+		    h = hash_ept(gp->id, n);
+		    gp->next = nb[h];
+		    nb[h] = gp;
+		}
+	    }
+	    if (eh->b)
+		(void) free((FREE_P *)eh->b);
+	    eh->b = nb;
+	    eh->sz = n;
+	}
+/*
+ * Find the ID's group, and make sure this is a unique entry.
+ */
+	h = hash_ept(id, eh->sz);
+	for (gp = eh->b[h]; gp; gp = gp->next) {
+	    if (gp->id == id)
+		break;
+	}
+	if (gp && gp->pfirst && (Lproc[gp->pfirst->lpx].pid == Lp->pid)) {
+	    for (pi = gp->pfirst; pi; pi = pi->next) {
+		if ((Lproc[pi->lpx].pid == Lp->pid) && !strcmp(pi->lf->fd, Lf->fd))
 		    return;
 	    }
 	}
-   /*
-    * Allocate, fill and link a new pipe info structure used for pty
-    * to the end of the pty device hash chain.
-    */
+	if (!gp) {
+	    if (!(gp = (eptgrp_t *)malloc(sizeof(eptgrp_t)))) {
+		(void) fprintf(stderr,
+		    "%s: no space for %s info group for %s, PID %d, FD %s\n",
+		    Pn, eh->nm, Lp->cmd, Lp->pid, Lf->fd);
+		Exit(1);
+	    }
+	    gp->id = id;
+	    gp->head = gp->tail = gp->pfirst = (pxinfo_t *)NULL;
+	    gp->next = eh->b[h];
+	    eh->b[h] = gp;
+	    eh->n++;
+	}
+/*
+ * Allocate, fill and append a new member.
+ */
 	if (!(np = (pxinfo_t *)malloc(sizeof(pxinfo_t)))) {
 	    (void) fprintf(stderr,
-		"%s: no space for pipeinfo for %s, PID %d, FD %s\n",
-		table_name,
-		Pn, Lp->pid, Lf->fd);
+		"%s: no space for %s info for %s, PID %d, FD %s\n",
+		Pn, eh->nm, Lp->cmd, Lp->pid, Lf->fd);
 	    Exit(1);
 	}
 	np->ino = id;
 	np->lf = Lf;
-	np->lpx = Lp - Lproc;
+	np->lpx = lpx;
 	np->next = (pxinfo_t *)NULL;
-	if (pe)
-	    pe->next = np;
+	if (gp->tail)
+	    gp->tail->next = np;
 	else
-	    pinfo_hash[h] = np;
+	    gp->head = np;
+	gp->tail = np;
+	if (!gp->pfirst || (Lproc[gp->pfirst->lpx].pid != Lp->pid))
+	    gp->pfirst = np;
 }
 
+
+/*
+ * endpoint_find() -- find the next acceptable member of an endpoint group
+ */
+
 static pxinfo_t *
-endpoint_find(pxinfo_t **pinfo_hash,
-	      int (* is_acceptable) (pxinfo_t *, int, struct lfile *),
-	      int pid, struct lfile *lf, int id, pxinfo_t *pp)
+endpoint_find(eh, is_acceptable, pid, lf, id, pp)
+	epthash_t *eh;			/* endpoint hash */
+	int (*is_acceptable)(pxinfo_t *, int, struct lfile *);
+					/* member acceptance function */
+	int pid;			/* PID of the process owning lf */
+	struct lfile *lf;		/* file whose endpoints are sought */
+	INODETYPE id;			/* endpoint ID */
+	pxinfo_t *pp;			/* member to start from (NULL == the
+					 * group's first) */
 {
-	int h;				/* hash result */
-	pxinfo_t *pi;			/* pipe info pointer */
-
-	if (pinfo_hash) {
-	    if (pp)
-		pi = pp;
-	    else {
-		h = HASHPINFO(id);
-		pi = pinfo_hash[h];
-	    }
-	    while (pi) {
-		if (pi->ino == id && is_acceptable(pi, pid, lf))
-		    return (pi);
-		pi = pi->next;
+	eptgrp_t *gp;			/* group pointer */
+	pxinfo_t *pi;			/* member pointer */
+
+	if (pp)
+	    pi = pp;
+	else {
+	    if (!eh->n)
+		return((pxinfo_t *)NULL);
+	    for (gp = eh->b[hash_ept(id, eh->sz)]; gp; gp = gp->next) {
+		if (gp->id == id)
+		    break;
 	    }
+	    if (!gp)
+		return((pxinfo_t *)NULL);
+	    pi = gp->head;
+	}
+	for (; pi; pi = pi->next) {
+	    if (is_acceptable(pi, pid, lf))
+		return(pi);
 	}
-	return ((pxinfo_t *)NULL);
+	return((pxinfo_t *)NULL);
 }
 
 
@@ -236,7 +410,7 @@ endpoint_accept_other_than_self(pxinfo_t *pi, int pid, struct lfile *lf)
 void
 clear_pinfo()
 {
-	endpoint_pxinfo_hash(Pinfo, PINFOBUCKS, free);
+	endpoint_clear(&Pinfo);
 }
 
 
@@ -250,18 +424,7 @@ clear_pinfo()
 static void
 enter_pinfo()
 {
-	if (!Pinfo) {
-	/*
-	 * Allocate pipe info hash buckets.
-	 */
-	    if (!(Pinfo = (pxinfo_t **)calloc(PINFOBUCKS, sizeof(pxinfo_t *))))
-	    {
-		(void) fprintf(stderr,
-		    "%s: no space for %d pipe info buckets\n", Pn, PINFOBUCKS);
-		    Exit(1);
-	    }
-	}
-	endpoint_enter(Pinfo, "pipeinfo", Lf->inode);
+	endpoint_enter(&Pinfo, Lf->inode);
 }
 
 
@@ -275,7 +438,7 @@ find_pepti(pid, lf, pp)
 	struct lfile *lf;		/* pipe's lfile */
 	pxinfo_t *pp;			/* previous pipe info (NULL == none) */
 {
-	return endpoint_find(Pinfo,
+	return endpoint_find(&Pinfo,
 			     endpoint_accept_other_than_self,
 			     pid, lf, lf->inode, pp);
 }
@@ -290,7 +453,7 @@ find_pepti(pid, lf, pp)
 void
 clear_ptyinfo()
 {
-	endpoint_pxinfo_hash(PtyInfo, PINFOBUCKS, free);
+	endpoint_clear(&PtyInfo);
 }
 
 
@@ -305,19 +468,7 @@ void
 enter_ptmxi(mn)
 	int mn;				/* minor number of device */
 {
-	/*
-	 * Allocate pipe info hash buckets (but used for pty).
-	 */
-	if (!PtyInfo) {
-	    if (!(PtyInfo = (pxinfo_t **)calloc(PINFOBUCKS,
-			    sizeof(pxinfo_t *))))
-	    {
-		(void) fprintf(stderr,
-		    "%s: no space for %d pty info buckets\n", Pn, PINFOBUCKS);
-		    Exit(1);
-	    }
-	}
-	endpoint_enter(PtyInfo, "pty", mn);
+	endpoint_enter(&PtyInfo, (INODETYPE)mn);
 }
 
 /*
@@ -356,9 +507,11 @@ find_ptyepti(pid, lf, m, pp)
 	pxinfo_t *pp;			/* previous pseudoterminal info
 					 * (NULL == none) */
 {
-	return endpoint_find(PtyInfo,
+	return endpoint_find(&PtyInfo,
 			     m ? ptyepti_accept_ptmx : ptyepti_accept_slave,
-			     pid, lf, m ? GET_MIN_DEV(lf->rdev) : lf->tty_index, pp);
+			     pid, lf,
+			     m ? GET_MIN_DEV(lf->rdev) : LFCOLD(lf)->tty_index,
+			     pp);
 }
 
 
@@ -414,7 +567,7 @@ is_pty_ptmx(dev)
 void
 clear_psxmqinfo()
 {
-	endpoint_pxinfo_hash(PSXMQinfo, PINFOBUCKS, free);
+	endpoint_clear(&PSXMQinfo);
 }
 
 
@@ -428,18 +581,7 @@ clear_psxmqinfo()
 void
 enter_psxmqinfo()
 {
-	if (!PSXMQinfo) {
-	/*
-	 * Allocate posix mq info hash buckets.
-	 */
-	    if (!(PSXMQinfo = (pxinfo_t **)calloc(PINFOBUCKS, sizeof(pxinfo_t *))))
-	    {
-		(void) fprintf(stderr,
-		    "%s: no space for %d posix mq info buckets\n", Pn, PINFOBUCKS);
-		    Exit(1);
-	    }
-	}
-	endpoint_enter(PSXMQinfo, "psxmqinfo", Lf->inode);
+	endpoint_enter(&PSXMQinfo, Lf->inode);
 }
 
 
@@ -453,7 +595,7 @@ find_psxmqinfo(pid, lf, pp)
 	struct lfile *lf;		/* posix mq's lfile */
 	pxinfo_t *pp;			/* previous posix mq info (NULL == none) */
 {
-	return endpoint_find(PSXMQinfo,
+	return endpoint_find(&PSXMQinfo,
 			     endpoint_accept_other_than_self,
 			     pid, lf, lf->inode, pp);
 }
@@ -465,7 +607,7 @@ find_psxmqinfo(pid, lf, pp)
 void
 clear_evtfdinfo()
 {
-	endpoint_pxinfo_hash(EvtFDinfo, PINFOBUCKS, free);
+	endpoint_clear(&EvtFDinfo);
 }
 
 
@@ -479,18 +621,7 @@ clear_evtfdinfo()
 void
 enter_evtfdinfo(int id)
 {
-	if (!EvtFDinfo) {
-	/*
-	 * Allocate eventfd info hash buckets.
-	 */
-	    if (!(EvtFDinfo = (pxinfo_t **)calloc(PINFOBUCKS, sizeof(pxinfo_t *))))
-	    {
-		(void) fprintf(stderr,
-		    "%s: no space for %d envet fd info buckets\n", Pn, PINFOBUCKS);
-		    Exit(1);
-	    }
-	}
-	endpoint_enter(EvtFDinfo, "evtfdinfo", id);
+	endpoint_enter(&EvtFDinfo, (INODETYPE)id);
 }
 
 
@@ -504,9 +635,9 @@ find_evtfdinfo(pid, lf, pp)
 	struct lfile *lf;		/* eventfd's lfile */
 	pxinfo_t *pp;			/* previous eventfd info (NULL == none) */
 {
-	void *r = endpoint_find(EvtFDinfo,
+	void *r = endpoint_find(&EvtFDinfo,
 			     endpoint_accept_other_than_self,
-			     pid, lf, lf->eventfd_id, pp);
+			     pid, lf, LFCOLD(lf)->eventfd_id, pp);
 	return r;
 }
 #endif	/* defined(HASEPTOPTS) */
@@ -617,123 +748,129 @@ get_fields(ln, sep, fr, eb, en)
 
 
 /*
- * get_locks() - get lock information from /proc/locks
+ * get_locks() - discard the lock information and note the /proc lock path
+ *
+ * The locks are loaded from the path by the first check_lock() call -- i.e.,
+ * only when a selected file could carry a lock.
  */
 
 void
 get_locks(p)
 	char *p;				/* /proc lock path */
 {
-	unsigned long bp, ep;
-	char buf[MAXPATHLEN], *ec, **fp;
+	int i;
+	struct llock *lp, *np;
+
+	for (i = 0; LckHn && (i < LckHsz); i++) {
+	    for (lp = LckH[i]; lp; lp = np) {
+		np = lp->next;
+		(void) free((FREE_P *)lp);
+	    }
+	    LckH[i] = (struct llock *)NULL;
+	}
+	LckHn = LckOFD = 0;
+	if (!LckPath || strcmp(LckPath, p)) {
+	    if (LckPath)
+		(void) free((FREE_P *)LckPath);
+	    if (!(LckPath = mkstrcpy(p, (MALLOC_S *)NULL))) {
+		(void) fprintf(stderr, "%s: no space for lock path: %s\n",
+		    Pn, p);
+		Exit(1);
+	    }
+	}
+	LckLd = 0;
+}
+
+
+#if	defined(HASEPTOPTS)
+/*
+ * hash_ept() - hash an endpoint ID
+ */
+
+static int
+hash_ept(id, mod)
+	INODETYPE id;			/* endpoint ID */
+	int mod;			/* bucket count (power of 2) */
+{
+	unsigned long long h;
+
+	h = (unsigned long long)id * 0x9e3779b97f4a7c15ULL;
+	h ^= h >> 33;
+	return((int)(h & (unsigned long long)(mod - 1)));
+}
+#endif	/* defined(HASEPTOPTS) */
+
+
+/*
+ * hash_lock() - hash a lock's PID, device and inode
+ */
+
+static int
+hash_lock(pid, dev, inode, mod)
+	int pid;			/* PID */
+	dev_t dev;			/* device */
+	INODETYPE inode;		/* inode number */
+	int mod;			/* bucket count (power of 2) */
+{
+	unsigned long long h;
+
+	h = ((unsigned long long)dev * 0x9e3779b97f4a7c15ULL)
+	  ^ (unsigned long long)inode;
+	h = (h * 0x9e3779b97f4a7c15ULL) ^ (unsigned long long)(unsigned int)pid;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return((int)(h & (unsigned long long)(mod - 1)));
+}
+
+
+/*
+ * load_locks() - load lock information from /proc/locks
+ */
+
+static void
+load_locks()
+{
+	char buf[MAXPATHLEN];
 	dev_t dev;
-	int ex, i, h, mode, pid;
+	int h, i, n, pid;
 	INODETYPE inode;
-	struct llock *lp, *np;
+	struct llock *lp, **nh, *np, *rp;
 	FILE *ls;
-	long maj, min;
 	char type;
 	static char *vbuf = (char *)NULL;
 	static size_t vsz = (size_t)0;
+
+	LckLd = 1;
 /*
- * Destroy previous lock information.
+ * If first time, allocate the lock hash buckets.
  */
-	if (LckH) {
-	    for (i = 0; i < PIDBUCKS; i++) {
-		for (lp = LckH[i]; lp; lp = np) {
-		    np = lp->next;
-		    (void) free((FREE_P *)lp);
-		}
-		LckH[i] = (struct llock *)NULL;
-	    }
-	} else {
-
-	/*
-	 * If first time, allocate the lock PID hash buckets.
-	 */
-	    LckH = (struct llock **)calloc((MALLOC_S)PIDBUCKS,
-					   sizeof(struct llock *));
-	    if (!LckH) {
+	if (!LckH) {
+	    if (!(LckH = (struct llock **)calloc((MALLOC_S)LCKHMIN,
+						 sizeof(struct llock *))))
+	    {
 		(void) fprintf(stderr,
 		    "%s: can't allocate %d lock hash bytes\n",
-		    Pn, (int)(sizeof(struct llock *) * PIDBUCKS));
+		    Pn, (int)(sizeof(struct llock *) * LCKHMIN));
 		Exit(1);
 	    }
+	    LckHsz = LCKHMIN;
 	}
 /*
  * Open the /proc lock file, assign a page size buffer to its stream,
  * and read it.
  */
-	if (!(ls = open_proc_stream(p, "r", &vbuf, &vsz, 0)))
+	if (!LckPath || !(ls = open_proc_stream(LckPath, "r", &vbuf, &vsz, 0)))
 	    return;
 	while (fgets(buf, sizeof(buf), ls)) {
-	    if (get_fields(buf, ":", &fp, (int *)NULL, 0) < 10)
-		continue;
-	    if (!fp[1] || strcmp(fp[1], "->") == 0)
-		continue;
-	/*
-	 * Get lock type.
-	 */
-	    if (!fp[3])
-		continue;
-	    if (*fp[3] == 'R')
-		mode = 0;
-	    else if (*fp[3] == 'W')
-		mode = 1;
-	    else
-		continue;
-	/*
-	 * Get PID.
-	 */
-	    if (!fp[4] || !*fp[4])
-		continue;
-	    pid = atoi(fp[4]);
-	/*
-	 * Get device number.
-	 */
-	    ec = (char *)NULL;
-	    if (!fp[5] || !*fp[5]
-	    ||  (maj = strtol(fp[5], &ec, 16)) == LONG_MIN || maj == LONG_MAX
-	    ||  !ec || *ec)
-		continue;
-	    ec = (char *)NULL;
-	    if (!fp[6] || !*fp[6]
-	    ||  (min = strtol(fp[6], &ec, 16)) == LONG_MIN || min == LONG_MAX
-	    ||  !ec || *ec)
-		continue;
-	    dev = (dev_t)makedev((int)maj, (int)min);
-	/*
-	 * Get inode number.
-	 */
-	    ec = (char *)NULL;
-	    if (!fp[7] || !*fp[7]
-	    ||  (inode = strtoull(fp[7], &ec, 0)) == ULONG_MAX
-	    ||  !ec || *ec)
-		continue;
-	/*
-	 * Get lock extent.  Convert it and the lock type to a lock character.
-	 */
-	    if (!fp[8] || !*fp[8] || !fp[9] || !*fp[9])
-		continue;
-	    ec = (char *)NULL;
-	    if ((bp = strtoul(fp[8], &ec, 0)) == ULONG_MAX || !ec || *ec)
+	    if (!parse_lock(buf, &pid, &dev, &inode, &type))
 		continue;
-	    if (!strcmp(fp[9], "EOF"))		/* for Linux 2.4.x */
-		ep = OFFSET_MAX;
-	    else {
-		ec = (char *)NULL;
-		if ((ep = strtoul(fp[9], &ec, 0)) == ULONG_MAX || !ec || *ec)
-		    continue;
-	    }
-	    ex = ((off_t)bp == (off_t)0 && (off_t)ep == OFFSET_MAX) ? 1 : 0;
-	    if (mode)
-		type = ex ? 'W' : 'w';
-	    else
-		type = ex ? 'R' : 'r';
 	/*
 	 * Look for this lock via the hash buckets.
 	 */
-	    h = HASHPID(pid);
+	    h = hash_lock(pid, dev, inode, LckHsz);
 	    for (lp = LckH[h]; lp; lp = lp->next) {
 		if (lp->pid == pid
 		&&  lp->dev == dev
@@ -744,7 +881,40 @@ get_locks(p)
 	    if (lp)
 		continue;
 	/*
-	 * Allocate a new llock structure and link it to the PID hash bucket.
+	 * If the chains have grown past LCKHLOAD entries on average, double
+	 * the bucket count and rehash.  Each chain is reversed first, so that
+	 * locks of the same file keep their newest-first order.
+	 */
+	    if ((LckHn >= LckHsz * LCKHLOAD) && (LckHsz < (INT_MAX / 2))) {
+		n = LckHsz << 1;
+		if (!(nh = (struct llock **)calloc((MALLOC_S)n,
+						   sizeof(struct llock *))))
+		{
+		    (void) fprintf(stderr,
+			"%s: can't allocate %d lock hash bytes\n",
+			Pn, (int)(sizeof(struct llock *) * n));
+		    Exit(1);
+		}
+		for (i = 0; i < LckHsz; i++) {
+		    for (rp = (struct llock *)NULL, lp = LckH[i]; lp; lp = np) {
+			np = lp->next;
+			lp->next = rp;
+			rp = lp;
+		    }
+		    for (lp = rp; lp; lp = np) {
+			np = lp->next;
+			h = hash_lock(lp->pid, lp->dev, lp->inode, n);
+			lp->next = nh[h];
+			nh[h] = lp;
+		    }
+		}
+		(void) free((FREE_P *)LckH);
+		LckH = nh;
+		LckHsz = n;
+		h = hash_lock(pid, dev, inode, LckHsz);
+	    }
+	/*
+	 * Allocate a new llock structure and link it to the hash bucket.
 	 */
 	    if (!(lp = (struct llock *)malloc(sizeof(struct llock)))) {
 		(void) snpf(buf, sizeof(buf), InodeFmt_d, inode);
@@ -759,11 +929,100 @@ get_locks(p)
 	    lp->type = type;
 	    lp->next = LckH[h];
 	    LckH[h] = lp;
+	    LckHn++;
+	    if (pid == -1)
+		LckOFD = 1;
 	}
 	(void) fclose(ls);
 }
 
 
+/*
+ * parse_lock() - parse a /proc/locks or fdinfo "lock:" line
+ *
+ * return: 1 if the line describes a lock; 0 otherwise
+ */
+
+static int
+parse_lock(ln, pid, dev, inode, type)
+	char *ln;			/* line (fields are split in place) */
+	int *pid;			/* returned PID (-1 for an OFD lock) */
+	dev_t *dev;			/* returned device */
+	INODETYPE *inode;		/* returned inode number */
+	char *type;			/* returned lock character */
+{
+	unsigned long bp, ep;
+	char *ec, **fp;
+	int ex, mode;
+	long maj, min;
+
+	if (get_fields(ln, ":", &fp, (int *)NULL, 0) < 10)
+	    return(0);
+	if (!fp[1] || strcmp(fp[1], "->") == 0)
+	    return(0);
+/*
+ * Get lock type.
+ */
+	if (!fp[3])
+	    return(0);
+	if (*fp[3] == 'R')
+	    mode = 0;
+	else if (*fp[3] == 'W')
+	    mode = 1;
+	else
+	    return(0);
+/*
+ * Get PID.
+ */
+	if (!fp[4] || !*fp[4])
+	    return(0);
+	*pid = atoi(fp[4]);
+/*
+ * Get device number.
+ */
+	ec = (char *)NULL;
+	if (!fp[5] || !*fp[5]
+	||  (maj = strtol(fp[5], &ec, 16)) == LONG_MIN || maj == LONG_MAX
+	||  !ec || *ec)
+	    return(0);
+	ec = (char *)NULL;
+	if (!fp[6] || !*fp[6]
+	||  (min = strtol(fp[6], &ec, 16)) == LONG_MIN || min == LONG_MAX
+	||  !ec || *ec)
+	    return(0);
+	*dev = (dev_t)makedev((int)maj, (int)min);
+/*
+ * Get inode number.
+ */
+	ec = (char *)NULL;
+	if (!fp[7] || !*fp[7]
+	||  (*inode = strtoull(fp[7], &ec, 0)) == ULONG_MAX
+	||  !ec || *ec)
+	    return(0);
+/*
+ * Get lock extent.  Convert it and the lock type to a lock character.
+ */
+	if (!fp[8] || !*fp[8] || !fp[9] || !*fp[9])
+	    return(0);
+	ec = (char *)NULL;
+	if ((bp = strtoul(fp[8], &ec, 0)) == ULONG_MAX || !ec || *ec)
+	    return(0);
+	if (!strcmp(fp[9], "EOF"))		/* for Linux 2.4.x */
+	    ep = OFFSET_MAX;
+	else {
+	    ec = (char *)NULL;
+	    if ((ep = strtoul(fp[9], &ec, 0)) == ULONG_MAX || !ec || *ec)
+		return(0);
+	}
+	ex = ((off_t)bp == (off_t)0 && (off_t)ep == OFFSET_MAX) ? 1 : 0;
+	if (mode)
+	    *type = ex ? 'W' : 'w';
+	else
+	    *type = ex ? 'R' : 'r';
+	return(1);
+}
+
+
 /*
  * process_proc_node() - process file node
  */
@@ -846,17 +1105,15 @@ process_proc_node(p, pbr, s, ss, l, ls)
 
 	    }
 	}
-	if (Ntype == N_REGLR && (HasNFS == 2)) {
-	    for (mp = readmnt(); mp; mp = mp->next) {
-		if ((mp->ty == N_NFS)
-		&&  (mp->ds & SB_DEV) && Lf->dev_def && (Lf->dev == mp->dev)
-		&&  (mp->dir && mp->dirl
-		&&   !strncmp(mp->dir, p, mp->dirl))
-		) {
-		    Lf->ntype = Ntype = N_NFS;
-		    break;
-		}
-	    }
+	if ((Ntype == N_REGLR) && HasNFS && Lf->dev_def) {
+
+	/*
+	 * The file is on NFS when the mount it was reached through, in its
+	 * process' mount namespace, is.  No mount namespace is looked up
+	 * unless lsof's own has an NFS mount.
+	 */
+	    if ((mp = find_nfsmnt(Lf->dev, p)))
+		Lf->ntype = Ntype = N_NFS;
 	}
 /*
  * Save the inode number.
@@ -876,11 +1133,6 @@ process_proc_node(p, pbr, s, ss, l, ls)
 #endif	/* defined(HASEPTOPTS) */
 
 	}
-/*
- * Check for a lock.
- */
-	if (Lf->dev_def && (Lf->inp_ty == 1))
-	    (void) check_lock();
 /*
  * Save the file size.
  */
@@ -969,6 +1221,23 @@ process_proc_node(p, pbr, s, ss, l, ls)
 	&& is_file_named(1, p, mp,
 			 ((type == S_IFCHR) || (type == S_IFBLK)) ? 1 : 0))
 	    Lf->sf |= SELNM;
+
+#if	defined(HASDIRPFX)
+/*
+ * Test for a file below a +B directory.  Like +D, select only files that are
+ * still linked.
+ */
+	if (Dirpfx
+	&&  ((ss & (SB_DEV | SB_NLINK)) == (SB_DEV | SB_NLINK)) && s->st_nlink
+	&&  is_file_pfx(p, s->st_dev, 1))
+	    Lf->sf |= SELNM;
+#endif	/* defined(HASDIRPFX) */
+
+/*
+ * Check a selected file for a lock.
+ */
+	if (Lf->sf && !(Lf->sf & SELEXCLF) && Lf->dev_def && (Lf->inp_ty == 1))
+	    (void) check_lock();
 /*
  * If no NAME information has been stored, store the path.
  *
@@ -74,6 +74,41 @@ static char copyright[] =
 #define	ULLONG_MAX		18446744073709551615ULL
 #endif	/* !defined(ULLONG_MAX) */
 
+#if	defined(HASRPTINCR)
+#define	INCRBUCKS	256		/* incremental repeat process hash
+					 * buckets -- MUST BE A POWER OF 2! */
+#define	HASHINCR(pid)	((int)((((pid) * 31415) >> 3) & (INCRBUCKS - 1)))
+#define	INCRHINIT	14695981039346656037ULL
+					/* incremental repeat hash seed */
+#define	INCRFINC	32		/* incremental repeat file signature
+					 * allocation increment */
+#define	INCRMEM		-1		/* signature "descriptor" of a memory-
+					 * mapped file */
+#endif	/* defined(HASRPTINCR) */
+
+#if	defined(HASPROCEVT)
+#include <poll.h>
+#include <sys/wait.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#define	PEVBUCKS	1024		/* process event PID hash buckets --
+					 * MUST BE A POWER OF 2! */
+#define	HASHPEV(pid)	((int)((((pid) * 31415) >> 3) & (PEVBUCKS - 1)))
+#define	PEVBUFL		8192		/* process event receive buffer
+					 * length */
+#define	PEVVINC		256		/* process event PID vector allocation
+					 * increment */
+#define	PEVWAIT		500		/* milliseconds to wait for the event
+					 * of the subscription test fork */
+#endif	/* defined(HASPROCEVT) */
+
+#if	defined(HASCGROUP)
+#define	CGPROCS		"cgroup.procs"	/* cgroup member PID file */
+#define	CGVINC		256		/* cgroup PID vector allocation
+					 * increment */
+#endif	/* defined(HASCGROUP) */
+
 
 /*
  * Local structures
@@ -97,6 +132,76 @@ struct l_fdinfo {
 	size_t tfd_count;
 };
 
+#if	defined(HASRPTINCR)
+/*
+ * In repeat mode the files of each process are saved at the end of a cycle,
+ * along with a signature of the state from which each was built, so that
+ * the next cycle can reuse the files whose signatures haven't changed.
+ */
+
+struct incrfile {			/* saved file signature */
+	int fd;				/* file descriptor number or INCRMEM */
+	unsigned long long lh;		/* /proc link text hash */
+	dev_t dev;			/* stat(2) device */
+	INODETYPE ino;			/* stat(2) inode number */
+	off_t size;			/* stat(2) size */
+	mode_t mode;			/* stat(2) mode */
+	mode_t lmode;			/* lstat(2) mode -- i.e., access */
+	nlink_t nlink;			/* stat(2) link count */
+	time_t ctm;			/* stat(2) change time seconds */
+	long ctmn;			/* stat(2) change time nanoseconds */
+	struct lfile *lf;		/* saved file, NULL once reused */
+};
+
+struct incrproc {			/* saved process */
+	int pid;			/* process ID */
+	int tid;			/* task ID */
+	int lpx;			/* Lproc[] index */
+	unsigned long long stm;		/* process start time */
+	unsigned long long msum;	/* maps file checksum */
+	short msd;			/* msum is defined */
+	short saved;			/* file list has been saved */
+	short own;			/* the file list belongs to this entry
+					 * (it doesn't in repeat delta mode,
+					 * where main.c keeps it) */
+	struct incrfile *f;		/* file signatures */
+	int fa;				/* f[] entries allocated */
+	int fn;				/* f[] entries used */
+	int fx;				/* f[] search cursor */
+	struct lfile *file;		/* saved file list */
+
+#if	defined(HASLPARENA)
+	struct lpachunk *arena;		/* arena of the saved files, if own */
+#endif	/* defined(HASLPARENA) */
+
+	struct incrproc *next;		/* next hash bucket entry */
+};
+#endif	/* defined(HASRPTINCR) */
+
+#if	defined(HASPROCEVT)
+/*
+ * In repeat mode with the -r `p' suffix, lsof subscribes to the kernel's
+ * process connector and keeps a table of the PIDs it has seen.  Fork, exec,
+ * ID change, command name change and exit events keep the table current,
+ * so the next cycle can visit the table instead of reading the /proc
+ * directory, and can skip processes that were excluded from the listing
+ * by process selection options and haven't changed since.
+ */
+
+struct pevproc {			/* process known from events */
+	int pid;			/* process ID */
+	short excl;			/* excluded and unchanged since */
+	struct pevproc *next;		/* next hash bucket entry */
+};
+#endif	/* defined(HASPROCEVT) */
+
+#if	defined(HASCGROUP)
+struct cgrppid {			/* member of a selected cgroup */
+	int pid;			/* process ID */
+	cgrplist_t *cg;			/* cgroup argument that named it */
+};
+#endif	/* defined(HASCGROUP) */
+
 
 /*
  * Local variables
@@ -109,6 +214,48 @@ static short Cckreg;			/* conditional status of regular file
 static short Ckscko;			/* socket file only checking status:
 					 *     0 = none
 					 *     1 = check only socket files */
+static short Hungfs = 0;		/* Efsysl has a file system quarantined
+					 * by enter_hungfs() */
+
+#if	defined(HASRPTINCR)
+static short Incr = 0;			/* incremental repeat status:
+					 *     0 = disabled
+					 *     1 = reuse memory-mapped files
+					 *     2 = also reuse descriptors */
+static struct incrproc **IncrN = (struct incrproc **)NULL;
+					/* this cycle's processes */
+static struct incrproc **IncrP = (struct incrproc **)NULL;
+					/* previous cycle's processes */
+static struct incrproc *Ipc = (struct incrproc *)NULL;
+					/* current process' entry */
+static struct incrproc *Ipp = (struct incrproc *)NULL;
+					/* current process' previous entry */
+#endif	/* defined(HASRPTINCR) */
+
+#if	defined(HASPROCEVT)
+static short Pev = 0;			/* process event status:
+					 *    -1 = unavailable; poll /proc
+					 *     0 = not yet subscribed
+					 *     1 = read /proc to build PevH[]
+					 *     2 = visit PevH[] */
+static struct pevproc **PevH = (struct pevproc **)NULL;
+					/* PIDs known from /proc and events */
+static int Pevs = -1;			/* process event socket */
+static short Pevsk = 0;			/* excluded processes may be skipped */
+static int *Pevv = (int *)NULL;		/* PIDs to visit this cycle */
+static int Pevva = 0;			/* Pevv[] entries allocated */
+static int Pevvn = 0;			/* Pevv[] entries used */
+static short Pevx = 0;			/* process_id() excluded the process */
+#endif	/* defined(HASPROCEVT) */
+
+#if	defined(HASCGROUP)
+static struct cgrppid *Cgpv = (struct cgrppid *)NULL;
+					/* this cycle's selected cgroup PIDs,
+					 * sorted by PID */
+static int Cgpva = 0;			/* Cgpv[] entries allocated */
+static int Cgpvn = 0;			/* Cgpv[] entries used */
+static short Cgwalk = 0;		/* visit only the Cgpv[] PIDs */
+#endif	/* defined(HASCGROUP) */
 
 
 /*
@@ -116,21 +263,58 @@ static short Ckscko;			/* socket file only checking status:
  */
 
 _PROTOTYPE(static MALLOC_S alloc_cbf,(MALLOC_S len, char **cbf, MALLOC_S cbfa));
+_PROTOTYPE(static void enter_hungfs,(char *p));
 _PROTOTYPE(static int get_fdinfo,(char *p, int msk, struct l_fdinfo *fi));
 _PROTOTYPE(static int getlinksrc,(char *ln, char *src, int srcl, char **rest));
+_PROTOTYPE(static efsys_list_t *is_hungfs,(char *p));
 _PROTOTYPE(static int isefsys,(char *path, char *type, int l,
 			       efsys_list_t **rep, struct lfile **lfr));
 _PROTOTYPE(static int nm2id,(char *nm, int *id, int *idl));
 _PROTOTYPE(static int read_id_stat,(char *p, int id, char **cmd, int *ppid,
-				    int *pgid));
+				    int *pgid, unsigned long long *stm));
 _PROTOTYPE(static void process_proc_map,(char *p, struct stat *s, int ss));
 _PROTOTYPE(static int process_id,(char *idp, int idpl, char *cmd, UID_ARG uid,
 				  int pid, int ppid, int pgid, int tid,
-				  char *tcmd));
+				  char *tcmd, unsigned long long stm));
+_PROTOTYPE(static int safestat,(char *path, char *tp, struct stat *s, int l));
 _PROTOTYPE(static int statEx,(char *p, struct stat *s, int *ss));
 
 _PROTOTYPE(static void snp_eventpoll, (char *p, int len, int *tfds, int tfd_count));
 
+#if	defined(HASRPTINCR)
+_PROTOTYPE(static void clr_incr,(void));
+_PROTOTYPE(static void enter_incrproc,(int pid, int tid,
+				       unsigned long long stm));
+_PROTOTYPE(static void free_incrproc,(struct incrproc *ip));
+_PROTOTYPE(static unsigned long long hash_incr,(char *s,
+						 unsigned long long h));
+_PROTOTYPE(static void init_incr,(void));
+_PROTOTYPE(static void link_incrfile,(struct incrfile *isg));
+_PROTOTYPE(static void make_incrsig,(struct incrfile *isg, int fd, char *lnk,
+				     struct stat *sb, struct stat *lsb));
+_PROTOTYPE(static int reuse_incrfile,(struct incrfile *isg));
+_PROTOTYPE(static void reuse_incrmem,(void));
+_PROTOTYPE(static void use_incrfile,(struct incrfile *f));
+#endif	/* defined(HASRPTINCR) */
+
+#if	defined(HASCGROUP)
+_PROTOTYPE(static int cmp_cgrppid,(COMP_P *a1, COMP_P *a2));
+_PROTOTYPE(static char *find_cgrp2fs,(void));
+_PROTOTYPE(static int is_cgrp_dir,(char *path));
+_PROTOTYPE(static int is_cgrp_excl,(int pid, short *pss, int *sf));
+_PROTOTYPE(static void read_cgrp,(char *path, cgrplist_t *cg));
+_PROTOTYPE(static void read_cgrps,(void));
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASPROCEVT)
+_PROTOTYPE(static void clr_pev,(void));
+_PROTOTYPE(static void drop_pev,(int pid));
+_PROTOTYPE(static struct pevproc *enter_pev,(int pid));
+_PROTOTYPE(static void init_pev,(void));
+_PROTOTYPE(static int open_pev,(void));
+_PROTOTYPE(static int read_pev,(int tpid));
+#endif	/* defined(HASPROCEVT) */
+
 #if	defined(HASSELINUX)
 _PROTOTYPE(static int cmp_cntx_eq,(char *pcntx, char *ucntx));
 
@@ -188,6 +372,274 @@ enter_cntx_arg(cntx)
 #endif	/* defined(HASSELINUX) */
 
 
+#if	defined(HASCGROUP)
+/*
+ * cmp_cgrppid() - compare selected cgroup PIDs for qsort()
+ */
+
+static int
+cmp_cgrppid(a1, a2)
+	COMP_P *a1;			/* first entry */
+	COMP_P *a2;			/* second entry */
+{
+	int p1 = ((struct cgrppid *)a1)->pid;
+	int p2 = ((struct cgrppid *)a2)->pid;
+
+	if (p1 < p2)
+	    return(-1);
+	return((p1 > p2) ? 1 : 0);
+}
+
+
+/*
+ * enter_cgrp_arg() - enter cgroup argument
+ */
+
+int
+enter_cgrp_arg(cg, r)
+	char *cg;			/* cgroup path */
+	int r;				/* include descendants if non-zero */
+{
+	cgrplist_t *cgp;
+	char *cp, *path;
+	static char *fs = (char *)NULL;
+	MALLOC_S len;
+/*
+ * Search the argument list for a duplicate.
+ */
+	for (cgp = CgrpArg; cgp; cgp = cgp->next) {
+	    if (!strcmp(cgp->cg, cg)) {
+		if (!Fwarn) {
+		    (void) fprintf(stderr, "%s: duplicate cgroup: %s\n",
+			Pn, cg);
+		}
+		return(1);
+	    }
+	}
+/*
+ * An absolute path to a cgroup directory -- of either cgroup version -- is
+ * used as is.  Any other name is looked up in the cgroup v2 hierarchy, the
+ * way /proc/<PID>/cgroup shows it.
+ */
+	if ((*cg == '/') && is_cgrp_dir(cg)) {
+	    if (!(path = mkstrcpy(cg, (MALLOC_S *)NULL))) {
+		(void) fprintf(stderr, "%s: no space for cgroup: %s\n", Pn, cg);
+		Exit(1);
+	    }
+	} else {
+	    if (!fs && !(fs = find_cgrp2fs())) {
+		(void) fprintf(stderr,
+		    "%s: no cgroup v2 file system for cgroup: %s\n", Pn, cg);
+		return(1);
+	    }
+	    for (cp = cg; *cp == '/'; cp++)
+		;
+	    len = (MALLOC_S)(strlen(fs) + 1 + strlen(cp) + 1);
+	    if (!(path = (char *)malloc(len))) {
+		(void) fprintf(stderr, "%s: no space for cgroup: %s\n", Pn, cg);
+		Exit(1);
+	    }
+	    (void) snpf(path, (size_t)len, "%s/%s", fs, cp);
+	    if (!is_cgrp_dir(path)) {
+		(void) fprintf(stderr, "%s: not a cgroup: %s\n", Pn, cg);
+		(void) free((FREE_P *)path);
+		return(1);
+	    }
+	}
+/*
+ * Create and link a new cgroup argument list entry.
+ */
+	if (!(cgp = (cgrplist_t *)malloc((MALLOC_S)sizeof(cgrplist_t)))) {
+	    (void) fprintf(stderr, "%s: no space for cgroup: %s\n", Pn, cg);
+	    Exit(1);
+	}
+	cgp->cg = cg;
+	cgp->path = path;
+	cgp->f = 0;
+	cgp->r = r;
+	cgp->next = CgrpArg;
+	CgrpArg = cgp;
+	return(0);
+}
+
+
+/*
+ * find_cgrp2fs() - find the cgroup v2 file system's mount point
+ */
+
+static char *
+find_cgrp2fs()
+{
+	char buf[MAXPATHLEN + 1], **fp, *mp;
+	FILE *ms;
+
+	(void) snpf(buf, sizeof(buf), "%s/mounts", PROCFS);
+	if (!(ms = fopen(buf, "r")))
+	    return((char *)NULL);
+	for (mp = (char *)NULL; fgets(buf, sizeof(buf), ms);) {
+	    if ((get_fields(buf, (char *)NULL, &fp, (int *)NULL, 0) < 3)
+	    ||  !fp[1] || !fp[2] || strcmp(fp[2], "cgroup2"))
+		continue;
+	    if (!(mp = mkstrcpy(fp[1], (MALLOC_S *)NULL))) {
+		(void) fprintf(stderr, "%s: no space for cgroup mount: %s\n",
+		    Pn, fp[1]);
+		Exit(1);
+	    }
+	    break;
+	}
+	(void) fclose(ms);
+	return(mp);
+}
+
+
+/*
+ * is_cgrp_dir() - is path a cgroup directory?
+ */
+
+static int
+is_cgrp_dir(path)
+	char *path;			/* directory path */
+{
+	char buf[MAXPATHLEN + 1];
+	struct stat sb;
+
+	(void) snpf(buf, sizeof(buf), "%s/%s", path, CGPROCS);
+	return((!stat(buf, &sb) && S_ISREG(sb.st_mode)) ? 1 : 0);
+}
+
+
+/*
+ * is_cgrp_excl() - is process excluded by cgroup selection?
+ *
+ * return: 1 = excluded; 0 = not excluded (*pss and *sf are marked if the
+ *	   process is in a selected cgroup)
+ */
+
+static int
+is_cgrp_excl(pid, pss, sf)
+	int pid;			/* process ID */
+	short *pss;			/* process select state for lproc */
+	int *sf;			/* cgroup select flag return */
+{
+	int h, l, m;
+
+	*sf = 0;
+	if (!CgrpArg)
+	    return(0);
+	for (l = 0, h = Cgpvn - 1; l <= h;) {
+	    m = (l + h) / 2;
+	    if (pid < Cgpv[m].pid)
+		h = m - 1;
+	    else if (pid > Cgpv[m].pid)
+		l = m + 1;
+	    else {
+		Cgpv[m].cg->f = 1;
+		*pss |= PS_PRI;
+		*sf = SELCGRP;
+		return(0);
+	    }
+	}
+/*
+ * The process isn't in a selected cgroup.  That excludes it when cgroups
+ * are the only selection, or when selections are ANDed.
+ */
+	return((Fand || (Selflags == SELCGRP)) ? 1 : 0);
+}
+
+
+/*
+ * read_cgrp() - read the PIDs of a cgroup and, optionally, its descendants
+ */
+
+static void
+read_cgrp(path, cg)
+	char *path;			/* cgroup directory path */
+	cgrplist_t *cg;			/* cgroup argument */
+{
+	char buf[MAXPATHLEN + 1];
+	DIR *ds;
+	struct dirent *dp;
+	FILE *fs;
+	MALLOC_S len;
+	int pid;
+	struct stat sb;
+/*
+ * Add the cgroup's member PIDs to the vector.  Processes may leave the cgroup
+ * while it is being read; /proc reading will discover those that have exited.
+ */
+	(void) snpf(buf, sizeof(buf), "%s/%s", path, CGPROCS);
+	if ((fs = fopen(buf, "r"))) {
+	    while (fgets(buf, sizeof(buf), fs)) {
+		if ((pid = atoi(buf)) <= 0)
+		    continue;
+		if (Cgpvn >= Cgpva) {
+		    Cgpva += CGVINC;
+		    len = (MALLOC_S)(Cgpva * sizeof(struct cgrppid));
+		    if (Cgpv)
+			Cgpv = (struct cgrppid *)realloc((MALLOC_P *)Cgpv, len);
+		    else
+			Cgpv = (struct cgrppid *)malloc(len);
+		    if (!Cgpv) {
+			(void) fprintf(stderr,
+			    "%s: no space for %d cgroup PIDs\n", Pn, Cgpva);
+			Exit(1);
+		    }
+		}
+		Cgpv[Cgpvn].pid = pid;
+		Cgpv[Cgpvn++].cg = cg;
+	    }
+	    (void) fclose(fs);
+	}
+	if (!cg->r || !(ds = opendir(path)))
+	    return;
+/*
+ * Descend into the child cgroups.
+ */
+	while ((dp = readdir(ds))) {
+	    if (dp->d_name[0] == '.')
+		continue;
+	    if ((dp->d_type != DT_DIR) && (dp->d_type != DT_UNKNOWN))
+		continue;
+	    (void) snpf(buf, sizeof(buf), "%s/%s", path, dp->d_name);
+	    if ((dp->d_type == DT_UNKNOWN)
+	    &&  (stat(buf, &sb) || !S_ISDIR(sb.st_mode)))
+		continue;
+	    (void) read_cgrp(buf, cg);
+	}
+	(void) closedir(ds);
+}
+
+
+/*
+ * read_cgrps() - read the PIDs of the selected cgroups for a cycle
+ */
+
+static void
+read_cgrps()
+{
+	cgrplist_t *cgp;
+	int i, j;
+
+	for (Cgpvn = 0, cgp = CgrpArg; cgp; cgp = cgp->next) {
+	    (void) read_cgrp(cgp->path, cgp);
+	}
+	if (Cgpvn < 2)
+	    return;
+/*
+ * Sort the PIDs and remove the duplicates that overlapping recursive
+ * selections produce.
+ */
+	(void) qsort((QSORT_P *)Cgpv, (size_t)Cgpvn, sizeof(struct cgrppid),
+		     cmp_cgrppid);
+	for (i = j = 1; i < Cgpvn; i++) {
+	    if (Cgpv[i].pid != Cgpv[j - 1].pid)
+		Cgpv[j++] = Cgpv[i];
+	}
+	Cgpvn = j;
+}
+#endif	/* defined(HASCGROUP) */
+
+
 /*
  * alloc_cbf() -- allocate a command buffer
  */
@@ -218,11 +670,12 @@ alloc_cbf(len, cbf, cbfa)
 void
 gather_proc_info()
 {
-	char *cmd, *tcmd;
+	char *cmd, *pnm, *tcmd;
 	char cmdbuf[MAXPATHLEN];
 	struct dirent *dp;
 	unsigned char ht, pidts;
 	int n, nl, pgid, pid, ppid, prv, rv, tid, tpgid, tppid, tx;
+	unsigned long long stm, tstm;
 	static char *path = (char *)NULL;
 	static int pathl = 0;
 	static char *pidpath = (char *)NULL;
@@ -237,6 +690,19 @@ gather_proc_info()
 	DIR *ts;
 	UID_ARG uid;
 
+#if	defined(HASCGROUP)
+	int cgx = 0;
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASPROCEVT) || defined(HASCGROUP)
+	char pidnm[32];
+#endif	/* defined(HASPROCEVT) || defined(HASCGROUP) */
+
+#if	defined(HASPROCEVT)
+	struct pevproc *pp;
+	int pvx = 0;
+#endif	/* defined(HASPROCEVT) */
+
 /*
  * Do one-time setup.
  */
@@ -252,12 +718,20 @@ gather_proc_info()
 	    (void) snpf(pidpath, pidpathl, "%s/", PROCFS);
 	}
 /*
- * Get lock and net information.
+ * Note where the lock information is, and get net information.
  */
 	(void) make_proc_path(pidpath, pidx, &path, &pathl, "locks");
 	(void) get_locks(path);
 	(void) make_proc_path(pidpath, pidx, &path, &pathl, "net/");
 	(void) set_net_paths(path, strlen(path));
+
+#if	defined(HASMNTNS)
+/*
+ * Have the tables of other mount namespaces read again, so that a repeat
+ * cycle sees their current mounts.
+ */
+	(void) clr_mntns();
+#endif	/* defined(HASMNTNS) */
 /*
  * If only socket files have been selected, or socket files have been selected
  * ANDed with other selection options, enable the skipping of regular files.
@@ -303,9 +777,37 @@ gather_proc_info()
 	 */
 	    Cckreg = Ckscko = 0;
 	}
+
+#if	defined(HASRPTINCR)
+/*
+ * Make the files saved in the previous repeat cycle available for reuse.
+ */
+	(void) init_incr();
+#endif	/* defined(HASRPTINCR) */
+
+#if	defined(HASCGROUP)
+/*
+ * Read the member PIDs of the selected cgroups.  When no other process can
+ * be listed -- and none is needed for endpoint information -- visit only
+ * those PIDs, rather than reading /proc.
+ */
+	if (CgrpArg) {
+	    (void) read_cgrps();
+	    Cgwalk = (!FeptE && (Fand || (Selflags == SELCGRP))) ? 1 : 0;
+	}
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASPROCEVT)
 /*
- * Read /proc, looking for PID directories.  Open each one and
- * gather its process and file information.
+ * Learn which processes have changed since the previous repeat cycle.
+ */
+	(void) init_pev();
+#endif	/* defined(HASPROCEVT) */
+
+/*
+ * Read /proc, looking for PID directories -- or, when process events are
+ * being followed or cgroups limit the selection, visit the PIDs they have
+ * left to visit.  Open each one and gather its process and file information.
  */
 	if (!ps) {
 	    if (!(ps = opendir(PROCFS))) {
@@ -314,9 +816,42 @@ gather_proc_info()
 	    }
 	} else
 	    (void) rewinddir(ps);
-	while ((dp = readdir(ps))) {
-	    if (nm2id(dp->d_name, &pid, &n))
-		continue;
+	for (;;) {
+
+#if	defined(HASCGROUP)
+	    if (Cgwalk) {
+		if (cgx >= Cgpvn)
+		    break;
+		pid = Cgpv[cgx++].pid;
+		n = snpf(pidnm, sizeof(pidnm), "%d", pid);
+		pnm = pidnm;
+	    } else
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASPROCEVT)
+	    if (Pev == 2) {
+		if (pvx >= Pevvn)
+		    break;
+		pid = Pevv[pvx++];
+		n = snpf(pidnm, sizeof(pidnm), "%d", pid);
+		pnm = pidnm;
+	    } else
+#endif	/* defined(HASPROCEVT) */
+
+	    {
+		if (!(dp = readdir(ps)))
+		    break;
+		if (nm2id(dp->d_name, &pid, &n))
+		    continue;
+		pnm = dp->d_name;
+	    }
+
+#if	defined(HASPROCEVT)
+	    if ((pp = (Pev > 0) ? enter_pev(pid) : (struct pevproc *)NULL))
+		pp->excl = 0;
+	    Pevx = 0;
+#endif	/* defined(HASPROCEVT) */
+
 	/*
 	 * Build path to PID's directory.
 	 */
@@ -326,11 +861,11 @@ gather_proc_info()
 		{
 		    (void) fprintf(stderr,
 			"%s: can't allocate %d bytes for \"%s/%s/\"\n",
-			Pn, (int)pidpathl, PROCFS, dp->d_name);
+			Pn, (int)pidpathl, PROCFS, pnm);
 		    Exit(1);
 		}
 	    }
-	    (void) snpf(pidpath + pidx, pidpathl - pidx, "%s/", dp->d_name);
+	    (void) snpf(pidpath + pidx, pidpathl - pidx, "%s/", pnm);
 	    n += (pidx + 1);
 	/*
 	 * Process the PID's stat info.
@@ -343,7 +878,7 @@ gather_proc_info()
 	 * Get the PID's command name.
 	 */
 	    (void) make_proc_path(pidpath, n, &path, &pathl, "stat");
-	    if ((prv = read_id_stat(path, pid, &cmd, &ppid, &pgid)) < 0) 
+	    if ((prv = read_id_stat(path, pid, &cmd, &ppid, &pgid, &stm)) < 0)
 		cmd = "(unknown)";
 
 #if	defined(HASTASKS)
@@ -406,14 +941,14 @@ gather_proc_info()
 		     * Check the task state.
 		     */
 			rv = read_id_stat(tidpath, tid, &tcmd, &tppid,
-					  &tpgid);
+					  &tpgid, &tstm);
 			if ((rv < 0) || (rv == 1))
 			    continue;
 		    /*
 		     * Attempt to record the task.
 		     */
 			if (!process_id(tidpath, (tx + 1 + nl+ 1), cmd, uid,
-					pid, tppid, tpgid, tid, tcmd))
+					pid, tppid, tpgid, tid, tcmd, tstm))
 			{
 			    ht = 1;
 			}
@@ -433,12 +968,91 @@ gather_proc_info()
 		tid = (Fand && ht && pidts && !IgnTasks && (Selflags & SELTASK))
 		    ? pid : 0;
 		if ((!process_id(pidpath, n, cmd, uid, pid, ppid, pgid, tid,
-				 (char *)NULL))
+				 (char *)NULL, stm))
 		&&  tid)
 		{
 		    Lp->tid = 0;
 		}
 	    }
+
+#if	defined(HASPROCEVT)
+	/*
+	 * Remember a zombie or an excluded process, so it can be skipped until
+	 * its next event.
+	 */
+	    if (pp && Pevsk && ((prv == 1) || Pevx))
+		pp->excl = 1;
+#endif	/* defined(HASPROCEVT) */
+
+	}
+
+#if	defined(HASPROCEVT)
+	if (Pev == 1)
+	    Pev = 2;
+#endif	/* defined(HASPROCEVT) */
+
+#if	defined(HASRPTINCR)
+/*
+ * Release the previous cycle's files that weren't reused.
+ */
+	(void) clr_incr();
+#endif	/* defined(HASRPTINCR) */
+
+}
+
+
+/*
+ * enter_hungfs() - quarantine the file system of a path whose safe stat(2)
+ *		    timed out
+ *
+ * The file system's mounted directory is added to Efsysl, so that the rest of
+ * its files are treated as if it had been named with +e -- without waiting
+ * for another timeout on each of them.
+ *
+ * The root file system isn't quarantined: find_mntpath() also returns it for
+ * a path whose own mount it can't find, and quarantining it would skip every
+ * later file.
+ */
+
+static void
+enter_hungfs(p)
+	char *p;			/* path */
+{
+	efsys_list_t *ep;
+	struct mounts *mp;
+
+	if (!(mp = find_mntpath(p)) || (mp->dirl < 2))
+	    return;
+	for (ep = Efsysl; ep; ep = ep->next) {
+	    if (!strcmp(ep->path, mp->dir))
+		return;
+	}
+	if (!(ep = (efsys_list_t *)malloc((MALLOC_S)(sizeof(efsys_list_t))))
+	||  !(ep->path = mkstrcpy(mp->dir, (MALLOC_S *)NULL))
+	||  !(ep->mp = (struct mounts *)malloc(sizeof(struct mounts))))
+	{
+	    (void) fprintf(stderr, "%s: no space for hung file system: ", Pn);
+	    safestrprt(mp->dir, stderr, 1);
+	    Exit(1);
+	}
+	ep->pathl = (int)mp->dirl;
+	ep->rdlnk = ep->hung = 1;
+/*
+ * Keep a copy of the mount entry.  It may be in the table of another mount
+ * namespace, which clr_mntns() releases at the next repeat cycle.
+ */
+	*ep->mp = *mp;
+	ep->mp->dir = ep->path;
+	ep->mp->fsname = ep->mp->fsnmres = (char *)NULL;
+	ep->mp->next = (struct mounts *)NULL;
+	ep->next = Efsysl;
+	Efsysl = ep;
+	Hungfs = 1;
+	if (!Fwarn) {
+	    (void) fprintf(stderr,
+		"%s: WARNING: stat() timed out on file system ", Pn);
+	    safestrprt(mp->dir, stderr, 0);
+	    (void) fprintf(stderr, "; skipping its files.\n");
 	}
 }
 
@@ -745,179 +1359,985 @@ make_proc_path(pp, pl, np, nl, sf)
 
 
 /*
- * isefsys() -- is path on a file system exempted with -e
- *
- * Note: alloc_lfile() must have been called in advance.
+ * is_hungfs() - is a path on a file system quarantined by enter_hungfs()?
+ */
+
+static efsys_list_t *
+is_hungfs(p)
+	char *p;			/* path */
+{
+	efsys_list_t *ep;
+
+	if (Hungfs && !isefsys(p, (char *)NULL, 0, &ep, NULL) && ep->hung)
+	    return(ep);
+	return((efsys_list_t *)NULL);
+}
+
+
+/*
+ * isefsys() -- is path on a file system exempted with -e
+ *
+ * Note: alloc_lfile() must have been called in advance.
+ */
+
+static int
+isefsys(path, type, l, rep, lfr)
+	char *path;			/* path to file */
+	char *type;			/* unknown file type */
+	int l;				/* link request: 0 = report
+					 *               1 = link */
+	efsys_list_t **rep;		/* returned Efsysl pointer, if not
+					 * NULL */
+	struct lfile **lfr;		/* allocated struct lfile pointer */
+{
+	efsys_list_t *ep;
+	int ds, len;
+	struct mounts *mp;
+	char nmabuf[MAXPATHLEN + 1];
+
+	len = (int) strlen(path);
+	for (ep = Efsysl; ep; ep = ep->next) {
+
+	/*
+	 * Look for a matching exempt file system path at the beginning of
+	 * the file path.
+	 */
+	    if (ep->pathl > len)
+		continue;
+	    if (strncmp(ep->path, path, ep->pathl))
+		continue;
+	/*
+	 * A quarantined file system's path must match whole path components,
+	 * so that quarantining /mnt/a doesn't also quarantine /mnt/ab.
+	 */
+	    if (ep->hung && path[ep->pathl] && (path[ep->pathl] != '/'))
+		continue;
+	/*
+	 * If only reporting, return information as requested.
+	 */
+	    if (!l) {
+		if (rep)
+		    *rep = ep;
+		return(0);
+	    }
+	/*
+	 * Process an exempt file.
+	 */
+	    ds = 0;
+	    if ((mp = ep->mp)) {
+		if (mp->ds & SB_DEV) {
+		    Lf->dev = mp->dev;
+		    ds = Lf->dev_def = 1;
+		}
+		if (mp->ds & SB_RDEV) {
+		    Lf->rdev = mp->rdev;
+		    ds = Lf->rdev_def = 1;
+		}
+	    }
+	    if (!ds)
+		(void) enter_dev_ch("UNKNOWN");
+	    Lf->ntype = N_UNKN;
+	    (void) snpf(Lf->type, sizeof(Lf->type), "%s",
+			(type ? type : "UNKN"));
+	    (void) enter_nm(path);
+	    if (ep->hung)
+		(void) snpf(nmabuf, sizeof(nmabuf), "(hung %s)", ep->path);
+	    else
+		(void) snpf(nmabuf, sizeof(nmabuf), "(%ce %s)",
+		    ep->rdlnk ? '+' : '-', ep->path);
+	    nmabuf[sizeof(nmabuf) - 1] = '\0';
+	    (void) add_nma(nmabuf, strlen(nmabuf));
+	    if (Lf->sf) {
+		if (lfr)
+		    *lfr = Lf;
+		link_lfile();
+	    } else if (lfr)
+		*lfr = (struct lfile *)NULL;
+	    return(0);
+	}
+	return(1);
+}
+
+
+/*
+ * nm2id() - convert a name to an integer ID
+ */
+
+static int
+nm2id(nm, id, idl)
+	char *nm;			/* pointer to name */
+	int *id;			/* pointer to ID receiver */
+	int *idl;			/* pointer to ID length receiver */
+{
+	register int tid, tidl;
+
+	for (*id = *idl = tid = tidl = 0; *nm; nm++) {
+
+#if	defined(__STDC__)	/* { */
+	    if (!isdigit((unsigned char)*nm))
+#else	/* !defined(__STDC__)	   } { */
+	    if (!isascii(*nm) || !isdigit((unsigned char)*cp))
+#endif	/* defined(__STDC__)	   } */
+
+		{
+		    return(1);
+		}
+		tid = tid * 10 + (int)(*nm - '0');
+		tidl++;
+	}
+	*id = tid;
+	*idl = tidl;
+	return(0);
+}
+
+
+/*
+ * open_proc_stream() -- open a /proc stream
+ */
+
+FILE *
+open_proc_stream(p, m, buf, sz, act)
+	char *p;			/* pointer to path to open */
+	char *m;			/* pointer to mode -- e.g., "r" */
+	char **buf;			/* pointer tp setvbuf() address
+					 * (NULL if none) */
+	size_t *sz;			/* setvbuf() size (0 if none or if
+					 * getpagesize() desired */
+	int act;			/* fopen() failure action:
+					 *     0 : return (FILE *)NULL
+					 *   <>0 : fprintf() an error message
+					 *         and Exit(1)
+					 */
+{
+	FILE *fs;			/* opened stream */
+	static size_t psz = (size_t)0;	/* page size */
+	size_t tsz;			/* temporary size */
+/*
+ * Open the stream.
+ */
+	if (!(fs = fopen(p, m))) {
+	    if (!act)
+		return((FILE *)NULL);
+	    (void) fprintf(stderr, "%s: can't fopen(%s, \"%s\"): %s\n",
+		Pn, p, m, strerror(errno));
+	    Exit(1);
+	}
+/*
+ * Return the stream if no buffer change is required.
+ */
+	if (!buf)
+	    return(fs);
+/*
+ * Determine the buffer size required.
+ */
+	if (!(tsz = *sz)) {
+	    if (!psz)
+		psz = getpagesize();
+	    tsz = psz;
+	}
+/*
+ * Allocate a buffer for the stream, as required.
+ */
+	if (!*buf) {
+	    if (!(*buf = (char *)malloc((MALLOC_S)tsz))) {
+		(void) fprintf(stderr,
+		    "%s: can't allocate %d bytes for %s stream buffer\n",
+		    Pn, (int)tsz, p);
+		Exit(1);
+	    }
+	    *sz = tsz;
+	}
+/*
+ * Assign the buffer to the stream.
+ */
+	if (setvbuf(fs, *buf, _IOFBF, tsz)) {
+	    (void) fprintf(stderr, "%s: setvbuf(%s)=%d failure: %s\n",
+		Pn, p, (int)tsz, strerror(errno));
+	    Exit(1);
+	}
+	return(fs);
+}
+
+
+#if	defined(HASRPTINCR)
+/*
+ * clr_incr() - release the previous repeat cycle's unused files
+ */
+
+static void
+clr_incr()
+{
+	int h;
+	struct incrproc *ip, *nx;
+
+	if (Ipp) {
+	    (void) free_incrproc(Ipp);
+	    Ipp = (struct incrproc *)NULL;
+	}
+	Ipc = (struct incrproc *)NULL;
+	if (!IncrP)
+	    return;
+	for (h = 0; h < INCRBUCKS; h++) {
+	    for (ip = IncrP[h]; ip; ip = nx) {
+		nx = ip->next;
+		(void) free_incrproc(ip);
+	    }
+	    IncrP[h] = (struct incrproc *)NULL;
+	}
+}
+
+
+/*
+ * enter_incrproc() - enter an ID in this cycle's process table and find its
+ *		      entry from the previous cycle
+ */
+
+static void
+enter_incrproc(pid, tid, stm)
+	int pid;			/* process ID */
+	int tid;			/* task ID */
+	unsigned long long stm;		/* start time */
+{
+	int h;
+	struct incrproc *ip, **pp;
+
+	if (Ipp) {
+	    (void) free_incrproc(Ipp);
+	    Ipp = (struct incrproc *)NULL;
+	}
+/*
+ * Unlink the ID's previous entry.  Use it only if its files were saved and
+ * its start time shows it's the same instance of the ID.
+ */
+	h = HASHINCR(pid);
+	for (pp = &IncrP[h]; (ip = *pp); pp = &ip->next) {
+	    if ((ip->pid == pid) && (ip->tid == tid)) {
+		*pp = ip->next;
+		if (ip->saved && stm && (ip->stm == stm))
+		    Ipp = ip;
+		else
+		    (void) free_incrproc(ip);
+		break;
+	    }
+	}
+/*
+ * Allocate and link an entry for this cycle.
+ */
+	if (!(ip = (struct incrproc *)calloc(1, sizeof(struct incrproc)))) {
+	    (void) fprintf(stderr,
+		"%s: no space for incremental repeat entry, PID %d\n",
+		Pn, pid);
+	    Exit(1);
+	}
+	ip->pid = pid;
+	ip->tid = tid;
+	ip->lpx = (int)(Lp - Lproc);
+	ip->stm = stm;
+	ip->next = IncrN[h];
+	IncrN[h] = Ipc = ip;
+}
+
+
+/*
+ * free_incrproc() - free an incremental repeat process entry
+ */
+
+static void
+free_incrproc(ip)
+	struct incrproc *ip;		/* entry pointer */
+{
+	struct lproc lp;
+
+	if (ip->saved && ip->own && ip->file) {
+
+	/*
+	 * Free the saved files that weren't reused.  (Those that were have
+	 * given away their allocated strings.)
+	 */
+	    zeromem((char *)&lp, sizeof(lp));
+	    lp.file = ip->file;
+
+#if	defined(HASLPARENA)
+	    lp.arena = ip->arena;
+#endif	/* defined(HASLPARENA) */
+
+	    (void) free_lproc(&lp);
+	}
+	if (ip->f)
+	    (void) free((FREE_P *)ip->f);
+	(void) free((FREE_P *)ip);
+}
+
+
+/*
+ * hash_incr() - add a string to an incremental repeat hash (FNV-1a)
+ */
+
+static unsigned long long
+hash_incr(s, h)
+	char *s;			/* string */
+	unsigned long long h;		/* hash so far */
+{
+	for (; *s; s++) {
+	    h = (h ^ (unsigned char)*s) * 1099511628211ULL;
+	}
+	return(h);
+}
+
+
+/*
+ * init_incr() - initialize a repeat cycle's incremental processing
+ */
+
+static void
+init_incr()
+{
+	struct incrproc **t;
+
+	Ipc = Ipp = (struct incrproc *)NULL;
+	if (!RptTm) {
+	    Incr = 0;
+	    return;
+	}
+
+# if	defined(HASEPTOPTS)
+/*
+ * Endpoint information is gathered from all files as they are read, so
+ * don't reuse files when it has been requested.
+ */
+	if (FeptE) {
+	    Incr = 0;
+	    return;
+	}
+# endif	/* defined(HASEPTOPTS) */
+
+/*
+ * Descriptors are reused only if neither their offsets nor their flags,
+ * which come from /proc/<PID>/fdinfo, are to be reported.
+ */
+	Incr = 1;
+
+# if	!defined(HASNOFSFLAGS)
+	if (!Foffset && !(Fsv & FSV_FG))
+# else	/* defined(HASNOFSFLAGS) */
+	if (!Foffset)
+# endif	/* !defined(HASNOFSFLAGS) */
+
+	    Incr = 2;
+	if (!IncrN) {
+	    if (!(IncrN = (struct incrproc **)calloc(INCRBUCKS,
+						     sizeof(struct incrproc *)))
+	    ||  !(IncrP = (struct incrproc **)calloc(INCRBUCKS,
+						     sizeof(struct incrproc *))))
+	    {
+		(void) fprintf(stderr,
+		    "%s: no space for %d incremental repeat buckets\n",
+		    Pn, INCRBUCKS);
+		Exit(1);
+	    }
+	}
+/*
+ * The entries made in the last cycle become the previous ones.  The table
+ * they replace was emptied at the end of the last cycle.
+ */
+	t = IncrP;
+	IncrP = IncrN;
+	IncrN = t;
+}
+
+
+/*
+ * link_incrfile() - link the file at Lf, recording its signature
+ */
+
+static void
+link_incrfile(isg)
+	struct incrfile *isg;		/* signature (NULL if none) */
+{
+	MALLOC_S len;
+	struct lfile *pl = Plf;
+
+	if (Lf->sf)
+	    link_lfile();
+	if (!Incr || !isg || (Plf == pl))
+	    return;
+	if (Ipc->fn >= Ipc->fa) {
+	    Ipc->fa += INCRFINC;
+	    len = (MALLOC_S)(Ipc->fa * sizeof(struct incrfile));
+	    if (Ipc->f)
+		Ipc->f = (struct incrfile *)realloc((MALLOC_P *)Ipc->f, len);
+	    else
+		Ipc->f = (struct incrfile *)malloc(len);
+	    if (!Ipc->f) {
+		(void) fprintf(stderr,
+		    "%s: no space for %d file signatures, PID %d\n",
+		    Pn, Ipc->fa, Lp->pid);
+		Exit(1);
+	    }
+	}
+	Ipc->f[Ipc->fn] = *isg;
+	Ipc->f[Ipc->fn++].lf = Plf;
+}
+
+
+/*
+ * make_incrsig() - make a descriptor's file signature
+ */
+
+static void
+make_incrsig(isg, fd, lnk, sb, lsb)
+	struct incrfile *isg;		/* signature receiver */
+	int fd;				/* file descriptor number */
+	char *lnk;			/* /proc link text */
+	struct stat *sb;		/* stat(2) buffer */
+	struct stat *lsb;		/* lstat(2) buffer */
+{
+	isg->fd = fd;
+	isg->lh = hash_incr(lnk, INCRHINIT);
+	isg->dev = sb->st_dev;
+	isg->ino = (INODETYPE)sb->st_ino;
+	isg->size = sb->st_size;
+	isg->mode = sb->st_mode;
+	isg->lmode = lsb->st_mode;
+	isg->nlink = sb->st_nlink;
+	isg->ctm = sb->st_ctim.tv_sec;
+	isg->ctmn = sb->st_ctim.tv_nsec;
+	isg->lf = (struct lfile *)NULL;
+}
+
+
+/*
+ * reuse_incrfile() - reuse the previous cycle's file for a descriptor if its
+ *		      signature matches
+ *
+ * return: 1 = file reused and linked
+ *	   0 = file must be built
+ */
+
+static int
+reuse_incrfile(isg)
+	struct incrfile *isg;		/* current signature */
+{
+	struct incrfile *f;
+	int i, x;
+
+	if (!Ipp || !Ipp->fn)
+	    return(0);
+/*
+ * Descriptors are read in ascending order, as they were last cycle, so
+ * search from just past the last match.
+ */
+	for (i = 0, x = Ipp->fx; i < Ipp->fn; i++, x = (x + 1) % Ipp->fn) {
+	    if (Ipp->f[x].fd == isg->fd)
+		break;
+	}
+	if (i >= Ipp->fn)
+	    return(0);
+	Ipp->fx = (x + 1) % Ipp->fn;
+	f = &Ipp->f[x];
+	if (!f->lf
+	||  (f->lh != isg->lh)
+	||  (f->dev != isg->dev)
+	||  (f->ino != isg->ino)
+	||  (f->size != isg->size)
+	||  (f->mode != isg->mode)
+	||  (f->lmode != isg->lmode)
+	||  (f->nlink != isg->nlink)
+	||  (f->ctm != isg->ctm)
+	||  (f->ctmn != isg->ctmn))
+	    return(0);
+	(void) use_incrfile(f);
+	(void) link_incrfile(isg);
+	return(1);
+}
+
+
+/*
+ * reuse_incrmem() - reuse the previous cycle's memory-mapped files
+ */
+
+static void
+reuse_incrmem()
+{
+	struct incrfile *f, isg;
+	int i;
+
+	zeromem((char *)&isg, sizeof(isg));
+	isg.fd = INCRMEM;
+	for (i = 0, f = Ipp->f; i < Ipp->fn; i++, f++) {
+	    if ((f->fd != INCRMEM) || !f->lf)
+		continue;
+	    (void) alloc_lfile((char *)NULL, -1);
+	    (void) use_incrfile(f);
+	    (void) link_incrfile(&isg);
+	}
+}
+
+
+/*
+ * save_lproc() - save a process' files for the next repeat cycle
+ */
+
+void
+save_lproc(lp)
+	struct lproc *lp;		/* process */
+{
+	struct incrproc *ip;
+	int lpx;
+
+	if (!Incr || !IncrN)
+	    return;
+	lpx = (int)(lp - Lproc);
+	for (ip = IncrN[HASHINCR(lp->pid)]; ip; ip = ip->next) {
+	    if ((ip->pid == lp->pid) && (ip->lpx == lpx)) {
+		ip->file = lp->file;
+		ip->saved = 1;
+		if (!RptDelta) {
+		    ip->own = 1;
+		    lp->file = (struct lfile *)NULL;
+
+#if	defined(HASLPARENA)
+		    ip->arena = lp->arena;
+		    lp->arena = (struct lpachunk *)NULL;
+		    lp->cmd = (char *)NULL;
+
+# if	defined(HASTASKS)
+		    lp->tcmd = (char *)NULL;
+# endif	/* defined(HASTASKS) */
+#endif	/* defined(HASLPARENA) */
+
+		}
+		return;
+	    }
+	}
+}
+
+
+/*
+ * use_incrfile() - move a saved file's contents to Lf
+ */
+
+static void
+use_incrfile(f)
+	struct incrfile *f;		/* saved file's signature */
+{
+	struct lfile *lf = f->lf;
+
+	*Lf = *lf;
+
+#if	defined(HASLPARENA)
+/*
+ * The saved file's strings are in the previous cycle's arena, so copy them
+ * to this one, along with its cold record.  An interned name outlives both
+ * arenas and is shared.
+ */
+	if (lf->dev_ch)
+	    Lf->dev_ch = mkstrlpa(lf->dev_ch);
+
+# if	!defined(HASNMINTERN)
+	if (lf->nm)
+	    Lf->nm = mkstrlpa(lf->nm);
+# endif	/* !defined(HASNMINTERN) */
+
+	if (lf->nma)
+	    Lf->nma = mkstrlpa(lf->nma);
+
+# if	defined(HASLFILECOLD)
+	if (lf->cold != &Lfcold0)
+	    *alloc_lfcold(Lf) = *lf->cold;
+# endif	/* defined(HASLFILECOLD) */
+#else	/* !defined(HASLPARENA) */
+	if (Ipp->own)
+	    lf->dev_ch = lf->nm = lf->nma = (char *)NULL;
+	else {
+
+	/*
+	 * The saved file is still needed by repeat delta mode, so copy its
+	 * allocated strings.
+	 */
+	    if ((lf->dev_ch && !(Lf->dev_ch = mkstrcpy(lf->dev_ch, (MALLOC_S *)NULL)))
+	    ||  (lf->nm && !(Lf->nm = mkstrcpy(lf->nm, (MALLOC_S *)NULL)))
+	    ||  (lf->nma && !(Lf->nma = mkstrcpy(lf->nma, (MALLOC_S *)NULL))))
+	    {
+		(void) fprintf(stderr, "%s: no space for reused file strings\n",
+		    Pn);
+		Exit(1);
+	    }
+	}
+#endif	/* defined(HASLPARENA) */
+
+	f->lf = Lf->next = (struct lfile *)NULL;
+/*
+ * Locks come and go without changing the signature, so check again.
+ */
+	Lf->lock = ' ';
+	if (Lf->dev_def && (Lf->inp_ty == 1)) {
+	    (void) check_lock();
+	    if (f->fd >= 0)
+		(void) check_ofd_lock(f->fd);
+	}
+}
+#endif	/* defined(HASRPTINCR) */
+
+
+#if	defined(HASPROCEVT)
+/*
+ * clr_pev() - clear the process event PID table
+ */
+
+static void
+clr_pev()
+{
+	int h;
+	struct pevproc *pp, *nx;
+
+	for (h = 0; h < PEVBUCKS; h++) {
+	    for (pp = PevH[h]; pp; pp = nx) {
+		nx = pp->next;
+		(void) free((FREE_P *)pp);
+	    }
+	    PevH[h] = (struct pevproc *)NULL;
+	}
+}
+
+
+/*
+ * drop_pev() - drop an exited process from the process event PID table
+ */
+
+static void
+drop_pev(pid)
+	int pid;			/* process ID */
+{
+	struct pevproc *pp, **ppp;
+
+	if (!PevH)
+	    return;
+	for (ppp = &PevH[HASHPEV(pid)]; (pp = *ppp); ppp = &pp->next) {
+	    if (pp->pid == pid) {
+		*ppp = pp->next;
+		(void) free((FREE_P *)pp);
+		return;
+	    }
+	}
+}
+
+
+/*
+ * enter_pev() - enter a process in the process event PID table
+ *
+ * return: the process' entry, or NULL if there's no table yet
+ */
+
+static struct pevproc *
+enter_pev(pid)
+	int pid;			/* process ID */
+{
+	int h;
+	struct pevproc *pp;
+
+	if (!PevH)
+	    return((struct pevproc *)NULL);
+	h = HASHPEV(pid);
+	for (pp = PevH[h]; pp; pp = pp->next) {
+	    if (pp->pid == pid)
+		return(pp);
+	}
+	if (!(pp = (struct pevproc *)malloc(sizeof(struct pevproc)))) {
+	    (void) fprintf(stderr, "%s: no space for process event PID %d\n",
+		Pn, pid);
+	    Exit(1);
+	}
+	pp->pid = pid;
+	pp->excl = 0;
+	pp->next = PevH[h];
+	PevH[h] = pp;
+	return(pp);
+}
+
+
+/*
+ * init_pev() - prepare process events for a repeat cycle
  */
 
-static int
-isefsys(path, type, l, rep, lfr)
-	char *path;			/* path to file */
-	char *type;			/* unknown file type */
-	int l;				/* link request: 0 = report
-					 *               1 = link */
-	efsys_list_t **rep;		/* returned Efsysl pointer, if not
-					 * NULL */
-	struct lfile **lfr;		/* allocated struct lfile pointer */
+static void
+init_pev()
 {
-	efsys_list_t *ep;
-	int ds, len;
-	struct mounts *mp;
-	char nmabuf[MAXPATHLEN + 1];
+	int h;
+	MALLOC_S len;
+	struct pevproc *pp;
 
-	len = (int) strlen(path);
-	for (ep = Efsysl; ep; ep = ep->next) {
+	if (!RptPev || (Pev < 0))
+	    return;
+
+#if	defined(HASCGROUP)
+/*
+ * Visiting only the PIDs of the selected cgroups already avoids reading
+ * /proc.
+ */
+	if (Cgwalk) {
+	    Pev = -1;
+	    return;
+	}
+#endif	/* defined(HASCGROUP) */
+
+	if (!Pev) {
 
 	/*
-	 * Look for a matching exempt file system path at the beginning of
-	 * the file path.
+	 * Subscribe to process events before the first /proc walk, so no
+	 * change after it is missed.
 	 */
-	    if (ep->pathl > len)
-		continue;
-	    if (strncmp(ep->path, path, ep->pathl))
-		continue;
+	    if (open_pev()) {
+		if (!Fwarn)
+		    (void) fprintf(stderr,
+			"%s: WARNING: no process events; reading %s each cycle\n",
+			Pn, PROCFS);
+		Pev = -1;
+		return;
+	    }
+	    if (!(PevH = (struct pevproc **)calloc(PEVBUCKS,
+						   sizeof(struct pevproc *))))
+	    {
+		(void) fprintf(stderr, "%s: no space for process event table\n",
+		    Pn);
+		Exit(1);
+	    }
 	/*
-	 * If only reporting, return information as requested.
+	 * An excluded process can be skipped until its next event, unless
+	 * it can change in a way that produces no event -- its process group,
+	 * security context or cgroup -- or its tasks are being listed.
+	 * Endpoint processing needs every process.
 	 */
-	    if (!l) {
-		if (rep)
-		    *rep = ep;
-		return(0);
-	    }
+	    Pevsk = (!FeptE && !Npgid && !(Selflags & SELTASK)) ? 1 : 0;
+
+#if	defined(HASSELINUX)
+	    if (CntxArg)
+		Pevsk = 0;
+#endif	/* defined(HASSELINUX) */
+
+#if	defined(HASCGROUP)
+	    if (CgrpArg)
+		Pevsk = 0;
+#endif	/* defined(HASCGROUP) */
+
+	    Pev = 1;
+	    return;
+	}
+	if (read_pev(0) < 0) {
+
 	/*
-	 * Process an exempt file.
+	 * Events were lost, so rebuild the table from /proc.
 	 */
-	    ds = 0;
-	    if ((mp = ep->mp)) {
-		if (mp->ds & SB_DEV) {
-		    Lf->dev = mp->dev;
-		    ds = Lf->dev_def = 1;
-		}
-		if (mp->ds & SB_RDEV) {
-		    Lf->rdev = mp->rdev;
-		    ds = Lf->rdev_def = 1;
+	    (void) clr_pev();
+	    Pev = 1;
+	    return;
+	}
+	if (Pev != 2)
+	    return;
+/*
+ * List the PIDs to visit.
+ */
+	for (h = Pevvn = 0; h < PEVBUCKS; h++) {
+	    for (pp = PevH[h]; pp; pp = pp->next) {
+		if (pp->excl)
+		    continue;
+		if (Pevvn >= Pevva) {
+		    Pevva += PEVVINC;
+		    len = (MALLOC_S)(Pevva * sizeof(int));
+		    if (Pevv)
+			Pevv = (int *)realloc((MALLOC_P *)Pevv, len);
+		    else
+			Pevv = (int *)malloc(len);
+		    if (!Pevv) {
+			(void) fprintf(stderr,
+			    "%s: no space for %d process event PIDs\n",
+			    Pn, Pevva);
+			Exit(1);
+		    }
 		}
+		Pevv[Pevvn++] = pp->pid;
 	    }
-	    if (!ds)
-		(void) enter_dev_ch("UNKNOWN");
-	    Lf->ntype = N_UNKN;
-	    (void) snpf(Lf->type, sizeof(Lf->type), "%s",
-			(type ? type : "UNKN"));
-	    (void) enter_nm(path);
-	    (void) snpf(nmabuf, sizeof(nmabuf), "(%ce %s)",
-		ep->rdlnk ? '+' : '-', ep->path);
-	    nmabuf[sizeof(nmabuf) - 1] = '\0';
-	    (void) add_nma(nmabuf, strlen(nmabuf));
-	    if (Lf->sf) {
-		if (lfr)
-		    *lfr = Lf;
-		link_lfile();
-	    } else if (lfr)
-		*lfr = (struct lfile *)NULL;
-	    return(0);
 	}
-	return(1);
 }
 
 
 /*
- * nm2id() - convert a name to an integer ID
+ * open_pev() - open and test the process event socket
+ *
+ * return: 0 = events are available
+ *	   1 = they aren't
  */
 
 static int
-nm2id(nm, id, idl)
-	char *nm;			/* pointer to name */
-	int *id;			/* pointer to ID receiver */
-	int *idl;			/* pointer to ID length receiver */
+open_pev()
 {
-	register int tid, tidl;
-
-	for (*id = *idl = tid = tidl = 0; *nm; nm++) {
+	union {
+	    struct nlmsghdr nh;
+	    char b[NLMSG_SPACE(sizeof(struct cn_msg)
+			       + sizeof(enum proc_cn_mcast_op))];
+	} m;
+	struct cn_msg *cn;
+	enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+	struct sockaddr_nl sa;
+	pid_t tp;
+
+	if ((Pevs = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC,
+			   NETLINK_CONNECTOR))
+	< 0)
+	    return(1);
+	zeromem((char *)&sa, sizeof(sa));
+	sa.nl_family = AF_NETLINK;
+	sa.nl_groups = CN_IDX_PROC;
+	if (bind(Pevs, (struct sockaddr *)&sa, sizeof(sa)))
+	    goto open_pev_fail;
+	zeromem((char *)&m, sizeof(m));
+	m.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+	m.nh.nlmsg_type = NLMSG_DONE;
+	cn = (struct cn_msg *)NLMSG_DATA(&m.nh);
+	cn->id.idx = CN_IDX_PROC;
+	cn->id.val = CN_VAL_PROC;
+	cn->len = sizeof(op);
+	(void) memcpy((void *)cn->data, (void *)&op, sizeof(op));
+	if (send(Pevs, (void *)&m, m.nh.nlmsg_len, 0) < 0)
+	    goto open_pev_fail;
+/*
+ * The subscription can succeed without events being delivered -- e.g., in
+ * a network namespace other than the initial one -- and the events report
+ * the PIDs of the initial PID namespace.  So make sure the fork of a child
+ * is reported with the PID lsof sees.
+ */
+	if ((tp = fork()) < 0)
+	    goto open_pev_fail;
+	if (!tp)
+	    _exit(0);
+	(void) waitpid(tp, (int *)NULL, 0);
+	if (read_pev((int)tp) == 1)
+	    return(0);
 
-#if	defined(__STDC__)	/* { */
-	    if (!isdigit((unsigned char)*nm))
-#else	/* !defined(__STDC__)	   } { */
-	    if (!isascii(*nm) || !isdigit((unsigned char)*cp))
-#endif	/* defined(__STDC__)	   } */
+open_pev_fail:
 
-		{
-		    return(1);
-		}
-		tid = tid * 10 + (int)(*nm - '0');
-		tidl++;
-	}
-	*id = tid;
-	*idl = tidl;
-	return(0);
+	(void) close(Pevs);
+	Pevs = -1;
+	return(1);
 }
 
 
 /*
- * open_proc_stream() -- open a /proc stream
+ * read_pev() - read the pending process events
+ *
+ * return: -1 = events were lost
+ *	    0 = all pending events have been read
+ *	    1 = the fork of the subscription test child was found
  */
 
-FILE *
-open_proc_stream(p, m, buf, sz, act)
-	char *p;			/* pointer to path to open */
-	char *m;			/* pointer to mode -- e.g., "r" */
-	char **buf;			/* pointer tp setvbuf() address
-					 * (NULL if none) */
-	size_t *sz;			/* setvbuf() size (0 if none or if
-					 * getpagesize() desired */
-	int act;			/* fopen() failure action:
-					 *     0 : return (FILE *)NULL
-					 *   <>0 : fprintf() an error message
-					 *         and Exit(1)
-					 */
+static int
+read_pev(tpid)
+	int tpid;			/* subscription test child PID; 0 if
+					 * not testing */
 {
-	FILE *fs;			/* opened stream */
-	static size_t psz = (size_t)0;	/* page size */
-	size_t tsz;			/* temporary size */
-/*
- * Open the stream.
- */
-	if (!(fs = fopen(p, m))) {
-	    if (!act)
-		return((FILE *)NULL);
-	    (void) fprintf(stderr, "%s: can't fopen(%s, \"%s\"): %s\n",
-		Pn, p, m, strerror(errno));
-	    Exit(1);
-	}
-/*
- * Return the stream if no buffer change is required.
- */
-	if (!buf)
-	    return(fs);
-/*
- * Determine the buffer size required.
- */
-	if (!(tsz = *sz)) {
-	    if (!psz)
-		psz = getpagesize();
-	    tsz = psz;
-	}
-/*
- * Allocate a buffer for the stream, as required.
- */
-	if (!*buf) {
-	    if (!(*buf = (char *)malloc((MALLOC_S)tsz))) {
-		(void) fprintf(stderr,
-		    "%s: can't allocate %d bytes for %s stream buffer\n",
-		    Pn, (int)tsz, p);
-		Exit(1);
+	union {
+	    struct nlmsghdr nh;
+	    char b[PEVBUFL];
+	} m;
+	struct cn_msg *cn;
+	struct timespec dl, now;
+	struct proc_event *ev;
+	struct nlmsghdr *nh;
+	int n, pid, tmo;
+	struct pevproc *pp;
+	struct pollfd pf;
+
+	if (tpid) {
+	    (void) clock_gettime(CLOCK_MONOTONIC, &dl);
+	    dl.tv_sec += PEVWAIT / 1000;
+	    dl.tv_nsec += (long)(PEVWAIT % 1000) * 1000000L;
+	    if (dl.tv_nsec >= 1000000000L) {
+		dl.tv_sec++;
+		dl.tv_nsec -= 1000000000L;
 	    }
-	    *sz = tsz;
 	}
-/*
- * Assign the buffer to the stream.
- */
-	if (setvbuf(fs, *buf, _IOFBF, tsz)) {
-	    (void) fprintf(stderr, "%s: setvbuf(%s)=%d failure: %s\n",
-		Pn, p, (int)tsz, strerror(errno));
-	    Exit(1);
+	for (;;) {
+	    if (tpid) {
+
+	    /*
+	     * Wait for the test child's event until the deadline.
+	     */
+		(void) clock_gettime(CLOCK_MONOTONIC, &now);
+		tmo = (int)((dl.tv_sec - now.tv_sec) * 1000
+		    +	    (dl.tv_nsec - now.tv_nsec) / 1000000L);
+		if (tmo <= 0)
+		    return(0);
+		pf.fd = Pevs;
+		pf.events = POLLIN;
+		pf.revents = 0;
+		if ((n = poll(&pf, 1, tmo)) < 0) {
+		    if (errno == EINTR)
+			continue;
+		    return(0);
+		}
+		if (!n)
+		    return(0);
+	    }
+	    if ((n = (int)recv(Pevs, (void *)&m, sizeof(m), MSG_DONTWAIT)) < 0)
+	    {
+		if (errno == EINTR)
+		    continue;
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+		    return(0);
+		return(-1);
+	    }
+	    for (nh = &m.nh; NLMSG_OK(nh, n); nh = NLMSG_NEXT(nh, n)) {
+		if (nh->nlmsg_type == NLMSG_NOOP)
+		    continue;
+		if ((nh->nlmsg_type == NLMSG_ERROR)
+		||  (nh->nlmsg_type == NLMSG_OVERRUN))
+		    return(-1);
+		cn = (struct cn_msg *)NLMSG_DATA(nh);
+		if ((cn->id.idx != CN_IDX_PROC) || (cn->id.val != CN_VAL_PROC))
+		    continue;
+		ev = (struct proc_event *)cn->data;
+		switch (ev->what) {
+		case PROC_EVENT_FORK:
+		    if (tpid && (ev->event_data.fork.child_pid == tpid))
+			return(1);
+		/*
+		 * A new thread doesn't change its process' selection.
+		 */
+		    if (ev->event_data.fork.child_pid
+		    !=  ev->event_data.fork.child_tgid)
+			continue;
+		    pid = ev->event_data.fork.child_tgid;
+		    break;
+		case PROC_EVENT_EXEC:
+		    pid = ev->event_data.exec.process_tgid;
+		    break;
+		case PROC_EVENT_UID:
+		case PROC_EVENT_GID:
+		    pid = ev->event_data.id.process_tgid;
+		    break;
+		case PROC_EVENT_SID:
+		    pid = ev->event_data.sid.process_tgid;
+		    break;
+		case PROC_EVENT_COMM:
+		    pid = ev->event_data.comm.process_tgid;
+		    break;
+		case PROC_EVENT_EXIT:
+		    if (ev->event_data.exit.process_pid
+		    ==  ev->event_data.exit.process_tgid)
+			(void) drop_pev(ev->event_data.exit.process_tgid);
+		    continue;
+		default:
+		    continue;
+		}
+	    /*
+	     * Make sure the process is visited in the next cycle.
+	     */
+		if ((pp = enter_pev(pid)))
+		    pp->excl = 0;
+	    }
 	}
-	return(fs);
 }
+#endif	/* defined(HASPROCEVT) */
 
 
 /*
@@ -928,7 +2348,7 @@ open_proc_stream(p, m, buf, sz, act)
  */
 
 static int
-process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
+process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd, stm)
 	char *idp;			/* pointer to ID's path */
 	int idpl;			/* pointer to ID's path length */
 	char *cmd;			/* pointer to ID's command */
@@ -938,11 +2358,13 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 	int pgid;			/* parent GID */
 	int tid;			/* task ID, if non-zero */
 	char *tcmd;			/* task command, if non-NULL) */
+	unsigned long long stm;		/* ID's start time */
 {
 	int av = 0;
 	static char *dpath = (char *)NULL;
 	static int dpathl = 0;
 	short efs, enls, enss, lnk, oty, pn, pss, sf;
+	int csf = 0;
 	int fd, i, ls, n, ss, sv;
 	struct l_fdinfo fi;
 	DIR *fdp;
@@ -960,6 +2382,10 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 	char *rest;
 	int txts = 0;
 
+#if	defined(HASRPTINCR)
+	struct incrfile isg, *isgp;
+#endif	/* defined(HASRPTINCR) */
+
 #if	defined(HASSELINUX)
 	cntxlist_t *cntxp;
 #endif	/* defined(HASSELINUX) */
@@ -968,8 +2394,17 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
  * See if process is excluded.
  */
 	if (is_proc_excl(pid, pgid, uid, &pss, &sf, tid)
-	||  is_cmd_excl(cmd, &pss, &sf))
-	{
+	||  is_cmd_excl(cmd, &pss, &sf)
+
+#if	defined(HASCGROUP)
+	||  is_cgrp_excl(pid, &pss, &csf)
+#endif	/* defined(HASCGROUP) */
+
+	) {
+
+#if	defined(HASPROCEVT)
+	    Pevx = 1;
+#endif	/* defined(HASPROCEVT) */
 
 #if	defined(HASEPTOPTS)
 	    if (!FeptE)
@@ -986,17 +2421,29 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 	 * socket file only checking, based on the process' selection
 	 * status.
 	 */
-	    Ckscko = (sf & SelProc) ? 0 : 1;
+	    Ckscko = ((sf | csf) & SelProc) ? 0 : 1;
 	}
-	alloc_lproc(pid, pgid, ppid, uid, cmd, (int)pss, (int)sf);
+	alloc_lproc(pid, pgid, ppid, uid, cmd, (int)pss, (int)sf | csf);
 	Plf = (struct lfile *)NULL;
 
+#if	defined(HASRPTINCR)
+/*
+ * Find the files saved for this ID in the previous repeat cycle.
+ */
+	if (Incr)
+	    (void) enter_incrproc(pid, tid, stm);
+#endif	/* defined(HASRPTINCR) */
+
 #if	defined(HASTASKS)
 /*
  * Enter task information.
  */
 	Lp->tid = tid;
 	if (tid && tcmd) {
+
+# if	defined(HASLPARENA)
+	    Lp->tcmd = mkstrlpa(tcmd);
+# else	/* !defined(HASLPARENA) */
 	    if (!(Lp->tcmd = mkstrcpy(tcmd, (MALLOC_S *)NULL))) {
 		(void) fprintf(stderr,
 		    "%s: PID %d, TID %d, no space for task name: ",
@@ -1004,6 +2451,8 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		safestrprt(tcmd, stderr, 1);
 		Exit(1);
 	    }
+# endif	/* defined(HASLPARENA) */
+
 	}
 #endif	/* defined(HASTASKS) */
 
@@ -1033,7 +2482,7 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		} else {
 		    ss = SB_ALL;
 		    if (HasNFS) {
-			if ((sv = statsafely(path, &sb)))
+			if ((sv = safestat(path, pbuf, &sb, 0)))
 			sv = statEx(pbuf, &sb, &ss);
 		    } else
 			sv = stat(path, &sb);
@@ -1080,7 +2529,7 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		else {
 		    ss = SB_ALL;
 		    if (HasNFS) {
-			if ((sv = statsafely(path, &sb)))
+			if ((sv = safestat(path, pbuf, &sb, 0)))
 			    sv = statEx(pbuf, &sb, &ss);
 		    } else
 			sv = stat(path, &sb);
@@ -1129,7 +2578,7 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		else {
 		    ss = SB_ALL;
 		    if (HasNFS) {
-			if ((sv = statsafely(path, &sb))) {
+			if ((sv = safestat(path, pbuf, &sb, 0))) {
 			    sv = statEx(pbuf, &sb,  &ss);
 			    if (!sv && (ss & SB_DEV) && (ss & SB_INO))
 				txts = 1;
@@ -1232,6 +2681,11 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		continue;
 	    (void) make_proc_path(dpath, i, &path, &pathl, fp->d_name);
 	    (void) alloc_lfile((char *)NULL, fd);
+
+#if	defined(HASRPTINCR)
+	    isgp = (struct incrfile *)NULL;
+#endif	/* defined(HASRPTINCR) */
+
 	    if (getlinksrc(path, pbuf, sizeof(pbuf), &rest) < 1) {
 		zeromem((char *)&sb, sizeof(sb));
 		lnk = ss = 0;
@@ -1251,14 +2705,14 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		    pn = 0;
 		} else {
 		    if (HasNFS) {
-			if (lstatsafely(path, &lsb)) {
+			if (safestat(path, pbuf, &lsb, 1)) {
 			    (void) statEx(pbuf, &lsb, &ls);
 			    enls = errno;
 			} else {
 			    enls = 0;
 			    ls = SB_ALL;
 			}
-			if (statsafely(path, &sb)) {
+			if (safestat(path, pbuf, &sb, 0)) {
 			    (void) statEx(pbuf, &sb, &ss);
 			    enss = errno;
 			} else {
@@ -1292,6 +2746,33 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 			    pn = 0;
 		    } else
 			pn = 1;
+
+#if	defined(HASRPTINCR)
+		/*
+		 * If the descriptor is a regular file or directory whose link
+		 * and stat(2) results match those from which the previous
+		 * cycle built its file, reuse that file.  Neither the offset
+		 * nor the flags are shown for it, so its fdinfo needn't be
+		 * read.
+		 *
+		 * The readlink(2), lstat(2) and stat(2) calls can't be skipped
+		 * for the whole process: /proc has no cheaper sign that its
+		 * descriptors are unchanged.  The descriptor count and the
+		 * start time, for example, miss a dup2(2) over a descriptor
+		 * and a file that has grown.
+		 */
+		    if (pn && (Incr > 1)
+		    &&  (ls == SB_ALL) && (ss == SB_ALL) && (*pbuf == '/')
+		    &&  (((sb.st_mode & S_IFMT) == S_IFREG)
+		    ||   ((sb.st_mode & S_IFMT) == S_IFDIR)))
+		    {
+			(void) make_incrsig(&isg, fd, pbuf, &sb, &lsb);
+			isgp = &isg;
+			if (reuse_incrfile(isgp))
+			    continue;
+		    }
+#endif	/* defined(HASRPTINCR) */
+
 		}
 	    }
 	    if (pn || (efs && lfr && oty)) {
@@ -1347,6 +2828,7 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 		if (pn) {
 		    process_proc_node(lnk ? pbuf : path, path, &sb, ss, &lsb,
 				      ls);
+		    (void) check_ofd_lock(fd);
 		    if (Lf->ntype == N_ANON_INODE) {
 			if (rest && *rest) {
 #if	defined(HASEPTOPTS)
@@ -1374,7 +2856,7 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 #if	defined(HASEPTOPTS)
 			if (FeptE && fi.eventfd_id != -1) {
 			    enter_evtfdinfo(fi.eventfd_id);
-			    Lf->eventfd_id = fi.eventfd_id;
+			    LFCOLDW(Lf)->eventfd_id = fi.eventfd_id;
 			    Lf->sf |= SELEVTFDINFO;
 			}
 #endif	/* defined(HASPTYEPT) */
@@ -1386,13 +2868,18 @@ process_id(idp, idpl, cmd, uid, pid, ppid, pgid, tid, tcmd)
 			 &&  (av & FDINFO_TTY_INDEX)
 		    ) {
 			    enter_ptmxi(fi.tty_index);
-			    Lf->tty_index = fi.tty_index;
+			    LFCOLDW(Lf)->tty_index = fi.tty_index;
 			    Lf->sf |= SELPTYINFO;
 		    }
 #endif	/* defined(HASEPTOPTS) && defined(HASPTYEPT) */
 
+#if	defined(HASRPTINCR)
+		    (void) link_incrfile(isgp);
+#else	/* !defined(HASRPTINCR) */
 		    if (Lf->sf)
 			link_lfile();
+#endif	/* defined(HASRPTINCR) */
+
 		}
 	    }
 	}
@@ -1430,12 +2917,42 @@ process_proc_map(p, s, ss)
 	static int sma = 0;
 	static char *vbuf = (char *)NULL;
 	static size_t vsz = (size_t)0;
+
+#if	defined(HASRPTINCR)
+	struct incrfile isg;
+	unsigned long long msum;
+#endif	/* defined(HASRPTINCR) */
+
 /*
  * Open the /proc/<pid>/maps file, assign a page size buffer to its stream,
  * and read it/
  */
 	if (!(ms = open_proc_stream(p, "r", &vbuf, &vsz, 0)))
 	    return;
+
+#if	defined(HASRPTINCR)
+/*
+ * In incremental repeat mode checksum the maps file.  If the checksum
+ * matches the previous cycle's, reuse that cycle's memory-mapped files
+ * rather than stat(2) them all again; otherwise reread the file.
+ */
+	if (Incr) {
+	    for (msum = INCRHINIT; fgets(buf, sizeof(buf), ms);) {
+		msum = hash_incr(buf, msum);
+	    }
+	    Ipc->msum = msum;
+	    Ipc->msd = 1;
+	    if (Ipp && Ipp->msd && (Ipp->msum == msum)) {
+		(void) fclose(ms);
+		(void) reuse_incrmem();
+		return;
+	    }
+	    rewind(ms);
+	}
+	zeromem((char *)&isg, sizeof(isg));
+	isg.fd = INCRMEM;
+#endif	/* defined(HASRPTINCR) */
+
 	while (fgets(buf, sizeof(buf), ms)) {
 	    if ((nf = get_fields(buf, ":", &fp, &eb, 1)) < 7)
 		continue;			/* not enough fields */
@@ -1525,7 +3042,7 @@ process_proc_map(p, s, ss)
 		efs = 0;
 	    if (!efs) {
 		if (HasNFS)
-		    sv = statsafely(fp[6], &sb);
+		    sv = safestat(fp[6], fp[6], &sb, 0);
 		else
 		    sv = stat(fp[6], &sb);
 	    }
@@ -1619,8 +3136,14 @@ process_proc_map(p, s, ss)
 		nmabuf[sizeof(nmabuf) - 1] = '\0';
 		(void) add_nma(nmabuf, strlen(nmabuf));
 	    }
+
+#if	defined(HASRPTINCR)
+	    (void) link_incrfile(&isg);
+#else	/* !defined(HASRPTINCR) */
 	    if (Lf->sf)
 		link_lfile();
+#endif	/* defined(HASRPTINCR) */
+
 	}
 	(void) fclose(ms);
 }
@@ -1636,13 +3159,15 @@ process_proc_map(p, s, ss)
  */
 
 static int
-read_id_stat(p, id, cmd, ppid, pgid)
+read_id_stat(p, id, cmd, ppid, pgid, stm)
 	char *p;			/* path to status file */
 	int id;				/* ID: PID or LWP */
 	char **cmd;			/* malloc'd command name */
 	int *ppid;			/* returned parent PID for PID type */
 	int *pgid;			/* returned process group ID for PID
 					 * type */
+	unsigned long long *stm;	/* returned start time (0 if
+					 * unavailable) */
 {
 	char buf[MAXPATHLEN], *cp, *cp1, **fp;
 	int ch, cx, es, nf, pc;
@@ -1747,6 +3272,14 @@ read_id_stat_exit:
 	    *pgid = atoi(fp[2]);
 	else
 	    return(-1);
+/*
+ * Convert and return the start time (twenty-second field).  It identifies
+ * an instance of a PID across repeat cycles.
+ */
+	if ((nf > 19) && fp[19] && *fp[19])
+	    *stm = strtoull(fp[19], (char **)NULL, 10);
+	else
+	    *stm = 0;
 /*
  * Check the state in the third field.  If it is 'Z', return that indication.
  */
@@ -1758,6 +3291,37 @@ read_id_stat_exit:
 }
 
 
+/*
+ * safestat() - stat(2) or lstat(2) a file safely, quarantining its file
+ *		system when that times out
+ *
+ * A file on a quarantined file system isn't examined; the call fails at once
+ * with ETIMEDOUT.
+ */
+
+static int
+safestat(path, tp, s, l)
+	char *path;			/* path to stat(2) -- e.g., a /proc link */
+	char *tp;			/* the file's path */
+	struct stat *s;			/* stat(2) result */
+	int l;				/* 1 = lstat(2) */
+{
+	int rv;
+
+	if (is_hungfs(tp)) {
+	    errno = ETIMEDOUT;
+	    return(1);
+	}
+	if ((rv = l ? lstatsafely(path, s) : statsafely(path, s))
+	&&  (errno == ETIMEDOUT))
+	{
+	    (void) enter_hungfs(tp);
+	    errno = ETIMEDOUT;
+	}
+	return(rv);
+}
+
+
 /*
  * statEx() - extended stat() to get device numbers when a "safe" stat has
  *	      failed and the system has an NFS mount
@@ -1781,10 +3345,27 @@ statEx(p, s, ss)
 	static size_t ca = 0;
 	static char *cb = NULL;
 	char *cp;
+	efsys_list_t *ep;
 	int ensv = ENOENT;
 	struct stat sb;
 	int st = 0;
 	size_t sz;
+/*
+ * Don't examine a path on a quarantined file system; report the device number
+ * of its mount, if known.
+ */
+	if ((ep = is_hungfs(p))) {
+	    zeromem((char *)s, sizeof(struct stat));
+	    if (ep->mp && (ep->mp->ds & SB_DEV)) {
+		s->st_dev = ep->mp->dev;
+		*ss = SB_DEV;
+		errno = 0;
+		return(0);
+	    }
+	    *ss = 0;
+	    errno = ETIMEDOUT;
+	    return(1);
+	}
 /*
  * Make a copy of the path.
  */
@@ -1810,7 +3391,7 @@ statEx(p, s, ss)
  */
 	for (cp = strrchr(cb, '/'); cp && (cp != cb);) {
 	    *cp = '\0';
-	    if (!statsafely(cb, &sb)) {
+	    if (!safestat(cb, cb, &sb, 0)) {
 		st = 1;
 		break;
 	    }
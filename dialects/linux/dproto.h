@@ -41,9 +41,26 @@
 _PROTOTYPE(extern int enter_cntx_arg,(char *cnxt));
 #endif	/* defined(HASSELINUX) */
 
+#if	defined(HASCGROUP)
+_PROTOTYPE(extern int enter_cgrp_arg,(char *cg, int r));
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASMNTNS)
+_PROTOTYPE(extern void clr_mntns,(void));
+#endif	/* defined(HASMNTNS) */
+
+_PROTOTYPE(extern void check_lock,(void));
+_PROTOTYPE(extern void check_ofd_lock,(int fd));
+_PROTOTYPE(extern struct mounts *find_mntpath,(char *p));
+_PROTOTYPE(extern struct mounts *find_nfsmnt,(dev_t dev, char *p));
 _PROTOTYPE(extern int get_fields,(char *ln, char *sep, char ***fr, int *eb, int en));
 _PROTOTYPE(extern void get_locks,(char *p));
 _PROTOTYPE(extern int is_file_named,(int ty, char *p, struct mounts *mp, int cd));
+
+#if	defined(HASDIRPFX)
+_PROTOTYPE(extern int is_file_pfx,(char *p, dev_t dev, int dd));
+#endif	/* defined(HASDIRPFX) */
+
 _PROTOTYPE(extern int make_proc_path,(char *pp, int lp, char **np, int *npl, char *sf));
 _PROTOTYPE(extern FILE *open_proc_stream,(char *p, char *mode, char **buf, size_t *sz, int act));
 _PROTOTYPE(extern void process_proc_node,(char *p, char *pbr, struct stat *s, int ss, struct stat *l, int ls));
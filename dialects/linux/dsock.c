@@ -1292,9 +1292,9 @@ prt_uxs(p, mk)
 
 
 /*
- * process_uxsinfo() -- process UNIX socket information, adding it to selected
- *			UNIX socket files and selecting UNIX socket end point
- *			files (if requested)
+ * process_uxsinfo() -- process the UNIX socket information of the file at Lf,
+ *			adding it to the file if selected, or selecting the
+ *			file if it's a UNIX socket end point (if requested)
  */
 
 void
@@ -1309,76 +1309,74 @@ process_uxsinfo(f)
 
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if (strcmp(Lf->type, "unix"))
-		continue;
-	    switch (f) {
-	    case 0:
+	if (strcmp(Lf->type, "unix"))
+	    return;
+	switch (f) {
+	case 0:
+
+	/*
+	 * Process already selected socket.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 
 	    /*
-	     * Process already selected socket.
+	     * This file has been selected by some criterion other than its
+	     * being a socket.  Look up the socket's endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
-
-		/*
-		 * This file has been selected by some criterion other than its
-		 * being a socket.  Look up the socket's endpoints.
-		 */
-		    p = find_uxepti(Lf);
-		    if (p && p->inode)
-			prt_uxs(p, 1);
-		    if ((tp = check_unix(Lf->inode))) {
-			if (tp->icons) {
-			    if (tp->icstat) {
-				p = tp->icons;
-				while (p && p != tp) {
-				    if (p->inode)
-					prt_uxs(p, 1);
-				    p = p->icons;
-				}
-			    } else {
-				for (p = tp->icons; p && !p->icstat; p = p->icons)
-				    ; /* DO NOTHING */
-				if (p && p->inode)
-				    prt_uxs (p, 1);
+		p = find_uxepti(Lf);
+		if (p && p->inode)
+		    prt_uxs(p, 1);
+		if ((tp = check_unix(Lf->inode))) {
+		    if (tp->icons) {
+			if (tp->icstat) {
+			    p = tp->icons;
+			    while (p && p != tp) {
+				if (p->inode)
+				    prt_uxs(p, 1);
+				p = p->icons;
 			    }
+			} else {
+			    for (p = tp->icons; p && !p->icstat; p = p->icons)
+				; /* DO NOTHING */
+			    if (p && p->inode)
+				prt_uxs (p, 1);
 			}
 		    }
 		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_UXS)) {
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_UXS)) {
 
-		/*
-		 * This is an unselected end point UNIX socket file.  Select it
-		 * and add its end point information to peer's name column
-		 * addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    p = find_uxepti(Lf);
-		    if (p && p->inode)
-			prt_uxs(p, 0);
-		    else if ((tp = check_unix(Lf->inode))) {
-			if (tp->icons) {
-			    if (tp->icstat) {
-				p = tp->icons;
-				while (p && p != tp) {
-				    if (p->inode)
-					prt_uxs(p, 0);
-				    p = p->icons;
-				}
-			    } else {
-				for (p = tp->icons; p && !p->icstat; p = p->icons)
-				    ; /* DO NOTHING */
-				if (p && p->inode)
+	    /*
+	     * This is an unselected end point UNIX socket file.  Select it
+	     * and add its end point information to peer's name column
+	     * addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		p = find_uxepti(Lf);
+		if (p && p->inode)
+		    prt_uxs(p, 0);
+		else if ((tp = check_unix(Lf->inode))) {
+		    if (tp->icons) {
+			if (tp->icstat) {
+			    p = tp->icons;
+			    while (p && p != tp) {
+				if (p->inode)
 				    prt_uxs(p, 0);
+				p = p->icons;
 			    }
+			} else {
+			    for (p = tp->icons; p && !p->icstat; p = p->icons)
+				; /* DO NOTHING */
+			    if (p && p->inode)
+				prt_uxs(p, 0);
 			}
 		    }
 		}
-		break;
 	    }
+	    break;
 	}
 }
 #endif	/* defined(HASEPTOPTS) && defined(HASUXSOCKEPT) */
@@ -1553,9 +1551,10 @@ prt_nets(p, mk)
 }
 
 /*
- * process_netsinfo() -- process locally used INET socket information, adding
- *			it to selected INET socket files and selecting INET
- *			socket end point files (if requested)
+ * process_netsinfo() -- process the locally used INET socket information of
+ *			 the file at Lf, adding it to the file if selected,
+ *			 or selecting the file if it's an INET socket end
+ *			 point (if requested)
  */
 
 void
@@ -1570,48 +1569,46 @@ process_netsinfo(f)
 
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if (strcmp(Lf->type,
+	if (strcmp(Lf->type,
 #if	defined(HASIPv6)
-		       "IPv4"
+		   "IPv4"
 #else	/* !defined(HASIPv6) */
-		       "inet"
+		   "inet"
 #endif	/* defined(HASIPv6) */
-		      ))
-		continue;
-	    switch (f) {
-	    case 0:
+		  ))
+	    return;
+	switch (f) {
+	case 0:
+
+	/*
+	 * Process already selected socket.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 
 	    /*
-	     * Process already selected socket.
+	     * This file has been selected by some criterion other than its
+	     * being a socket.  Look up the socket's endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
-
-		/*
-		 * This file has been selected by some criterion other than its
-		 * being a socket.  Look up the socket's endpoints.
-		 */
-		    p = find_netsepti(Lf);
-		    if (p && p->inode)
-			prt_nets(p, 1);
-		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_NETS)) {
+		p = find_netsepti(Lf);
+		if (p && p->inode)
+		    prt_nets(p, 1);
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_NETS)) {
 
-		/*
-		 * This is an unselected end point INET socket file.  Select it
-		 * and add its end point information to peer's name column
-		 * addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    p = find_netsepti(Lf);
-		    if (p && p->inode)
-			prt_nets(p, 0);
-		}
-		break;
+	    /*
+	     * This is an unselected end point INET socket file.  Select it
+	     * and add its end point information to peer's name column
+	     * addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		p = find_netsepti(Lf);
+		if (p && p->inode)
+		    prt_nets(p, 0);
 	    }
+	    break;
 	}
 }
 #endif
@@ -1705,9 +1702,10 @@ prt_nets6(p, mk)
 }
 
 /*
- * process_nets6info() -- process locally used INET6 socket information, adding
- *			it to selected INET6 socket files and selecting INET6
- *			socket end point files (if requested)
+ * process_nets6info() -- process the locally used INET6 socket information
+ *			  of the file at Lf, adding it to the file if
+ *			  selected, or selecting the file if it's an INET6
+ *			  socket end point (if requested)
  */
 
 void
@@ -1722,41 +1720,39 @@ process_nets6info(f)
 
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if (strcmp(Lf->type, "IPv6"))
-		continue;
-	    switch (f) {
-	    case 0:
+	if (strcmp(Lf->type, "IPv6"))
+	    return;
+	switch (f) {
+	case 0:
 
+	/*
+	 * Process already selected socket.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 	    /*
-	     * Process already selected socket.
+	     * This file has been selected by some criterion other than its
+	     * being a socket.  Look up the socket's endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
-		/*
-		 * This file has been selected by some criterion other than its
-		 * being a socket.  Look up the socket's endpoints.
-		 */
-		    p = find_nets6epti(Lf);
-		    if (p && p->inode)
-			prt_nets6(p, 1);
-		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_NETS6)) {
+		p = find_nets6epti(Lf);
+		if (p && p->inode)
+		    prt_nets6(p, 1);
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_NETS6)) {
 
-		/*
-		 * This is an unselected end point INET6 socket file.  Select it
-		 * and add its end point information to peer's name column
-		 * addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    p = find_nets6epti(Lf);
-		    if (p && p->inode)
-			prt_nets6(p, 0);
-		}
-		break;
+	    /*
+	     * This is an unselected end point INET6 socket file.  Select it
+	     * and add its end point information to peer's name column
+	     * addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		p = find_nets6epti(Lf);
+		if (p && p->inode)
+		    prt_nets6(p, 0);
 	    }
+	    break;
 	}
 }
 #endif	/* defined(HASEPTOPTS) */
@@ -3748,14 +3744,7 @@ print_ax25info(ap)
 	    cp ? ", " : "",
 	    cp ? cp : "");
 	pl = strlen(pbuf);
-	if (!(cp = (char *)malloc(pl + 1))) {
-	    (void) fprintf(stderr,
-		"%s: can't allocate %d bytes for AX25 sock state, PID: %d\n",
-		Pn, (int)(pl + 1), Lp->pid);
-	    Exit(1);
-	}
-	(void) snpf(cp, pl + 1, "%s", pbuf);
-	Lf->nma = cp;
+	(void) add_nma(pbuf, (int)pl);
 }
 
 
@@ -3767,7 +3756,7 @@ static void
 print_ipxinfo(ip)
 	struct ipxsin *ip;		/* IPX socket info */
 {
-	char *cp, pbuf[256];
+	char pbuf[256];
 	MALLOC_S pl;
 
 	if (Lf->nma)
@@ -3775,14 +3764,7 @@ print_ipxinfo(ip)
 	(void) snpf(pbuf, sizeof(pbuf), "(Tx=%lx Rx=%lx State=%02x)",
 	    ip->txq, ip->rxq, ip->state);
 	pl = strlen(pbuf);
-	if (!(cp = (char *)malloc(pl + 1))) {
-	    (void) fprintf(stderr,
-		"%s: can't allocate %d bytes for IPX sock state, PID: %d\n",
-		Pn, (int)(pl + 1), Lp->pid);
-	    Exit(1);
-	}
-	(void) snpf(cp, pl + 1, "%s", pbuf);
-	Lf->nma = cp;
+	(void) add_nma(pbuf, (int)pl);
 }
 
 
@@ -3795,7 +3777,8 @@ print_unix(int nl)
 {
 	if (Ftcptpi & TCPTPI_STATE) {
 #if	defined(HASSOSTATE) && defined(HASSOOPT)
-	    char *cp = (Lf->lts.opt == __SO_ACCEPTCON)? "LISTEN": sockss2str(Lf->lts.ss);
+	    struct ltstate *ts = &LFCOLD(Lf)->lts;
+	    char *cp = (ts->opt == __SO_ACCEPTCON)? "LISTEN": sockss2str(ts->ss);
 
 	    if (Ffield)
 		(void) printf("%cST=%s%c", LSOF_FID_TCPTPI, cp, Terminator);
@@ -3823,17 +3806,18 @@ print_tcptpi(nl)
 	char *cp = (char *)NULL;
 	int ps = 0;
 	int s;
+	struct ltstate *ts = &LFCOLD(Lf)->lts;
 
 	if (!strcmp(Lf->type, "unix"))  {
 	    print_unix(nl);
 	    return;
 	}
-	if ((Ftcptpi & TCPTPI_STATE) && Lf->lts.type == 0) {
+	if ((Ftcptpi & TCPTPI_STATE) && ts->type == 0) {
 	    if (!TcpSt)
 		(void) build_IPstates();
-	    if ((s = Lf->lts.state.i + TcpStOff) < 0 || s >= TcpNstates) {
+	    if ((s = ts->state.i + TcpStOff) < 0 || s >= TcpNstates) {
 		(void) snpf(buf, sizeof(buf), "UNKNOWN_TCP_STATE_%d",
-		    Lf->lts.state.i);
+		    ts->state.i);
 		cp = buf;
     	    } else
 		cp = TcpSt[s];
@@ -3850,7 +3834,7 @@ print_tcptpi(nl)
 
 # if	defined(HASTCPTPIQ)
 	if (Ftcptpi & TCPTPI_QUEUES) {
-	    if (Lf->lts.rqs) {
+	    if (ts->rqs) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -3859,12 +3843,12 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("QR=%lu", Lf->lts.rq);
+		(void) printf("QR=%lu", ts->rq);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
 	    }
-	    if (Lf->lts.sqs) {
+	    if (ts->sqs) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -3873,7 +3857,7 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("QS=%lu", Lf->lts.sq);
+		(void) printf("QS=%lu", ts->sq);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
@@ -3883,7 +3867,7 @@ print_tcptpi(nl)
 
 # if	defined(HASTCPTPIW)
 	if (Ftcptpi & TCPTPI_WINDOWS) {
-	    if (Lf->lts.rws) {
+	    if (ts->rws) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -3892,12 +3876,12 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("WR=%lu", Lf->lts.rw);
+		(void) printf("WR=%lu", ts->rw);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
 	    }
-	    if (Lf->lts.wws) {
+	    if (ts->wws) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -3906,7 +3890,7 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("WW=%lu", Lf->lts.ww);
+		(void) printf("WW=%lu", ts->ww);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
@@ -4509,12 +4493,12 @@ process_proc_sock(p, pbr, s, ss, l, lss)
 	    Lf->inode = (INODETYPE)s->st_ino;
 	    Lf->inp_ty = 1;
 
-	    Lf->lts.type = up->ty;
+	    LFCOLDW(Lf)->lts.type = up->ty;
 #if	defined(HASSOOPT)
-	    Lf->lts.opt = up->opt;
+	    LFCOLDW(Lf)->lts.opt = up->opt;
 #endif	/* defined(HASSOOPT) */
 #if	defined(HASSOSTATE)
-	    Lf->lts.ss = up->ss;
+	    LFCOLDW(Lf)->lts.ss = up->ss;
 #endif	/* defined(HASSOSTATE) */
 #if	defined(HASEPTOPTS) && defined(HASUXSOCKEPT)
 	    if (FeptE) {
@@ -4592,6 +4576,16 @@ process_proc_sock(p, pbr, s, ss, l, lss)
 		    }
 		}
 	    }
+
+#if	defined(HASDIRPFX)
+	/*
+	 * See if this UNIX domain socket's path is below a +B directory.
+	 */
+	    if (Dirpfx && up->path
+	    &&  is_file_pfx(up->path, up->sb_dev, (int)up->sb_def))
+		Lf->sf |= SELNM;
+#endif	/* defined(HASDIRPFX) */
+
 	    return;
 	}
 
@@ -4748,13 +4742,13 @@ process_proc_sock(p, pbr, s, ss, l, lss)
 		    la += 12;
 	    }
 	    ent_inaddr(la, tp6->lport, fa, tp6->fport, af);
-	    Lf->lts.type = tp6->proto;
-	    Lf->lts.state.i = tp6->state;
+	    LFCOLDW(Lf)->lts.type = tp6->proto;
+	    LFCOLDW(Lf)->lts.state.i = tp6->state;
 
 #if     defined(HASTCPTPIQ)
-	    Lf->lts.rq = tp6->rxq;
-	    Lf->lts.sq = tp6->txq;
-	    Lf->lts.rqs = Lf->lts.sqs = 1;
+	    LFCOLDW(Lf)->lts.rq = tp6->rxq;
+	    LFCOLDW(Lf)->lts.sq = tp6->txq;
+	    LFCOLDW(Lf)->lts.rqs = LFCOLDW(Lf)->lts.sqs = 1;
 #endif  /* defined(HASTCPTPIQ) */
 
 #if	defined(HASEPTOPTS)
@@ -4853,13 +4847,13 @@ process_proc_sock(p, pbr, s, ss, l, lss)
 	    } else
 		la = (unsigned char *)NULL;
 	    ent_inaddr(la, tp->lport, fa, tp->fport, AF_INET);
-	    Lf->lts.type = tp->proto;
-	    Lf->lts.state.i = tp->state;
+	    LFCOLDW(Lf)->lts.type = tp->proto;
+	    LFCOLDW(Lf)->lts.state.i = tp->state;
 
 #if     defined(HASTCPTPIQ)
-	    Lf->lts.rq = tp->rxq;
-	    Lf->lts.sq = tp->txq;
-	    Lf->lts.rqs = Lf->lts.sqs = 1;
+	    LFCOLDW(Lf)->lts.rq = tp->rxq;
+	    LFCOLDW(Lf)->lts.sq = tp->txq;
+	    LFCOLDW(Lf)->lts.rqs = LFCOLDW(Lf)->lts.sqs = 1;
 #endif  /* defined(HASTCPTPIQ) */
 
 #if	defined(HASEPTOPTS)
@@ -5293,7 +5287,7 @@ static char *
 sockss2str(unsigned int ss)
 {
 	char *sr;
-	switch (Lf->lts.ss) {
+	switch (LFCOLD(Lf)->lts.ss) {
 	case SS_UNCONNECTED:
 	    sr = "UNCONNECTED";
 	    break;
@@ -67,6 +67,15 @@
 /* #define	GET_MAX_FD	?	*/
 
 
+/*
+ * HAS_CLOCK_NANOSLEEP is defined for those dialects that have a
+ * CLOCK_MONOTONIC clock and clock_nanosleep().  Repeat mode then starts its
+ * cycles at absolute deadlines, so they don't drift by the scan time.
+ */
+
+#define	HAS_CLOCK_NANOSLEEP	1
+
+
 /*
  * HASAOPT is defined for those dialects that have AFS support; it specifies
  * that the default path to an alternate AFS kernel name list file may be
@@ -140,6 +149,15 @@
 /* #define	HASFIFONODE	1 */
 
 
+/*
+ * HASDIRPFX is defined for those dialects that can select the files below a
+ * +B directory by matching the path names /proc reports for them to the
+ * directory's path name, without walking the directory tree.
+ */
+
+#define	HASDIRPFX	1
+
+
 /*
  * HASEOPT is defined for dialects that support the -e option
  */
@@ -260,6 +278,22 @@
 /* #define	HASMNTSTAT	1	*/
 
 
+/*
+ * HASMNTDEVIX is defined for those dialects whose readmnt() indexes the mount
+ * table by device, and that supply find_mntdev() to search the index.
+ */
+
+#define	HASMNTDEVIX	1
+
+
+/*
+ * HASMNTNS is defined for those dialects that search the mount table of each
+ * process' mount namespace, rather than lsof's own.  It requires HASMNTDEVIX.
+ */
+
+#define	HASMNTNS	1
+
+
 /*
  * HASMNTSUP is defined for those dialects that support the mount supplement
  * option.
@@ -299,6 +333,38 @@
 /* #define	HASNLIST	1 */
 
 
+/*
+ * HASPARHOSTRSLV is defined for those dialects that can look up the host
+ * names of Internet addresses in parallel, using POSIX threads, before
+ * printing begins.  Its value is the maximum number of lookups that may
+ * be in progress at once.
+ */
+
+#define	HASPARHOSTRSLV	16
+
+
+/*
+ * HASPARDIRWALK is defined for those dialects that can walk the directory
+ * trees of the +d and +D options with POSIX threads, using openat(),
+ * fdopendir() and fstatat().  Its value is the default number of threads.
+ * It is ignored when HASSPECDEVD is defined.
+ */
+
+#define	HASPARDIRWALK	8
+
+
+/*
+ * HASDOINTHREAD is defined for those dialects that perform the lstat(),
+ * readlink() and stat() functions of lstatsafely(), Readlink() and
+ * statsafely() in the POSIX threads of a child process that shares memory
+ * with lsof, instead of in a child process connected by pipes.  Its value is
+ * the maximum number of helper threads, including those blocked in functions
+ * that have timed out.
+ */
+
+#define	HASDOINTHREAD	16
+
+
 /*
  * HASPIPEFN is defined for those dialects that have a special function to
  * process DTYPE_PIPE file structure entries.  Its value is the name of the
@@ -389,6 +455,55 @@
 /* #define	HASPRIVPRIPP	1	*/
 
 
+/*
+ * HASLPARENA is defined for those dialects that carve the lfile structures
+ * of a process and their strings from a per-process arena.  Such a dialect
+ * must set the dev_ch, nm and nma strings of a local file structure only
+ * with enter_dev_ch(), enter_nm(), add_nma() or mkstrlpa().
+ */
+
+#define	HASLPARENA	1
+
+
+/*
+ * HASNMINTERN is defined for those dialects that want enter_nm() to intern
+ * file names in a table shared by all processes for the life of lsof.
+ * HASNMINTERN requires HASLPARENA.
+ */
+
+#define	HASNMINTERN	1
+
+
+/*
+ * HASLFILECOLD is defined for those dialects that keep the rarely used parts
+ * of a local file structure -- Internet addresses, TCP/TPI state, endpoint
+ * IDs, and file system directory and device names -- in a separate record,
+ * allocated only for the files that need it.  Such a dialect must read those
+ * fields with LFCOLD() and write them with LFCOLDW().  HASLFILECOLD requires
+ * HASLPARENA.
+ */
+
+#define	HASLFILECOLD	1
+
+
+/*
+ * HASPROCEVT is defined for those dialects that can learn from kernel
+ * process events which processes have been created, changed or have exited
+ * between repeat mode (-r) cycles.  It enables the -r `p' suffix.
+ */
+
+#define	HASPROCEVT	1
+
+
+/*
+ * HASCGROUP is defined for those dialects that can select processes by
+ * control group membership with the -G and +G options, reading the member
+ * PIDs from the cgroup's cgroup.procs file.
+ */
+
+#define	HASCGROUP	1
+
+
 /*
  * HASPROCFS is defined for those dialects that have a proc file system --
  * usually /proc and usually in SYSV4 derivatives.
@@ -425,6 +540,15 @@
 /* #define	HASRNODE	1 */
 
 
+/*
+ * HASRPTINCR is defined for those dialects that can keep the file
+ * information of the previous repeat mode (-r) cycle and reuse the parts
+ * of it whose identity and status have not changed.
+ */
+
+#define	HASRPTINCR	1
+
+
 /*
  * Define HASSECURITY to restrict the listing of all open files to the
  * root user.  When HASSECURITY is defined, the non-root user may list
@@ -0,0 +1,41 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+f=/tmp/${name}-$$
+: > $f
+
+# A process with many open files.
+(
+    for i in $(seq 1 1000); do
+	exec {fd}<$f
+    done
+    sleep 10
+) &
+pid=$!
+sleep 1
+
+stats=$(LSOFARENASTATS=1 $lsof -p $pid 2>&1 >/dev/null | grep 'arenas:')
+n=$($lsof -p $pid -a -d 0-2000 | grep -c " $f\$")
+kill $pid 2> /dev/null
+rm -f $f
+echo "$stats" >> $report
+echo "$n files" >> $report
+
+if [ "$n" -lt 1000 ]; then
+    echo "only $n of the files were listed" >> $report
+    exit 1
+fi
+na=$(echo "$stats" | sed -n 's/.* \([0-9]*\) allocations.*/\1/p')
+nc=$(echo "$stats" | sed -n 's/.* from \([0-9]*\) chunks.*/\1/p')
+if [ -z "$na" ] || [ -z "$nc" ]; then
+    echo "no arena statistics" >> $report
+    exit 1
+fi
+if [ "$na" -lt 1000 ] || [ $((nc * 50)) -gt "$na" ]; then
+    echo "$na allocations needed $nc chunks" >> $report
+    exit 1
+fi
+
+exit 0
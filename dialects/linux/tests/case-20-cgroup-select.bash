@@ -0,0 +1,73 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+# Build a cgroup v2 fixture with a child cgroup, where the environment
+# allows it.
+fs=$(awk '$3 == "cgroup2" { print $2; exit }' /proc/mounts)
+if [ -z "$fs" ]; then
+    echo "no cgroup v2 file system" >> $report
+    exit 2
+fi
+cg=/lsof-$$
+if ! mkdir $fs$cg 2> /dev/null; then
+    echo "can't create a cgroup under $fs" >> $report
+    exit 2
+fi
+mkdir $fs$cg/child $fs$cg/empty
+
+sleep 30 &
+p1=$!
+sleep 30 &
+p2=$!
+
+cleanup()
+{
+    kill $p1 $p2 2> /dev/null
+    wait $p1 $p2 2> /dev/null
+    rmdir $fs$cg/child $fs$cg/empty $fs$cg
+}
+
+if ! echo $p1 > $fs$cg/cgroup.procs || ! echo $p2 > $fs$cg/child/cgroup.procs
+then
+    echo "can't move processes into the cgroups" >> $report
+    cleanup
+    exit 2
+fi
+
+check()
+{
+    local want=$1
+    shift
+    local got=$($lsof "$@" -F p | tr '\n' ' ')
+    echo "$* -> $got" >> $report
+    if [ "$got" != "$want" ]; then
+	echo "expected \"$want\"" >> $report
+	cleanup
+	exit 1
+    fi
+}
+
+# -G selects the cgroup's own members; +G adds those of its descendants.
+# A path in the cgroup file system and a cgroup v2 name are both accepted.
+check "p$p1 " -G $fs$cg
+check "p$p1 p$p2 " +G $cg
+check "p$p2 " -G $cg/child
+
+# ORed and ANDed with another process selection.
+check "p$p1 p$p2 " -G $cg -p $p2
+check "" -a -G $cg -p $p2
+check "p$p2 " -a +G $cg -p $p2
+
+# A cgroup without processes is reported by -V.
+out=$($lsof -V -G $cg/empty)
+echo "$out" >> $report
+if ! echo "$out" | grep -q "^lsof: cgroup not located: $cg/empty\$"; then
+    echo "the empty cgroup wasn't reported" >> $report
+    cleanup
+    exit 1
+fi
+
+cleanup
+exit 0
@@ -0,0 +1,85 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+# +B must select the same files as +D, without walking the tree.
+
+top=/tmp/${name}-$$
+mkdir -p $top/a/b/c $top-sib
+: > $top/a/f1
+: > $top/a/b/c/f2
+: > $top/gone
+: > $top-sib/f3
+ln -s $top/a $top-link
+
+# A process with files open below the directory, in a sibling whose name
+# starts with the directory's name, and one deleted file.
+(
+    cd $top/a/b
+    exec 3< $top/a/f1 4< $top/a/b/c/f2 5< $top-sib/f3 6< $top/gone
+    exec sleep 30
+) &
+pid=$!
+
+cleanup()
+{
+    kill $pid 2> /dev/null
+    if [ -n "$mnt" ]; then
+	umount $top/m 2> /dev/null
+    fi
+    rm -rf $top $top-sib $top-link
+}
+
+sleep 0.3
+rm -f $top/gone
+for d in $top $top/ $top/a/b $top-link; do
+    walk=$($lsof -w -a -p $pid +D $d -F fn)
+    pfx=$($lsof -w -a -p $pid +B $d -F fn)
+    echo "+B $d:" >> $report
+    echo "$pfx" >> $report
+    if [ -z "$pfx" ] || [ "$pfx" != "$walk" ]; then
+	echo "+D $d found:" >> $report
+	echo "$walk" >> $report
+	cleanup
+	exit 1
+    fi
+done
+if $lsof -w -a -p $pid +B $top -F n | grep -q "^n$top-sib"; then
+    echo "+B selected a file in a sibling directory" >> $report
+    cleanup
+    exit 1
+fi
+if $lsof -w -a -p $pid +B $top -F n | grep -q "gone"; then
+    echo "+B selected a deleted file" >> $report
+    cleanup
+    exit 1
+fi
+
+# Files on a file system mounted below the directory need -x f.
+mkdir $top/m
+if mount -t tmpfs none $top/m 2> /dev/null; then
+    mnt=1
+    : > $top/m/f4
+    sleep 30 < $top/m/f4 &
+    mpid=$!
+    sleep 0.3
+    without=$($lsof -w -a -p $mpid +B $top -F n)
+    with=$($lsof -w -a -p $mpid -x f +B $top -F n)
+    kill $mpid
+    wait $mpid 2> /dev/null
+    echo "$with" >> $report
+    if echo "$without" | grep -q "f4"; then
+	echo "+B crossed a mount point without -x f" >> $report
+	cleanup
+	exit 1
+    fi
+    if ! echo "$with" | grep -q "^n$top/m/f4\$"; then
+	echo "+B didn't cross a mount point with -x f" >> $report
+	cleanup
+	exit 1
+    fi
+fi
+
+cleanup
+exit 0
@@ -0,0 +1,40 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+TARGET=$tdir/udp
+if ! [ -x $TARGET ]; then
+    echo "target executable ( $TARGET ) is not found" >> $report
+    exit 1
+fi
+
+# Each socket has a distinct peer, so every address takes its own host
+# cache entry.  Report the elapsed time per socket for two table sizes; it
+# should stay flat as the number of cached addresses grows.
+
+n=$(ulimit -n)
+if [ "$n" != unlimited ] && [ "$n" -lt 4200 ]; then
+    ulimit -n 4200 2>/dev/null || {
+	echo "can't raise the fd limit above $n" >> $report
+	exit 2
+    }
+fi
+
+for count in 1000 4000; do
+    { $TARGET 127.1.0.1 $count & } | {
+	read pid fd
+	if [ -z "$pid" ] || [ -z "$fd" ]; then
+	    echo "unexpected output form target ( $TARGET )"
+	    exit 1
+	fi
+	start=$(date +%s%N)
+	peers=$($lsof -n -p $pid -a -i UDP -F n | sed -n 's/^n.*->\(.*\):.*$/\1/p' |
+		    sort -u | wc -l)
+	end=$(date +%s%N)
+	kill $pid
+	echo "sockets: $count peers: $peers ns/socket: $(( (end - start) / count ))"
+	[ "$peers" = $count ]
+    } >> $report 2>&1 || exit 1
+done
+exit 0
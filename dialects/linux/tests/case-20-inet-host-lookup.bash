@@ -0,0 +1,48 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+TARGET=$tdir/udp
+STUB=$tdir/rslvstub.so
+for x in $TARGET $STUB; do
+    if ! [ -e $x ]; then
+	echo "target ( $x ) is not found" >> $report
+	exit 1
+    fi
+done
+STUB=$(cd $(dirname $STUB); pwd)/$(basename $STUB)
+
+{ $TARGET 127.0.0.2 & } | {
+    read pid fd
+    if [ -z "$pid" ] || [ -z "$fd" ]; then
+	echo "unexpected output form target ( $TARGET )" >> $report
+	exit 1
+    fi
+    {
+	echo pid: $pid
+	echo fd: $fd
+	echo
+	echo names from the stub resolver
+	out=$(LD_PRELOAD=$STUB $lsof -p $pid -a -d $fd -F n)
+	echo "$out"
+	echo expected pattern: "n.*->stub-127-0-0-2:"
+	echo "$out" | grep -q "^n.*->stub-127-0-0-2:"
+    } && {
+	echo
+	echo numeric addresses when the stub resolver hangs
+	start=$(date +%s)
+	out=$(LSOF_RSLVSTUB_DELAY=60 LD_PRELOAD=$STUB timeout 30 \
+		$lsof -S 2 -p $pid -a -d $fd -F n)
+	elapsed=$(( $(date +%s) - start ))
+	echo "$out"
+	echo elapsed: $elapsed
+	echo expected pattern: "n.*->127.0.0.2:"
+	echo "$out" | grep -q "^n.*->127\.0\.0\.2:" && [ $elapsed -lt 10 ]
+    } && {
+	kill $pid
+	exit 0
+    }
+    kill $pid
+    exit 1
+} >> $report 2>&1
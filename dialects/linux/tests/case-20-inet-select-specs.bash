@@ -0,0 +1,74 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+TARGET=$tdir/udp
+if ! [ -x $TARGET ]; then
+    echo "target executable ( $TARGET ) is not found" >> $report
+    exit 1
+fi
+
+# Several -i specs must select the sockets a scan of the spec list would, and
+# each spec that matches nothing must still be reported as not located.  Each
+# case is run with a short spec list, which is scanned, and again with enough
+# unmatched specs added to have it indexed.
+#
+# A socket that several specs match marks only the first of them, in list
+# order, as located; for such cases the indexed run must report the same
+# specs as the scanned one.
+
+pad=
+for i in $(seq 1 40); do
+    pad="$pad -i @127.1.8.$i"
+done
+
+{ $TARGET 127.1.2.1 4 & } | {
+    read pid fd
+    if [ -z "$pid" ] || [ -z "$fd" ]; then
+	echo "unexpected output form target ( $TARGET )"
+	exit 1
+    fi
+
+    # check <selected peers> <unlocated specs, or = for the scan's> -- <-i specs>
+    check()
+    {
+	local peers=$1 nl=$2 p out got
+	shift 3
+	for p in "" "$pad"; do
+	    out=$($lsof -n -P -V -a -p $pid "$@" $p 2>&1)
+	    echo "$out"
+	    got=$(echo "$out" | sed -n 's/.* UDP 127\.0\.0\.1:[0-9]*->127\.1\.2\.\([0-9]*\):9 *$/\1/p' | sort | tr '\n' ' ')
+	    if [ "$got" != "$peers" ]; then
+		echo "$*${p:+ (indexed)}: selected peers ( $got), expected ( $peers)"
+		return 1
+	    fi
+	    got=$(echo "$out" | sed -n 's/^lsof: Internet address not located: //p' | grep -v '^@127\.1\.8\.' | sort | tr '\n' ' ')
+	    if [ "$nl" = "=" ]; then
+		nl=$got
+	    elif [ "$got" != "$nl" ]; then
+		echo "$*${p:+ (indexed)}: not located ( $got), expected ( $nl)"
+		return 1
+	    fi
+	    if [ -n "$p" ] && [ $(echo "$out" | grep -c '^lsof: Internet address not located: @127\.1\.8\.') -ne 40 ]; then
+		echo "$* (indexed): an unmatched padding spec wasn't reported"
+		return 1
+	    fi
+	done
+	return 0
+    }
+
+    r=0
+    # A protocol-only spec, an address spec and an address and port spec; and
+    # specs that match nothing.
+    check "2 4 " ":10 @127.1.9.9 TCP " -- \
+	-i TCP -i @127.1.2.2 -i @127.1.2.4:9 -i @127.1.9.9 -i :10 || r=1
+    # Overlapping protocol-only and port specs select each socket once.
+    check "1 2 3 4 " "=" -- -i UDP -i :9 || r=1
+    # Overlapping address specs, and a port range, select each socket once.
+    check "3 " "=" -- -i @127.1.2.3 -i UDP@127.1.2.3:9 || r=1
+    check "1 2 3 4 " "=" -- -i UDP:8-10 -i @127.1.2.2:9 -i TCP:8-10 || r=1
+    kill $pid
+    exit $r
+} >> $report 2>&1 || exit 1
+exit 0
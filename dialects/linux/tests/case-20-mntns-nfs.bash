@@ -0,0 +1,75 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+# A file reached through an NFS bind mount that exists only in its process'
+# private mount namespace must be classified with that namespace's mount
+# table: -N selects it.  lsof's own table has no mount there, so it would
+# not.  The mount is made after the first -r cycle, which the later cycles
+# must see.
+#
+# This needs an NFS mount with a readable regular file near its top.
+
+if ! type unshare > /dev/null 2>&1; then
+    echo "no unshare command" >> $report
+    exit 2
+fi
+
+nfsdir=
+rel=
+while read dir fst; do
+    case $fst in
+    nfs|nfs3|nfs4)
+	f=$(find "$dir" -maxdepth 2 -type f -readable 2> /dev/null | head -1)
+	if [ -n "$f" ]; then
+	    nfsdir=$dir
+	    rel=${f#$dir/}
+	    break
+	fi
+	;;
+    esac
+done < <(sed -n 's/^[^ ]* [^ ]* [^ ]* [^ ]* \([^ ]*\) .* - \([^ ]*\) .*/\1 \2/p' /proc/self/mountinfo)
+if [ -z "$nfsdir" ]; then
+    echo "no NFS mount with a readable regular file" >> $report
+    exit 2
+fi
+echo "NFS file: $nfsdir/$rel" >> $report
+
+top=/tmp/${name}-$$
+mkdir -p $top
+unshare -m --propagation private \
+    sh -c "sleep 1.5; mount --bind '$nfsdir' $top && exec sleep 30 < '$top/$rel'" \
+    2>> $report &
+pid=$!
+
+cleanup()
+{
+    kill $pid 2> /dev/null
+    wait $pid 2> /dev/null
+    rmdir $top
+}
+
+sleep 0.2
+rpt=$($lsof -w -N -F n -r 1c4 -a -p $pid)
+echo "$rpt" >> $report
+if ! [ -d /proc/$pid ] || [ "$(readlink /proc/$pid/fd/0)" != "$top/$rel" ]; then
+    echo "can't make the bind mount in a private mount namespace" >> $report
+    cleanup
+    exit 2
+fi
+if ! echo "$rpt" | awk '/^m/ { n++ } n == 3' | grep -q "^n$top/$rel"; then
+    echo "the last repeat cycle didn't see the namespace's new NFS mount" >> $report
+    cleanup
+    exit 1
+fi
+out=$($lsof -w -N -F n -a -p $pid)
+echo "$out" >> $report
+if ! echo "$out" | grep -q "^n$top/$rel"; then
+    echo "$top/$rel wasn't classified with its namespace's NFS mount" >> $report
+    cleanup
+    exit 1
+fi
+
+cleanup
+exit 0
@@ -0,0 +1,56 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+# The mount table comes from /proc/self/mountinfo.  Its device numbers must
+# be the ones stat() reports for the mounted directories, also when a second
+# file system is mounted over the first one.
+
+if ! [ -r /proc/self/mountinfo ]; then
+    echo "no /proc/self/mountinfo" >> $report
+    exit 2
+fi
+
+top=/tmp/${name}-$$
+mkdir -p $top
+if ! mount -t tmpfs none $top 2> /dev/null; then
+    echo "can't mount a tmpfs on $top" >> $report
+    rmdir $top
+    exit 2
+fi
+mount -t tmpfs none $top
+: > $top/f
+
+sleep 30 < $top/f &
+pid=$!
+
+cleanup()
+{
+    kill $pid 2> /dev/null
+    wait $pid 2> /dev/null
+    umount $top
+    umount $top
+    rmdir $top
+}
+
+sleep 0.3
+dev=$(printf "%#x" $((0x$(stat -c %D $top))))
+echo "stat: $top $dev" >> $report
+sup=$($lsof +m | grep "^$top ")
+echo "+m: $sup" >> $report
+if [ "$sup" != "$top $dev" ]; then
+    echo "the mount table has the covered file system's device" >> $report
+    cleanup
+    exit 1
+fi
+out=$($lsof -w -a -p $pid -F n $top)
+echo "$out" >> $report
+if ! echo "$out" | grep -q "^n$top/f\$"; then
+    echo "a file system argument didn't select $top/f" >> $report
+    cleanup
+    exit 1
+fi
+
+cleanup
+exit 0
@@ -0,0 +1,42 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+f=/tmp/${name}-$$
+: > $f
+
+# Several processes with the same files open should share interned names.
+pids=
+for i in 1 2 3 4 5 6 7 8; do
+    sleep 30 3<$f &
+    pids="$pids${pids:+,}$!"
+done
+
+cleanup()
+{
+    kill $(echo $pids | tr , ' ') 2> /dev/null
+    rm -f $f
+}
+
+out=$(LSOFARENASTATS=1 $lsof -p $pids -a -d 3 2>&1)
+echo "$out" >> $report
+cleanup
+
+stats=$(echo "$out" | grep 'names: ')
+if [ -z "$stats" ]; then
+    echo "no interned name statistics reported" >> $report
+    exit 1
+fi
+n=$(echo "$out" | grep -c " $f\$")
+if [ $n -ne 8 ]; then
+    echo "$f listed $n times instead of 8" >> $report
+    exit 1
+fi
+set -- $(echo "$stats" | sed -e 's/.*names: \([0-9]*\) lookups, \([0-9]*\) distinct.*/\1 \2/')
+if [ "$1" -lt 8 ] || [ $(($2 * 4)) -gt "$1" ]; then
+    echo "$1 name lookups found $2 distinct names" >> $report
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+TARGET=$tdir/ofd_lock
+f=/tmp/${name}-$$
+
+# An open file description (OFD) lock has no PID in /proc/locks.  It must be
+# reported for the descriptor it was set through, and not for a second
+# descriptor of the same file.
+
+{
+$TARGET $f | (
+    read pid lfd ufd
+    if [[ $pid = -1 ]]; then
+	echo "OFD locks are not available on this platform"
+	rm -f $f
+	exit 2
+    fi
+    r=0
+    locked=$($lsof -p $pid -a -d $lfd -F l | tr '\n' ' ')
+    unlocked=$($lsof -p $pid -a -d $ufd -F l | tr '\n' ' ')
+    echo "$lfd: $locked"
+    echo "$ufd: $unlocked"
+    if ! fgrep -q "lW" <<<"$locked"; then
+	echo "the OFD lock wasn't reported"
+	r=1
+    fi
+    if fgrep -q "lW" <<<"$unlocked"; then
+	echo "the OFD lock was reported for an unlocked descriptor"
+	r=1
+    fi
+    kill $pid
+    rm -f $f
+    exit $r
+)
+} >> $report 2>&1
@@ -0,0 +1,35 @@
+#!/bin/sh
+
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+# With -K every task of a process is listed, but the process' descriptors
+# are shared, so a pipe end held by a multi-threaded process must appear
+# once in its peer's endpoint list.
+
+TARGET=$tdir/pipe
+if ! [ -x $TARGET ]; then
+    echo "target executable ( $TARGET ) is not found" >> $report
+    exit 1
+fi
+
+{ ./$TARGET threads & } | {
+    read parent child fdr fdw;
+    if [ -z "$parent" ] || [ -z "$child" ] || [ -z "$fdr" ] || [ -z "$fdw" ]; then
+	echo "unexpected output form target ( $TARGET )" >> $report
+	exit 1
+    fi
+    sleep 0.3
+    echo cmdline: "$lsof -K +E -p $child -a -d $fdw" >> $report
+    out=$($lsof -w -K +E -p "$child" -a -d "$fdw" | grep "^[^ ]* *$parent .* ${fdr}r *FIFO")
+    echo "$out" >> $report
+    kill "$child"
+    n=$(echo "$out" | grep -o " ${child},[^ ]*,${fdw}w" | wc -l)
+    if [ "$n" != 1 ]; then
+	echo "the writer was listed $n times" >> $report
+	exit 1
+    fi
+    exit 0
+}
@@ -0,0 +1,63 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+f1=/tmp/${name}-$$-1
+f2=/tmp/${name}-$$-2
+f3=/tmp/${name}-$$-3
+: > $f1
+: > $f2
+: > $f3
+
+# An idle process: every cycle must list the same files as a one-shot run.
+sleep 30 3<$f3 4>>$f3 &
+idle=$!
+
+# A process that keeps growing one file and switches another descriptor
+# between two files.
+(
+    exec 3>>$f1
+    while :; do
+	exec 5<$f1; echo x >&3; sleep 0.2
+	exec 5<$f2; echo x >&3; sleep 0.2
+    done
+) &
+busy=$!
+
+cleanup()
+{
+    kill $idle $busy 2> /dev/null
+    rm -f $f1 $f2 $f3
+}
+
+sleep 0.2
+one=$($lsof -p $idle)
+rpt=$($lsof -r 0.2c3 -p $idle)
+echo "$rpt" >> $report
+for c in 1 2 3; do
+    cyc=$(echo "$rpt" | awk -v c=$c '/^=======/ { n++; next } n == c - 1')
+    if [ "$cyc" != "$one" ]; then
+	echo "cycle $c of the idle process differs from a single run" >> $report
+	cleanup
+	exit 1
+    fi
+done
+
+rpt=$($lsof -r 0.15c8 -p $busy -a -d 3,5 -F fsn)
+echo "$rpt" >> $report
+cleanup
+
+n=$(echo "$rpt" | grep -A2 '^f3$' | grep '^s' | sort -u | wc -l)
+if [ $n -lt 3 ]; then
+    echo "the growing file's size was refreshed only $n times" >> $report
+    exit 1
+fi
+for f in $f1 $f2; do
+    if ! echo "$rpt" | grep -A2 '^f5$' | grep -q "^n$f\$"; then
+	echo "descriptor 5 never showed $f" >> $report
+	exit 1
+    fi
+done
+
+exit 0
@@ -0,0 +1,42 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+TARGET=$tdir/udp
+if ! [ -x $TARGET ]; then
+    echo "target executable ( $TARGET ) is not found" >> $report
+    exit 1
+fi
+
+# The addresses of reused socket files must survive from cycle to cycle,
+# and must not leak into the target's other files.
+
+{ $TARGET 127.1.0.1 20 & } | {
+    read pid fd
+    if [ -z "$pid" ] || [ -z "$fd" ]; then
+	echo "unexpected output form target ( $TARGET )"
+	exit 1
+    fi
+    one=$($lsof -n -P -p $pid)
+    rpt=$($lsof -n -P -r 0.2c3 -p $pid)
+    kill $pid
+    echo "$rpt"
+    if [ $(echo "$one" | grep -c ' UDP 127\.0\.0\.1:[0-9]*->127\.1\.0\.[0-9]*:9 *$') -ne 20 ]
+    then
+	echo "one-shot run didn't list the 20 sockets"
+	exit 1
+    fi
+    if echo "$one" | grep -v ' UDP ' | grep -q -- '->'; then
+	echo "a file that isn't a socket has network addresses"
+	exit 1
+    fi
+    for c in 1 2 3; do
+	cyc=$(echo "$rpt" | awk -v c=$c '/^=======/ { n++; next } n == c - 1')
+	if [ "$cyc" != "$one" ]; then
+	    echo "cycle $c differs from a single run"
+	    exit 1
+	fi
+    done
+} >> $report 2>&1 || exit 1
+exit 0
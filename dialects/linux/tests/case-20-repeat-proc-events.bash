@@ -0,0 +1,40 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+tdir=$3
+
+# A command name that no other process has.
+cmd=lp$$ev
+link=/tmp/$cmd
+ln -s $(type -P sleep) $link
+
+# Start the process after the first listing and let it exit before the last.
+(sleep 0.7; exec $link 1.2) &
+bg=$!
+
+out=$($lsof -w -r 0.3c10p -c $cmd -a -d txt -F pc)
+wait $bg
+rm -f $link
+echo "$out" >> $report
+
+# Count the listings in which the process appears.
+seen=$(echo "$out" | awk -v c=c$cmd '/^m$/ { n++; next } $0 == c { s[n] = 1 }
+				      END { for (i in s) k++; print k + 0 }')
+first=$(echo "$out" | awk '/^m$/ { exit } /^p/ { print; exit }')
+last=$(echo "$out" | awk '/^m$/ { n++; next } { l[n] = l[n] $0 }
+			  END { print l[n - 1] }')
+
+if [ -n "$first" ]; then
+    echo "the process was listed before it started" >> $report
+    exit 1
+fi
+if [ $seen -lt 2 ]; then
+    echo "the process was listed in $seen listings" >> $report
+    exit 1
+fi
+if [ -n "$last" ]; then
+    echo "the process was listed after it exited" >> $report
+    exit 1
+fi
+
+exit 0
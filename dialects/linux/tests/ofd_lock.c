@@ -0,0 +1,44 @@
+#define _GNU_SOURCE
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+int
+main(int argc, char **argv)
+{
+  struct flock fl;
+  int lfd, ufd;
+
+  if (argc != 2)
+    {
+      fprintf(stderr, "usage: %s file\n", argv[0]);
+      return 1;
+    }
+  lfd = open(argv[1], O_RDWR | O_CREAT, 0600);
+  ufd = open(argv[1], O_RDWR);
+  if (lfd < 0 || ufd < 0)
+    {
+      perror("open");
+      return 1;
+    }
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type = F_WRLCK;
+  fl.l_whence = SEEK_SET;
+  if (fcntl(lfd, F_OFD_SETLK, &fl) < 0)
+    {
+      if (errno == EINVAL)
+	{
+	  printf("%d %d %d\n", -1, -1, -1);
+	}
+      perror("fcntl(F_OFD_SETLK)");
+      return 1;
+    }
+  printf("%d %d %d\n\n\n", getpid(), lfd, ufd);
+  fclose (stdout);
+  pause();
+  return 0;
+}
@@ -1,16 +1,27 @@
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
 
+static void *
+pause_thread (void *arg)
+{
+  pause ();
+  return NULL;
+}
+
 int
 main(int argc, char **argv)
 {
   int no_close = 0;
+  int threads = 0;
 
   if (argc > 1 && strcmp (argv[1], "no-close") == 0)
     no_close = 1;
+  else if (argc > 1 && strcmp (argv[1], "threads") == 0)
+    threads = 3;
 
   int pd[2];
 
@@ -29,6 +40,15 @@ main(int argc, char **argv)
     {
       if (!no_close)
 	close (pd[0]);
+      for (int i = 0; i < threads; i++)
+	{
+	  pthread_t t;
+	  if (pthread_create (&t, NULL, pause_thread, NULL) != 0)
+	    {
+	      perror("pthread_create");
+	      return 1;
+	    }
+	}
       pause ();
       return 0;
     }
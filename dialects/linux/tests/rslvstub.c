@@ -0,0 +1,59 @@
+/*
+ * A stub resolver, preloaded into lsof by the host name lookup tests.
+ *
+ * It answers every reverse lookup with "stub-A-B-C-D", after sleeping
+ * for $LSOF_RSLVSTUB_DELAY seconds if that is set.
+ */
+#define _GNU_SOURCE
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void
+stub_delay (void)
+{
+	const char *d = getenv ("LSOF_RSLVSTUB_DELAY");
+	if (d)
+		sleep (atoi (d));
+}
+
+int
+getnameinfo (const struct sockaddr *sa, socklen_t salen,
+	     char *host, socklen_t hostlen,
+	     char *serv, socklen_t servlen, int flags)
+{
+	const unsigned char *a;
+
+	if (sa->sa_family != AF_INET || !host)
+		return EAI_NONAME;
+	stub_delay ();
+	a = (const unsigned char *)&((const struct sockaddr_in *)sa)->sin_addr;
+	snprintf (host, hostlen, "stub-%u-%u-%u-%u", a[0], a[1], a[2], a[3]);
+	if (serv && servlen)
+		serv[0] = '\0';
+	return 0;
+}
+
+struct hostent *
+gethostbyaddr (const void *addr, socklen_t len, int type)
+{
+	static char name[64];
+	static char *aliases[1];
+	static struct hostent he;
+	const unsigned char *a = addr;
+
+	if (type != AF_INET)
+		return NULL;
+	stub_delay ();
+	snprintf (name, sizeof (name), "stub-%u-%u-%u-%u", a[0], a[1], a[2], a[3]);
+	he.h_name = name;
+	he.h_aliases = aliases;
+	he.h_addrtype = AF_INET;
+	he.h_length = 4;
+	return &he;
+}
@@ -0,0 +1,58 @@
+#define _GNU_SOURCE
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * udp [ADDR [COUNT]]
+ *
+ * Connect COUNT (default 1) UDP sockets to the discard port of ADDR
+ * (default 127.0.0.2) and the addresses following it, print our PID and
+ * the first socket's fd, then wait.
+ */
+int
+main(int argc, char **argv)
+{
+	struct sockaddr_in sa;
+	const char *peer = (argc > 1)? argv[1]: "127.0.0.2";
+	int count = (argc > 2)? atoi (argv[2]): 1;
+	int fd, fd0 = -1;
+	int i;
+
+	memset (&sa, 0, sizeof (sa));
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons (9);
+	if (inet_pton (AF_INET, peer, &sa.sin_addr) != 1)
+	{
+		fprintf (stderr, "bad address: %s\n", peer);
+		return 1;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		fd = socket (AF_INET, SOCK_DGRAM, 0);
+		if (fd < 0)
+		{
+			perror ("socket");
+			return 1;
+		}
+		if (connect (fd, (struct sockaddr *)&sa, sizeof (sa)) < 0)
+		{
+			perror ("connect");
+			return 1;
+		}
+		if (fd0 < 0)
+			fd0 = fd;
+		sa.sin_addr.s_addr = htonl (ntohl (sa.sin_addr.s_addr) + 1);
+	}
+
+	printf("%d %d\n", getpid (), fd0);
+	fflush (stdout);
+	pause ();
+	return 0;
+}
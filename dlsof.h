@@ -0,0 +1 @@
+dialects/linux/dlsof.h
\ No newline at end of file
@@ -0,0 +1 @@
+dialects/linux/dmnt.c
\ No newline at end of file
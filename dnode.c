@@ -0,0 +1 @@
+dialects/linux/dnode.c
\ No newline at end of file
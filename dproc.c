@@ -0,0 +1 @@
+dialects/linux/dproc.c
\ No newline at end of file
@@ -0,0 +1 @@
+dialects/linux/dproto.h
\ No newline at end of file
@@ -0,0 +1 @@
+dialects/linux/dsock.c
\ No newline at end of file
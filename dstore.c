@@ -0,0 +1 @@
+dialects/linux/dstore.c
\ No newline at end of file
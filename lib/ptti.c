@@ -71,15 +71,16 @@ print_tcptpi(nl)
 {
 	int ps = 0;
 	int s;
+	struct ltstate *ts = &LFCOLD(Lf)->lts;
 
-	if ((Ftcptpi & TCPTPI_STATE) && Lf->lts.type == 0) {
+	if ((Ftcptpi & TCPTPI_STATE) && ts->type == 0) {
 	    if (Ffield)
 		(void) printf("%cST=", LSOF_FID_TCPTPI);
 	    else
 		putchar('(');
 	    if (!TcpNstates)
 		(void) build_IPstates();
-	    if ((s = Lf->lts.state.i) < 0 || s >= TcpNstates)
+	    if ((s = ts->state.i) < 0 || s >= TcpNstates)
 		(void) printf("UNKNOWN_TCP_STATE_%d", s);
 	    else
 		(void) fputs(TcpSt[s], stdout);
@@ -90,7 +91,7 @@ print_tcptpi(nl)
 
 #if	defined(HASTCPTPIQ)
 	if (Ftcptpi & TCPTPI_QUEUES) {
-	    if (Lf->lts.rqs) {
+	    if (ts->rqs) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -99,12 +100,12 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("QR=%lu", Lf->lts.rq);
+		(void) printf("QR=%lu", ts->rq);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
 	    }
-	    if (Lf->lts.sqs) {
+	    if (ts->sqs) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -113,7 +114,7 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("QS=%lu", Lf->lts.sq);
+		(void) printf("QS=%lu", ts->sq);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
@@ -125,9 +126,9 @@ print_tcptpi(nl)
 	if (Ftcptpi & TCPTPI_FLAGS) {
 	    int opt;
 
-	    if ((opt = Lf->lts.opt)
-	    ||  Lf->lts.pqlens || Lf->lts.qlens || Lf->lts.qlims
-	    ||  Lf->lts.rbszs  || Lf->lts.sbsz
+	    if ((opt = ts->opt)
+	    ||  ts->pqlens || ts->qlens || ts->qlims
+	    ||  ts->rbszs  || ts->sbsz
 	    ) {
 		char sep = ' ';
 
@@ -254,8 +255,8 @@ print_tcptpi(nl)
 # if	defined(SO_KEEPALIVE)
 		if (opt & SO_KEEPALIVE) {
 		    (void) printf("%cKEEPALIVE", sep);
-		    if (Lf->lts.kai)
-			(void) printf("=%d", Lf->lts.kai);
+		    if (ts->kai)
+			(void) printf("=%d", ts->kai);
 		    opt &= ~SO_KEEPALIVE;
 		    sep = ',';
 		}
@@ -280,8 +281,8 @@ print_tcptpi(nl)
 # if	defined(SO_LINGER)
 		if (opt & SO_LINGER) {
 		    (void) printf("%cLINGER", sep);
-		    if (Lf->lts.ltm)
-			(void) printf("=%d", Lf->lts.ltm);
+		    if (ts->ltm)
+			(void) printf("=%d", ts->ltm);
 		    opt &= ~SO_LINGER;
 		    sep = ',';
 		}
@@ -351,20 +352,20 @@ print_tcptpi(nl)
 		}
 # endif	/* defined(SO_ORDREL) */
 
-		if (Lf->lts.pqlens) {
-		    (void) printf("%cPQLEN=%u", sep, Lf->lts.pqlen);
+		if (ts->pqlens) {
+		    (void) printf("%cPQLEN=%u", sep, ts->pqlen);
 		    sep = ',';
 		}
-		if (Lf->lts.qlens) {
-		    (void) printf("%cQLEN=%u", sep, Lf->lts.qlen);
+		if (ts->qlens) {
+		    (void) printf("%cQLEN=%u", sep, ts->qlen);
 		    sep = ',';
 		}
-		if (Lf->lts.qlims) {
-		    (void) printf("%cQLIM=%u", sep, Lf->lts.qlim);
+		if (ts->qlims) {
+		    (void) printf("%cQLIM=%u", sep, ts->qlim);
 		    sep = ',';
 		}
-		if (Lf->lts.rbszs) {
-		    (void) printf("%cRCVBUF=%lu", sep, Lf->lts.rbsz);
+		if (ts->rbszs) {
+		    (void) printf("%cRCVBUF=%lu", sep, ts->rbsz);
 		    sep = ',';
 		}
 
@@ -408,8 +409,8 @@ print_tcptpi(nl)
 		}
 # endif	/* defined(SO_SECURITY_REQUEST) */
 
-		if (Lf->lts.sbszs) {
-		    (void) printf("%cSNDBUF=%lu", sep, Lf->lts.sbsz);
+		if (ts->sbszs) {
+		    (void) printf("%cSNDBUF=%lu", sep, ts->sbsz);
 		    sep = ',';
 		}
 
@@ -473,7 +474,7 @@ print_tcptpi(nl)
 	if (Ftcptpi & TCPTPI_FLAGS) {
 	    unsigned int ss;
 
-	    if ((ss = Lf->lts.ss)) {
+	    if ((ss = ts->ss)) {
 		char sep = ' ';
 
 		if (Ffield)
@@ -502,17 +503,17 @@ print_tcptpi(nl)
 
 # if	defined(HASSBSTATE)
 #  if	defined(SBS_CANTRCVMORE)
-		if (Lf->lts.sbs_rcv & SBS_CANTRCVMORE) {
+		if (ts->sbs_rcv & SBS_CANTRCVMORE) {
 		    (void) printf("%cCANTRCVMORE", sep);
-		    Lf->lts.sbs_rcv &= ~SBS_CANTRCVMORE;
+		    LFCOLDW(Lf)->lts.sbs_rcv &= ~SBS_CANTRCVMORE;
 		    sep = ',';
 		}
 #  endif	/* defined(SBS_CANTRCVMORE) */
 
 #  if	defined(SBS_CANTSENDMORE)
-		if (Lf->lts.sbs_snd & SBS_CANTSENDMORE) {
+		if (ts->sbs_snd & SBS_CANTSENDMORE) {
 		    (void) printf("%cCANTSENDMORE", sep);
-		    Lf->lts.sbs_snd &= ~SBS_CANTSENDMORE;
+		    LFCOLDW(Lf)->lts.sbs_snd &= ~SBS_CANTSENDMORE;
 		    sep = ',';
 		}
 #  endif	/* defined(SS_CANTSENDMORE) */
@@ -689,9 +690,9 @@ print_tcptpi(nl)
 
 # if	defined(HASSBSTATE)
 #  if	defined(SBS_RCVATMARK)
-		if (Lf->lts.sbs_rcv & SBS_RCVATMARK) {
+		if (ts->sbs_rcv & SBS_RCVATMARK) {
 		    (void) printf("%cRCVATMARK", sep);
-		    Lf->lts.sbs_rcv &= ~SBS_RCVATMARK;
+		    LFCOLDW(Lf)->lts.sbs_rcv &= ~SBS_RCVATMARK;
 		    sep = ',';
 		}
 #  endif	/* defined(SBS_RCVATMARK) */
@@ -782,7 +783,7 @@ print_tcptpi(nl)
 	if (Ftcptpi & TCPTPI_FLAGS) {
 	    int topt;
 
-	    if ((topt = Lf->lts.topt) || Lf->lts.msss) {
+	    if ((topt = ts->topt) || ts->msss) {
 		char sep = ' ';
 
 		if (Ffield)
@@ -929,8 +930,8 @@ print_tcptpi(nl)
 		}
 # endif	/* defined(TF_LQ_OVERFLOW) */
 
-		if (Lf->lts.msss) {
-		    (void) printf("%cMSS=%lu", sep, Lf->lts.mss);
+		if (ts->msss) {
+		    (void) printf("%cMSS=%lu", sep, ts->mss);
 		    sep = ',';
 		}
 
@@ -1328,7 +1329,7 @@ print_tcptpi(nl)
 
 #if	defined(HASTCPTPIW)
 	if (Ftcptpi & TCPTPI_WINDOWS) {
-	    if (Lf->lts.rws) {
+	    if (ts->rws) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -1337,12 +1338,12 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("WR=%lu", Lf->lts.rw);
+		(void) printf("WR=%lu", ts->rw);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
 	    }
-	    if (Lf->lts.wws) {
+	    if (ts->wws) {
 		if (Ffield)
 		    putchar(LSOF_FID_TCPTPI);
 		else {
@@ -1351,7 +1352,7 @@ print_tcptpi(nl)
 		    else
 			putchar('(');
 		}
-		(void) printf("WW=%lu", Lf->lts.ww);
+		(void) printf("WW=%lu", ts->ww);
 		if (Ffield)
 		    putchar(Terminator);
 		ps++;
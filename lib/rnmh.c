@@ -264,19 +264,19 @@ ncache_isroot(na, cp)
 	 * The vnode tests failed.  Try the inode tests.
 	 */
 	    if (Lf->inp_ty != 1 || !Lf->inode
-	    ||  !Lf->fsdir || (len = strlen(Lf->fsdir)) < 1)
+	    ||  !LFCOLD(Lf)->fsdir || (len = strlen(LFCOLD(Lf)->fsdir)) < 1)
 		return(0);
 	    if ((len + 1 + strlen(cp) + 1) > sizeof(buf))
 		return(0);
 	    for (mtp = readmnt(); mtp; mtp = mtp->next) {
 		if (!mtp->dir || !mtp->inode)
 		    continue;
-		if (strcmp(Lf->fsdir, mtp->dir) == 0)
+		if (strcmp(LFCOLD(Lf)->fsdir, mtp->dir) == 0)
 		    break;
 	    }
 	    if (!mtp)
 		return(0);
-	    (void) strcpy(buf, Lf->fsdir);
+	    (void) strcpy(buf, LFCOLD(Lf)->fsdir);
 	    if (buf[len - 1] != '/')
 		buf[len++] = '/';
 	    (void) strcpy(&buf[len], cp);
@@ -688,14 +688,14 @@ ncache_lookup(buf, blen, fp)
 	 * If the node has no cache entry, see if it's the mount
 	 * point of a known file system.
 	 */
-	    if (!Lf->fsdir || !Lf->dev_def || Lf->inp_ty != 1)
+	    if (!LFCOLD(Lf)->fsdir || !Lf->dev_def || Lf->inp_ty != 1)
 		return((char *)NULL);
 	    for (mtp = readmnt(); mtp; mtp = mtp->next) {
 		if (!mtp->dir || !mtp->inode)
 		    continue;
 		if (Lf->dev == mtp->dev
 		&&  mtp->inode == Lf->inode
-		&&  (strcmp(mtp->dir, Lf->fsdir) == 0))
+		&&  (strcmp(mtp->dir, LFCOLD(Lf)->fsdir) == 0))
 		    return(cp);
 	    }
 	    return((char *)NULL);
@@ -54,11 +54,24 @@
 # endif	/* defined(HASSETLOCALE) */
 
 #include <netdb.h>
+
+# if	defined(HASPARHOSTRSLV) || defined(HASPARDIRWALK) \
+ ||	defined(HASDOINTHREAD)
+#include <pthread.h>
+#include <signal.h>
+# endif	/* defined(HASPARHOSTRSLV) || defined(HASPARDIRWALK)
+	|| defined(HASDOINTHREAD) */
+
 #include <pwd.h>
 #include <stdio.h>
 
+# if	defined(HASDOINTHREAD)
+#include <sys/mman.h>
+# endif	/* defined(HASDOINTHREAD) */
+
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <time.h>
 
 
 /*
@@ -349,7 +362,7 @@ static struct utmp dummy_utmp;		/* to get login name length */
 # endif	/* defined(HASIPv6) */
 
 #define	MAXDCPATH	4		/* paths in DCpath[] */
-#define	MAXNWAD		100		/* maximum network addresses */
+#define	MAXNWAD		65536		/* maximum network addresses */
 
 # if	!defined(MEMMOVE)
 #define	MEMMOVE		memmove
@@ -424,6 +437,8 @@ static struct utmp dummy_utmp;		/* to get login name length */
 # endif	/* !defined(USELOCALREADDIR) */
 
 #define	RPTTM		15		/* default repeat seconds */
+#define	RPTTMMS		1000		/* repeat time units per second --
+					 * RptTm is in milliseconds */
 #define	RTD		" rtd"		/* root directory fd name */
 #define	TASKCMDL	9		/* maximum number of characters from
 					 * command name to print in TASKCMD
@@ -550,9 +565,10 @@ extern int ZoneColW;
 					 * cleared in link_lfile() */
 #define	SELEVTFDINFO	0x200000	/* selected for evetnfd info;
 					 * cleared in link_lfile() */
+#define	SELCGRP		0x400000	/* select cgroup (-G) */
 
-#define	SELALL		(SELCMD|SELCNTX|SELFD|SELNA|SELNET|SELNM|SELNFS|SELPID|SELUID|SELUNX|SELZONE|SELTASK)
-#define	SELPROC		(SELCMD|SELCNTX|SELPGID|SELPID|SELUID|SELZONE|SELTASK)
+#define	SELALL		(SELCGRP|SELCMD|SELCNTX|SELFD|SELNA|SELNET|SELNM|SELNFS|SELPID|SELUID|SELUNX|SELZONE|SELTASK)
+#define	SELPROC		(SELCGRP|SELCMD|SELCNTX|SELPGID|SELPID|SELUID|SELZONE|SELTASK)
 					/* process selecters */
 #define	SELFILE		(SELFD|SELNFS|SELNLINK|SELNM)	/* file selecters */
 #define	SELNW		(SELNA|SELNET|SELUNX)		/* network selecters */
@@ -600,6 +616,8 @@ typedef struct efsys_list {
 					 * blocks are to be eliminated */
 	int pathl;			/* path length */
 	int rdlnk;			/* avoid readlink(2) if non-zero */
+	int hung;			/* the file system was quarantined
+					 * after a safe stat(2) timed out */
 	struct mounts *mp;		/* local mount table entry pointer */
 	struct efsys_list *next;	/* next efsys_list entry pointer */
 } efsys_list_t;
@@ -637,6 +655,27 @@ struct seluid {
 					 * (meaningful only if excl == 0) */
 };
 
+/*
+ * A selection ID index is an open addressing hash table that maps a PID,
+ * PGID or UID to its Spid[], Spgid[] or Suid[] entry.
+ */
+
+#define	SELIDXMIN	64		/* initial selection ID index slots --
+					 * MUST BE A POWER OF 2! */
+#define	SELIDHASH(id, sz)	((int)((((id) ^ ((id) >> 16)) * 0x45d9f3bUL) \
+				       & ((sz) - 1)))
+					/* selection ID hash */
+
+struct selidx {
+	struct selident {
+	    unsigned long id;		/* PID, PGID or UID */
+	    int ix;			/* its selection table index;
+					 * -1 = empty slot */
+	} *t;				/* slots */
+	int n;				/* slots used */
+	int sz;				/* slot count */
+};
+
 # if	defined(HASBLKDEV)
 extern struct l_dev *BDevtp, **BSdev;
 extern int BNdev;
@@ -666,6 +705,33 @@ extern cntxlist_t *CntxArg;
 extern int CntxStatus;
 # endif	/* defined(HASSELINUX) */
 
+# if	defined(HASCGROUP)
+typedef struct cgrplist {
+	char *cg;			/* cgroup name, as specified */
+	char *path;			/* cgroup directory path */
+	int f;				/* "find" flag */
+	int r;				/* include descendant cgroups (+G) */
+	struct cgrplist *next;		/* next cgroup argument */
+} cgrplist_t;
+extern cgrplist_t *CgrpArg;
+# endif	/* defined(HASCGROUP) */
+
+# if	defined(HASDIRPFX)
+struct dirpfx {
+	char *aname;			/* argument directory name */
+	char *name;			/* directory name (after readlink()) */
+	size_t nl;			/* strlen(name) */
+	dev_t dev;			/* directory device */
+	dev_t *xdev;			/* devices of file systems mounted
+					 * below name (for -x f) */
+	int nxdev;			/* number of xdev[] entries */
+	int xdevs;			/* xdev[] status: 0 = not built */
+	int f;				/* "find" flag */
+	struct dirpfx *next;		/* forward link */
+};
+extern struct dirpfx *Dirpfx;
+# endif	/* defined(HASDIRPFX) */
+
 # if	defined(HASDCACHE)
 extern unsigned DCcksum;
 extern int DCfd;
@@ -755,6 +821,9 @@ struct fieldsel {
 };
 extern struct fieldsel FieldSel[];
 
+extern struct selidx HbySpgid;
+extern struct selidx HbySpid;
+extern struct selidx HbySuid;
 extern int Hdr;
 
 enum IDType {PGID, PID};
@@ -763,9 +832,123 @@ extern char *InodeFmt_d;
 extern char *InodeFmt_x;
 extern int LastPid;
 
+struct linaddr {			/* local Internet address information */
+	int af;				/* address family: 0 for none; AF_INET;
+					 * or AF_INET6 */
+	int p;				/* port */
+	union {
+	    struct in_addr a4;		/* AF_INET Internet address */
+
+# if	defined(HASIPv6)
+	    struct in6_addr a6;		/* AF_INET6 Internet address */
+# endif	/* defined(HASIPv6) */
+
+	} ia;
+};
+
+struct ltstate {			/* local TCP/TPI state */
+	int type;			/* state type:
+					 *   -1 == none
+					 *    0 == TCP
+					 *    1 == TPI or socket (SS_*) */
+	union {
+	    int i;			/* integer state */
+	    unsigned int ui;		/* unsigned integer state */
+	} state;
+
+# if	defined(HASSOOPT)
+	unsigned char pqlens;		/* pqlen status: 0 = none */
+	unsigned char qlens;		/* qlen status:  0 = none */
+	unsigned char qlims;		/* qlim status:  0 = none */
+	unsigned char rbszs;		/* rbsz status:  0 = none */
+	unsigned char sbszs;		/* sbsz status:  0 = none */
+	int kai;			/* TCP keep-alive interval */
+	int ltm;			/* TCP linger time */
+	unsigned int opt;		/* socket options */
+	unsigned int pqlen;		/* partial connection queue length */
+	unsigned int qlen;		/* connection queue length */
+	unsigned int qlim;		/* connection queue limit */
+	unsigned long rbsz;		/* receive buffer size */
+	unsigned long sbsz;		/* send buffer size */
+# endif	/* defined(HASSOOPT) */
+
+# if	defined(HASSOSTATE)
+	unsigned int ss;		/* socket state */
+#  if	defined(HASSBSTATE)
+	unsigned int sbs_rcv;		/* receive socket buffer state */
+	unsigned int sbs_snd;		/* send socket buffer state */
+#  endif	/* defined(HASSBSTATE) */
+# endif	/* defined(HASSOSTATE) */
+
+# if	defined(HASTCPOPT)
+	unsigned int topt;		/* TCP options */
+	unsigned char msss;		/* mss status: 0 = none */
+	unsigned long mss;		/* TCP maximum segment size */
+# endif	/* defined(HASTCPOPT) */
+
+# if	defined(HASTCPTPIQ)
+	unsigned long rq;		/* receive queue length */
+	unsigned long sq;		/* send queue length */
+	unsigned char rqs;		/* rq status: 0 = none */
+	unsigned char sqs;		/* sq status: 0 = none */
+# endif	/* defined(HASTCPTPIQ) */
+
+# if	defined(HASTCPTPIW)
+	unsigned char rws;		/* rw status: 0 = none */
+	unsigned char wws;		/* ww status: 0 = none */
+	unsigned long rw;		/* read window size */
+	unsigned long ww;		/* write window size */
+# endif	/* defined(HASTCPTPIW) */
+
+};
+
+# if	defined(HASLFILECOLD)
+/*
+ * The rarely used parts of a local file structure are kept in a separate
+ * cold record.  Until a file needs to change them, its cold pointer
+ * addresses the shared, read-only Lfcold0 record of defaults; LFCOLDW()
+ * gives the file its own copy, carved from the process' arena.
+ */
+
+struct lfcold {
+	char *fsdir;			/* file system directory */
+	char *fsdev;			/* file system device */
+	struct linaddr li[2];		/* li[0]: local
+					 * li[1]: foreign */
+	struct ltstate lts;		/* local TCP/TPI state */
+
+#  if	defined(HASEPTOPTS)
+	int eventfd_id;			/* evntfd id taken from
+					   /proc/$pid/fdinfo */
+#   if	defined(HASPTYEPT)
+	int tty_index;			/* pseudoterminal index of slave side
+					 * (if this is the master side) */
+#   endif	/* defined(HASPTYEPT) */
+#  endif	/* defined(HASEPTOPTS) */
+
+#  if	defined(HASFSTRUCT)
+	KA_T fsa;			/* file structure address */
+	long fct;			/* file structure's f_count */
+	KA_T fna;			/* file structure node address */
+#  endif	/* defined(HASFSTRUCT) */
+
+};
+extern struct lfcold Lfcold0;
+
+#define	LFCOLD(lf)	((lf)->cold)	/* cold record, for reading */
+#define	LFCOLDW(lf)	(((lf)->cold == &Lfcold0) ? alloc_lfcold(lf) \
+					     : (lf)->cold)
+					/* cold record, for writing */
+# else	/* !defined(HASLFILECOLD) */
+#define	LFCOLD(lf)	(lf)
+#define	LFCOLDW(lf)	(lf)
+# endif	/* defined(HASLFILECOLD) */
+
 struct lfile {
 	char access;
 	char lock;
+	char delta;			/* repeat delta mode change: '+', '-',
+					 * '~', or '\0' if unchanged */
 	unsigned char dev_def;		/* device number definition status */
 	unsigned char inp_ty;		/* inode/iproto type
 					 *	0: neither inode nor iproto
@@ -794,12 +977,14 @@ struct lfile {
 # if	defined(HASEPTOPTS)
 	unsigned char chend;		/* communication channel endpoint
 					 * file */
+#  if	!defined(HASLFILECOLD)
 	int eventfd_id;			/* evntfd id taken from
 					   /proc/$pid/fdinfo */
-#  if	defined(HASPTYEPT)
+#   if	defined(HASPTYEPT)
 	int tty_index;			/* pseudoterminal index of slave side
 					 * (if this is the master side) */
-#  endif	/* defined(HASPTYEPT) */
+#   endif	/* defined(HASPTYEPT) */
+#  endif	/* !defined(HASLFILECOLD) */
 # endif	/* defined(HASEPTOPTS) */
 
 	unsigned char rdev_def;		/* rdev definition status */
@@ -822,82 +1007,24 @@ struct lfile {
 	INODETYPE inode;
 	long nlink;			/* link count */
 	char *dev_ch;
+
+# if	defined(HASLFILECOLD)
+	struct lfcold *cold;		/* cold information */
+# else	/* !defined(HASLFILECOLD) */
 	char *fsdir;			/* file system directory */
 	char *fsdev;			/* file system device */
+# endif	/* defined(HASLFILECOLD) */
 
 # if	defined(HASFSINO)
 	INODETYPE fs_ino;		/* file system inode number */
 # endif	/* defined HASFSINO) */
 
-	struct linaddr {		/* local Internet address information */
-	    int af;			/* address family: 0 for none; AF_INET;
-					 * or AF_INET6 */
-	    int p;			/* port */
-	    union {
-		struct in_addr a4;	/* AF_INET Internet address */
-
-# if	defined(HASIPv6)
-		struct in6_addr a6;	/* AF_INET6 Internet address */
-# endif	/* defined(HASIPv6) */
-
-	    } ia;
-	} li[2];			/* li[0]: local
+# if	!defined(HASLFILECOLD)
+	struct linaddr li[2];		/* li[0]: local
 					 * li[1]: foreign */
-	struct ltstate {		/* local TCP/TPI state */
-	    int type;			/* state type:
-					 *   -1 == none
-					 *    0 == TCP
-					 *    1 == TPI or socket (SS_*) */
-	    union {
-		int i;			/* integer state */
-		unsigned int ui;	/* unsigned integer state */
-	    } state;
+	struct ltstate lts;		/* local TCP/TPI state */
+# endif	/* !defined(HASLFILECOLD) */
 
-# if	defined(HASSOOPT)
-	    unsigned char pqlens;	/* pqlen status: 0 = none */
-	    unsigned char qlens;	/* qlen status:  0 = none */
-	    unsigned char qlims;	/* qlim status:  0 = none */
-	    unsigned char rbszs;	/* rbsz status:  0 = none */
-	    unsigned char sbszs;	/* sbsz status:  0 = none */
-	    int kai;			/* TCP keep-alive interval */
-	    int ltm;			/* TCP linger time */
-	    unsigned int opt;		/* socket options */
-	    unsigned int pqlen;		/* partial connection queue length */
-	    unsigned int qlen;		/* connection queue length */
-	    unsigned int qlim;		/* connection queue limit */
-	    unsigned long rbsz;		/* receive buffer size */
-	    unsigned long sbsz;		/* send buffer size */
-# endif	/* defined(HASSOOPT) */
-
-# if	defined(HASSOSTATE)
-	    unsigned int ss;		/* socket state */
-#  if	defined(HASSBSTATE)
-	    unsigned int sbs_rcv;	/* receive socket buffer state */
-	    unsigned int sbs_snd;	/* send socket buffer state */
-#  endif	/* defined(HASSBSTATE) */
-# endif	/* defined(HASSOSTATE) */
-
-# if	defined(HASTCPOPT)
-	    unsigned int topt;		/* TCP options */
-	    unsigned char msss;		/* mss status: 0 = none */
-	    unsigned long mss;		/* TCP maximum segment size */
-# endif	/* defined(HASTCPOPT) */
-
-# if	defined(HASTCPTPIQ)
-	    unsigned long rq;		/* receive queue length */
-	    unsigned long sq;		/* send queue length */
-	    unsigned char rqs;		/* rq status: 0 = none */
-	    unsigned char sqs;		/* sq status: 0 = none */
-# endif	/* defined(HASTCPTPIQ) */
-
-# if	defined(HASTCPTPIW)
-	    unsigned char rws;		/* rw status: 0 = none */
-	    unsigned char wws;		/* ww status: 0 = none */
-	    unsigned long rw;		/* read window size */
-	    unsigned long ww;		/* write window size */
-# endif	/* defined(HASTCPTPIW) */
-
-	} lts;
 	char *nm;
 	char *nma;			/* NAME column addition */
 
@@ -914,11 +1041,14 @@ struct lfile {
 # endif	/* defined(HASLFILEADD) */
 
 # if	defined(HASFSTRUCT)
+#  if	!defined(HASLFILECOLD)
 	KA_T fsa;			/* file structure address */
 	long fct;			/* file structure's f_count */
+	KA_T fna;			/* file structure node address */
+#  endif	/* !defined(HASLFILECOLD) */
+
 	long ffg;			/* file structure's f_flag */
 	long pof;			/* process open-file flags */
-	KA_T fna;			/* file structure node address */
 # endif	/* defined(HASFSTRUCT) */
 
 	struct lfile *next;
@@ -926,6 +1056,30 @@ struct lfile {
 extern struct lfile *Lf, *Plf;
 
 
+# if	defined(HASLPARENA)
+/*
+ * A process' arena is a list of chunks from which the lfile structures of
+ * the process and their strings are carved.  The whole arena is freed at
+ * once by free_lproc().
+ */
+
+#define	LPAALIGN	8		/* arena allocation alignment */
+#define	LPAMIN		4096		/* first arena chunk data size */
+#define	LPAMAX		(256 * 1024)	/* maximum arena chunk data size (larger
+					 * requests get their own chunk) */
+#define	LPASTATSENV	"LSOFARENASTATS"
+					/* environment variable that requests
+					 * arena statistics at exit */
+
+struct lpachunk {
+	struct lpachunk *next;		/* next (older) chunk */
+	unsigned long ser;		/* arena serial number */
+	MALLOC_S sz;			/* chunk data size */
+	MALLOC_S used;			/* chunk data bytes used */
+};				/* followed by the chunk data */
+# endif	/* defined(HASLPARENA) */
+
+
 struct lproc {
 	char *cmd;			/* command name */
  
@@ -933,7 +1087,7 @@ struct lproc {
 	char *cntx;			/* security context */
 # endif	/* defined(HASSELINUX) */
 
-	short sf;			/* select flags -- SEL* symbols */
+	int sf;				/* select flags -- SEL* symbols */
 	short pss;			/* state: 0 = not selected
 				 	 *	  1 = wholly selected
 				 	 *	  2 = partially selected */
@@ -956,6 +1110,16 @@ struct lproc {
 	char *zn;			/* zone name */
 # endif	/* defined(HASZONES) */
 
+# if	defined(HASLPARENA)
+	struct lpachunk *arena;		/* arena of the process' files and
+					 * strings (newest chunk first) */
+# endif	/* defined(HASLPARENA) */
+
+# if	defined(HASMNTNS)
+	struct mntns *mntns;		/* mount namespace (NULL = not yet
+					 * found) -- see find_mntdev() */
+# endif	/* defined(HASMNTNS) */
+
 	struct lfile *file;		/* open files of process */
 };
 extern struct lproc *Lp, *Lproc;
@@ -1010,6 +1174,8 @@ struct nwad {
 	int sport;			/* starting port */
 	int eport;			/* ending port */
 	int f;				/* find state */
+	int ix;				/* Nwad list position, set by
+					 * index_nwad() */
 	struct nwad *next;		/* forward link */
 };
 extern struct nwad *Nwad;
@@ -1041,6 +1207,12 @@ extern int Procsrch;
 # endif	/* defined(HASPROCFS) */
 
 extern int PrPass;
+extern int RptDelta;
+
+# if	defined(HASPROCEVT)
+extern int RptPev;
+# endif	/* defined(HASPROCEVT) */
+
 extern int RptTm;
 extern int RptMaxCount;
 extern struct l_dev **Sdev;
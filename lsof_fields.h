@@ -181,4 +181,8 @@
 #define	LSOF_FIX_TERM		30
 #define	LSOF_FNM_TERM		"(zero) use NUL field terminator instead of NL"
 
+#define	LSOF_FID_DELTA		'e'
+#define	LSOF_FIX_DELTA		31
+#define	LSOF_FNM_DELTA		"repeat delta change: + added, - removed, ~ changed"
+
 #endif	/* !defined(LSOF_FORMAT_H) */
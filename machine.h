@@ -0,0 +1 @@
+dialects/linux/machine.h
\ No newline at end of file
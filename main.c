@@ -49,9 +49,21 @@ static char GOp;			/* option prefix -- '+' or '-' */
 static char *GOv = (char *)NULL;	/* option `:' value pointer */
 static int GOx1 = 1;			/* first opt[][] index */
 static int GOx2 = 0;			/* second opt[][] index */
+static struct lproc *Dlproc = (struct lproc *)NULL;
+					/* delta mode's previous cycle
+					 * processes, sorted by PID */
+static int Dlproca = 0;			/* Dlproc[] entries allocated */
+static int Dlprocn = 0;			/* Dlproc[] entries used */
 
 
+_PROTOTYPE(static int cmp_delta,(struct lfile *f1, struct lfile *f2));
+_PROTOTYPE(static int comp_dkey,(COMP_P *a1, COMP_P *a2));
+_PROTOTYPE(static int diff_delta,(struct lproc *cp, struct lproc *pp));
 _PROTOTYPE(static int GetOpt,(int ct, char *opt[], char *rules, int *err));
+_PROTOTYPE(static int print_delta,(struct lproc **slp));
+_PROTOTYPE(static void rptwait,(struct timespec *dl));
+_PROTOTYPE(static int sort_delta,(struct lproc *lp, struct lfile ***fa,
+				  int *faa));
 _PROTOTYPE(static char *sv_fmt_str,(char *f));
 
 
@@ -78,6 +90,7 @@ main(argc, argv)
 	int rc = 0;
 	struct stat sb;
 	struct sfile *sfp;
+	struct timespec rdl;
 	struct lproc **slp = (struct lproc **)NULL;
 	int sp = 0;
 	struct str_lst *str, *strt;
@@ -94,6 +107,14 @@ main(argc, argv)
 	znhash_t *zp;
 #endif	/* defined(HASZONES) */
 
+#if	defined(HASCGROUP)
+	cgrplist_t *cgp;
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASDIRPFX)
+	struct dirpfx *dp;
+#endif	/* defined(HASDIRPFX) */
+
 #if	defined(HASSELINUX)
 /*
  * This stanza must be immediately before the "Save progam name." code, since
@@ -164,7 +185,7 @@ main(argc, argv)
  * Create option mask.
  */
 	(void) snpf(options, sizeof(options),
-	    "?a%sbc:%sD:d:%s%sf:F:g:hi:%s%slL:%s%snNo:Op:Pr:%ss:S:tT:u:UvVwx:%s%s%s",
+	    "?a%s%sbc:%sD:d:%s%sf:F:g:%shi:%s%slL:%s%snNo:Op:Pr:%ss:S:tT:u:UvVwx:%s%s%s",
 
 #if	defined(HAS_AFS) && defined(HASAOPT)
 	    "A:",
@@ -172,6 +193,12 @@ main(argc, argv)
 	    "",
 #endif	/* defined(HAS_AFS) && defined(HASAOPT) */
 
+#if	defined(HASDIRPFX)
+	    "B:",
+#else	/* !defined(HASDIRPFX) */
+	    "",
+#endif	/* defined(HASDIRPFX) */
+
 #if	defined(HASNCACHE)
 	    "C",
 #else	/* !defined(HASNCACHE) */
@@ -190,6 +217,12 @@ main(argc, argv)
 	    "",
 #endif	/* defined(HASEPTOPTS) */
 
+#if	defined(HASCGROUP)
+	    "G:",
+#else	/* !defined(HASCGROUP) */
+	    "",
+#endif	/* defined(HASCGROUP) */
+
 #if	defined(HASKOPT)
 	    "k:",
 #else	/* !defined(HASKOPT) */
@@ -273,6 +306,23 @@ main(argc, argv)
 	    case 'b':
 		Fblock = 1;
 		break;
+
+#if	defined(HASDIRPFX)
+	    case 'B':
+		if (GOp == '+') {
+		    if (enter_dir_pfx(GOv))
+			err = 1;
+		    else {
+			Selflags |= SELNM;
+			xover = 1;
+		    }
+		} else {
+		    (void) fprintf(stderr, "%s: -B not supported\n", Pn);
+		    err = 1;
+		}
+		break;
+#endif	/* defined(HASDIRPFX) */
+
 	    case 'c':
 		if (GOp == '+') {
 		    if (!GOv || (*GOv == '-') || (*GOv == '+')
@@ -579,6 +629,14 @@ main(argc, argv)
 		}
 		Fpgid = 1;
 		break;
+
+#if	defined(HASCGROUP)
+	    case 'G':
+		if (enter_cgrp_arg(GOv, (GOp == '+') ? 1 : 0))
+		    err = 1;
+		break;
+#endif	/* defined(HASCGROUP) */
+
 	    case 'h':
 	    case '?':
 		Fhelp = 1;
@@ -766,7 +824,7 @@ main(argc, argv)
 		if (GOp == '+')
 		    ev = rc = 1;
 		if (!GOv || *GOv == '-' || *GOv == '+') {
-		    RptTm = RPTTM;
+		    RptTm = RPTTM * RPTTMMS;
 		    if (GOv) {
 			GOx1 = GObk[0];
 			GOx2 = GObk[1];
@@ -779,10 +837,23 @@ main(argc, argv)
 		    i = (i * 10) + ((int)*cp - '0');
 		    n++;
 		}
+		l = (long)i * RPTTMMS;
+		if ((*cp == '.') && isdigit((unsigned char)*(cp + 1))) {
+
+		/*
+		 * Add a fraction of a second, to millisecond precision.
+		 */
+		    for (cp++, n++, i = RPTTMMS / 10; *cp; cp++, n++) {
+			if (!isdigit((unsigned char)*cp))
+			    break;
+			l += (long)(i * ((int)*cp - '0'));
+			i /= 10;
+		    }
+		}
 		if (n)
-		    RptTm = i;
+		    RptTm = (int)l;
 		else
-		    RptTm = RPTTM;
+		    RptTm = RPTTM * RPTTMMS;
 		if (!*cp)
 		     break;
 		while(*cp && (*cp == ' '))
@@ -795,11 +866,35 @@ main(argc, argv)
 			 cp++)
 			i = (i * 10) + ((int)*cp - '0');
 		    RptMaxCount = i;
+		    if (!*cp)
+			break;
 		}
+		if (*cp == 'd') {
+
+		/*
+		 * Select delta output.
+		 */
+		    RptDelta = 1;
+		    FieldSel[LSOF_FIX_DELTA].st = 1;
+		    if (!*++cp)
+			break;
+		}
+
+#if	defined(HASPROCEVT)
+		if (*cp == 'p') {
+
+		/*
+		 * Find changed processes from kernel process events.
+		 */
+		    RptPev = 1;
+		    if (!*++cp)
+			break;
+		}
+#endif	/* defined(HASPROCEVT) */
 
 		if (*cp != LSOF_FID_MARK) {
 		    GOx1 = GObk[0];
-		    GOx2 = GObk[1] + n;
+		    GOx2 = GObk[1] + (int)(cp - GOv);
 		    break;
 		}
 
@@ -1094,6 +1189,11 @@ main(argc, argv)
 		Pn);
 	    err++;
 	}
+	if (RptDelta && !Ffield) {
+	    (void) fprintf(stderr,
+		"%s: -r d (delta output) requires -F\n", Pn);
+	    err++;
+	}
 	if (Ffield) {
 	    if (Fterse) {
 		(void) fprintf(stderr,
@@ -1182,6 +1282,11 @@ main(argc, argv)
 	    Selflags |= SELCNTX;
 #endif	/* defined(HASSELINUX) */
 
+#if	defined(HASCGROUP)
+	if (CgrpArg)
+	    Selflags |= SELCGRP;
+#endif	/* defined(HASCGROUP) */
+
 	if (Fdl)
 	    Selflags |= SELFD;
 	if (Fnet)
@@ -1196,8 +1301,10 @@ main(argc, argv)
 	    Selflags |= SELPID;
 	if (Nuid && Nuidincl)
 	    Selflags |= SELUID;
-	if (Nwad)
+	if (Nwad) {
 	    Selflags |= SELNA;
+	    (void) index_nwad();
+	}
 
 #if	defined(HASZONES)
 	if (ZoneArg)
@@ -1302,10 +1409,16 @@ main(argc, argv)
 #endif	/* defined(HASMNTSUP) */
 
 /*
- * Gather and report process information every RptTm seconds.
+ * Gather and report process information every RptTm milliseconds.
  */
-	if (RptTm)
+	if (RptTm) {
 	    CkPasswd = 1;
+
+#if	defined(HAS_CLOCK_NANOSLEEP)
+	    (void) clock_gettime(CLOCK_MONOTONIC, &rdl);
+#endif	/* defined(HAS_CLOCK_NANOSLEEP) */
+
+	}
 	do {
 
 	/*
@@ -1355,141 +1468,65 @@ main(argc, argv)
 	     */
 		if (FeptE) {
 		    lf = Lf;
-		/*
-		 * Scan all selected processes.
-		 */
-		    for (i = 0; i < Nlproc; i++) {
-			Lp = (Nlproc > 1) ? slp[i] : &Lproc[i];
-
-			/*
-			 * For processes that have been selected for printing
-			 * and have files that are the end point(s) of pipe(s),
-			 * process the file endpoints.
-			 */
-			    if (Lp->pss && (Lp->ept & EPT_PIPE))
-				(void) process_pinfo(0);
-			/*
-			 * Process POSIX MQ endpoints.
-			 */
-			    if (Lp->ept & EPT_PSXMQ)
-			      (void) process_psxmqinfo(0);
-
-# if	defined(HASUXSOCKEPT)
-			/*
-			 * For processes that have been selected for printing
-			 * and have files that are the end point(s) of UNIX
-			 * socket(s), process the file endpoints.
-			 */
-			    if (Lp->pss && (Lp->ept & EPT_UXS))
-				(void) process_uxsinfo(0);
-# endif	/* defined(HASUXSOCKEPT) */
-
-# if	defined(HASPTYEPT)
-			/*
-			 * For processes that have been selected for printing
-			 * and have files that are the end point(s) of pseudo-
-			 * terminal files(s), process the file endpoints.
-			 */
-			    if (Lp->pss && (Lp->ept & EPT_PTY))
-				(void) process_ptyinfo(0);
-# endif	/* defined(HASPTYEPT) */
-
-			/*
-			 * Process INET socket endpoints.
-			 */
-			    if (Lp->ept & EPT_NETS)
-				(void) process_netsinfo(0);
-
-# if	defined(HASIPv6)
-			/*
-			 * Process INET6 socket endpoints.
-			 */
-			    if (Lp->ept & EPT_NETS6)
-				(void) process_nets6info(0);
-# endif	/* defined(HASIPv6) */
-			/*
-			 * Process eventfd endpoints.
-			 */
-			    if (Lp->ept & EPT_EVTFD)
-				(void) process_evtfdinfo(0);
-		    }
-		/*
-		 * In a second pass, look for unselected endpoint files,
-		 * possibly selecting them for printing.
-		 */
-		    for (i = 0; i < Nlproc; i++) {
-			Lp = (Nlproc > 1) ? slp[i] : &Lproc[i];
-
-			/*
-			 * Process pipe endpoints.
-			 */
-			    if (Lp->ept & EPT_PIPE_END)
-				(void) process_pinfo(1);
-			/*
-			 * Process POSIX MQ endpoints.
-			 */
-			    if (Lp->ept & EPT_PSXMQ_END)
-			      (void) process_psxmqinfo(1);
-
-# if	defined(HASUXSOCKEPT)
-			/*
-			 * Process UNIX socket endpoints.
-			 */
-			    if (Lp->ept & EPT_UXS_END)
-				(void) process_uxsinfo(1);
-# endif	/* defined(HASUXSOCKEPT) */
-
-# if	defined(HASPTYEPT)
-			/*
-			 * Process pseudo-terminal endpoints.
-			 */
-			    if (Lp->ept & EPT_PTY_END)
-				(void) process_ptyinfo(1);
-# endif	/* defined(HASPTYEPT) */
-
-			/*
-			 * Process INET socket endpoints.
-			 */
-			    if (Lp->ept & EPT_NETS_END)
-				(void) process_netsinfo(1);
-
-#if	defined(HASIPv6)
-			/*
-			 * Process INET6 socket endpoints.
-			 */
-			    if (Lp->ept & EPT_NETS6_END)
-				(void) process_nets6info(1);
-# endif	/* defined(HASIPv6) */
-
-			/*
-			 * Process envetfd endpoints.
-			 */
-			    if (Lp->ept & EPT_EVTFD_END)
-				(void) process_evtfdinfo(1);
-		    }
+		    (void) process_epts();
 		    Lf = lf;
 		}
 #endif	/* defined(HASEPTOPTS) */
 
+#if	defined(HASPARHOSTRSLV)
+	    /*
+	     * If host names are to be printed, look them up in parallel now,
+	     * so that printing doesn't wait for them one at a time.
+	     */
+		if (Fhost && !Fterse)
+		    (void) lkup_hostnms();
+#endif	/* defined(HASPARHOSTRSLV) */
+
 	    /*
 	     * Print the selected processes and count them.
 	     *
 	     * Lf contents must be preserved, since they may point to a
 	     * malloc()'d area, and since Lf is used throughout the print
 	     * process.
+	     *
+	     * In delta mode print only the files that changed since the
+	     * previous cycle.
 	     */
-		for (lf = Lf, print_init(); PrPass < 2; PrPass++) {
-		    for (i = n = 0; i < Nlproc; i++) {
-			Lp = (Nlproc > 1) ? slp[i] : &Lproc[i];
-			if (Lp->pss) {
-			    if (print_proc())
-				n++;
+		lf = Lf;
+		if (RptDelta)
+		    n = print_delta(slp);
+		else {
+		    for (print_init(); PrPass < 2; PrPass++) {
+			for (i = n = 0; i < Nlproc; i++) {
+			    Lp = (Nlproc > 1) ? slp[i] : &Lproc[i];
+			    if (Lp->pss) {
+				if (print_proc())
+				    n++;
+			    }
+			    if (RptTm && PrPass) {
+
+#if	defined(HASRPTINCR)
+			    /*
+			     * Save the process' files for reuse in the next
+			     * repeat cycle.
+			     */
+				(void) save_lproc(Lp);
+#endif	/* defined(HASRPTINCR) */
+
+				(void) free_lproc(Lp);
+			    }
 			}
-			if (RptTm && PrPass)
-			    (void) free_lproc(Lp);
 		    }
 		}
 		Lf = lf;
+	    } else if (RptDelta) {
+
+	    /*
+	     * Report the previous cycle's files as removed.
+	     */
+		lf = Lf;
+		(void) print_delta(slp);
+		Lf = lf;
 	    }
 	/*
 	 * If a repeat time is set, sleep for the specified time.
@@ -1562,7 +1599,7 @@ main(argc, argv)
 		}
 		(void) fflush(stdout);
 		(void) childx();
-		(void) sleep(RptTm);
+		(void) rptwait(&rdl);
 		Hdr = Nlproc = 0;
 		CkPasswd = 1;
 	    }
@@ -1616,6 +1653,23 @@ main(argc, argv)
 	    }
 	}
 
+#if	defined(HASDIRPFX)
+	for (dp = Dirpfx; dp; dp = dp->next) {
+
+	/*
+	 * Check +B directory specifications.
+	 */
+	    if (dp->f)
+		continue;
+	    rv = 1;
+	    if (Fverbose) {
+		(void) printf("%s: no file use located: ", Pn);
+		safestrprt(dp->aname, stdout, 1);
+	    }
+	}
+#endif	/* defined(HASDIRPFX) */
+
+
 #if	defined(HASPROCFS)
 	/*
 	 * Report on proc file system search results.
@@ -1797,6 +1851,24 @@ main(argc, argv)
 	}
 #endif	/* defined(HASSELINUX) */
 
+#if	defined(HASCGROUP)
+	if (CgrpArg) {
+
+	/*
+	 * Check cgroup argument results.
+	 */
+	    for (cgp = CgrpArg; cgp; cgp = cgp->next) {
+		if (!cgp->f) {
+		    rv = 1;
+		    if (Fverbose) {
+			(void) printf("%s: cgroup not located: ", Pn);
+			safestrprt(cgp->cg, stdout, 1);
+		    }
+		}
+	    }
+	}
+#endif	/* defined(HASCGROUP) */
+
 	for (i = 0; i < Npgid; i++) {
 
 	/*
@@ -1964,6 +2036,355 @@ GetOpt(ct, opt, rules, err)
 }
 
 
+/*
+ * cmp_delta() - compare the reported state of a file in two repeat cycles
+ *
+ * return: 1 = the state differs
+ *	   0 = it's the same
+ */
+
+static int
+cmp_delta(f1, f2)
+	struct lfile *f1;		/* this cycle's file */
+	struct lfile *f2;		/* previous cycle's file */
+{
+	int i;
+	MALLOC_S len;
+
+	if ((f1->access != f2->access)
+	||  (f1->lock != f2->lock)
+	||  strcmp(f1->type, f2->type)
+	||  (f1->sz_def != f2->sz_def)
+	||  (f1->sz_def && (f1->sz != f2->sz))
+	||  (f1->off_def != f2->off_def)
+	||  (f1->off_def && (f1->off != f2->off))
+	||  (f1->nlink_def != f2->nlink_def)
+	||  (f1->nlink_def && (f1->nlink != f2->nlink))
+	||  (LFCOLD(f1)->lts.type != LFCOLD(f2)->lts.type)
+	||  ((LFCOLD(f1)->lts.type >= 0)
+	&&   (LFCOLD(f1)->lts.state.i != LFCOLD(f2)->lts.state.i)))
+	    return(1);
+	if ((!f1->nm != !f2->nm) || (f1->nm && strcmp(f1->nm, f2->nm))
+	||  (!f1->nma != !f2->nma) || (f1->nma && strcmp(f1->nma, f2->nma)))
+	    return(1);
+	for (i = 0; i < 2; i++) {
+	    if (LFCOLD(f1)->li[i].af != LFCOLD(f2)->li[i].af)
+		return(1);
+	    switch (LFCOLD(f1)->li[i].af) {
+	    case AF_INET:
+		len = (MALLOC_S)sizeof(struct in_addr);
+		break;
+
+#if	defined(HASIPv6)
+	    case AF_INET6:
+		len = (MALLOC_S)sizeof(struct in6_addr);
+		break;
+#endif	/* defined(HASIPv6) */
+
+	    default:
+		continue;
+	    }
+	    if ((LFCOLD(f1)->li[i].p != LFCOLD(f2)->li[i].p)
+	    ||  memcmp((void *)&LFCOLD(f1)->li[i].ia,
+		       (void *)&LFCOLD(f2)->li[i].ia, len))
+		return(1);
+	}
+	return(0);
+}
+
+
+/*
+ * comp_dkey() - compare the delta mode keys of two files for qsort()
+ *
+ * The key is the file descriptor, the device number and the inode number.
+ */
+
+static int
+comp_dkey(a1, a2)
+	COMP_P *a1, *a2;
+{
+	struct lfile *f1 = *(struct lfile **)a1;
+	struct lfile *f2 = *(struct lfile **)a2;
+	dev_t d1, d2;
+	INODETYPE i1, i2;
+	int r;
+
+	if ((r = strcmp(f1->fd, f2->fd)))
+	    return(r);
+	d1 = f1->dev_def ? f1->dev : (dev_t)0;
+	d2 = f2->dev_def ? f2->dev : (dev_t)0;
+	if (d1 != d2)
+	    return((d1 < d2) ? -1 : 1);
+	i1 = (f1->inp_ty == 1 || f1->inp_ty == 3) ? f1->inode : (INODETYPE)0;
+	i2 = (f2->inp_ty == 1 || f2->inp_ty == 3) ? f2->inode : (INODETYPE)0;
+	if (i1 != i2)
+	    return((i1 < i2) ? -1 : 1);
+	return(0);
+}
+
+
+/*
+ * diff_delta() - mark the files of a process that changed since the previous
+ *		  repeat cycle
+ *
+ * return: the number of files selected in this cycle
+ */
+
+static int
+diff_delta(cp, pp)
+	struct lproc *cp;		/* this cycle's process (may be NULL) */
+	struct lproc *pp;		/* previous cycle's process (may be
+					 * NULL) */
+{
+	int c, i, j, cn, pn;
+	static struct lfile **cf = (struct lfile **)NULL;
+	static int cfa = 0;
+	static struct lfile **pf = (struct lfile **)NULL;
+	static int pfa = 0;
+
+	cn = sort_delta(cp, &cf, &cfa);
+	pn = sort_delta(pp, &pf, &pfa);
+/*
+ * Merge the key-sorted file lists.  Files only in this cycle were added;
+ * files only in the previous cycle were removed; files in both are changed
+ * if their reported state differs.
+ */
+	for (i = j = 0; (i < cn) || (j < pn);) {
+	    if ((i < cn) && (j < pn))
+		c = comp_dkey((COMP_P *)&cf[i], (COMP_P *)&pf[j]);
+	    else
+		c = (i < cn) ? -1 : 1;
+	    if (c < 0)
+		cf[i++]->delta = '+';
+	    else if (c > 0)
+		pf[j++]->delta = '-';
+	    else {
+		if (cmp_delta(cf[i], pf[j]))
+		    cf[i]->delta = '~';
+		i++;
+		j++;
+	    }
+	}
+	return(cn);
+}
+
+
+/*
+ * print_delta() - print the files that changed since the previous repeat
+ *		   cycle
+ *
+ * return: the number of this cycle's processes with selected files
+ */
+
+static int
+print_delta(slp)
+	struct lproc **slp;		/* PID-sorted process pointers (used
+					 * when Nlproc > 1) */
+{
+	int c, i, j, n;
+	struct lproc *cp, *pp;
+	MALLOC_S len;
+
+	print_init();
+/*
+ * Walk this cycle's and the previous cycle's PID-sorted processes together,
+ * printing each process' added and changed files, then its removed ones.
+ */
+	for (i = j = n = 0; (i < Nlproc) || (j < Dlprocn);) {
+	    cp = (i < Nlproc) ? ((Nlproc > 1) ? slp[i] : &Lproc[i])
+			      : (struct lproc *)NULL;
+	    pp = (j < Dlprocn) ? &Dlproc[j] : (struct lproc *)NULL;
+	    if (cp && pp)
+		c = comppid((COMP_P *)&cp, (COMP_P *)&pp);
+	    else
+		c = cp ? -1 : 1;
+	    if (c > 0)
+		cp = (struct lproc *)NULL;
+	    else
+		i++;
+	    if (c < 0)
+		pp = (struct lproc *)NULL;
+	    else
+		j++;
+	    if (diff_delta(cp, pp))
+		n++;
+	    if (cp) {
+		Lp = cp;
+		(void) print_proc();
+	    }
+	    if (pp) {
+		Lp = pp;
+		(void) print_proc();
+	    }
+	}
+/*
+ * Replace the previous cycle's processes with this cycle's.
+ */
+	for (j = 0; j < Dlprocn; j++) {
+	    (void) free_lproc(&Dlproc[j]);
+	}
+	if (Nlproc > Dlproca) {
+	    Dlproca = Nlproc;
+	    len = (MALLOC_S)(Dlproca * sizeof(struct lproc));
+	    if (Dlproc)
+		Dlproc = (struct lproc *)realloc((MALLOC_P *)Dlproc, len);
+	    else
+		Dlproc = (struct lproc *)malloc(len);
+	    if (!Dlproc) {
+		(void) fprintf(stderr,
+		    "%s: no space for %d delta processes\n", Pn, Dlproca);
+		Exit(1);
+	    }
+	}
+	for (i = 0; i < Nlproc; i++) {
+	    Lp = (Nlproc > 1) ? slp[i] : &Lproc[i];
+
+#if	defined(HASRPTINCR)
+	/*
+	 * Let the next cycle reuse the process' files, too.  They remain
+	 * here, since the next cycle's delta needs them.
+	 */
+	    (void) save_lproc(Lp);
+#endif	/* defined(HASRPTINCR) */
+
+	    Dlproc[i] = *Lp;
+	    Lp->file = (struct lfile *)NULL;
+	    Lp->cmd = (char *)NULL;
+
+#if	defined(HASMNTNS)
+	/*
+	 * The process' mount namespace table is released at the start of the
+	 * next cycle.
+	 */
+	    Dlproc[i].mntns = (struct mntns *)NULL;
+#endif	/* defined(HASMNTNS) */
+
+#if	defined(HASLPARENA)
+	    Lp->arena = (struct lpachunk *)NULL;
+#endif	/* defined(HASLPARENA) */
+
+#if	defined(HASTASKS)
+	    Lp->tcmd = (char *)NULL;
+#endif	/* defined(HASTASKS) */
+
+	}
+	Dlprocn = Nlproc;
+	return(n);
+}
+
+
+/*
+ * rptwait() - wait for the next repeat cycle
+ *
+ * With a monotonic clock each cycle starts at an absolute deadline, RptTm
+ * milliseconds after the previous one, so the scan time doesn't make the
+ * cycles drift.  If a cycle overruns its interval, the missed deadlines are
+ * skipped, keeping the cadence, and the overrun is reported.
+ */
+
+static void
+rptwait(dl)
+	struct timespec *dl;		/* deadline of the current cycle */
+{
+
+#if	defined(HAS_CLOCK_NANOSLEEP)
+	long ov;
+	struct timespec now;
+	int sk;
+/*
+ * Advance the deadline by one interval.
+ */
+	dl->tv_sec += RptTm / RPTTMMS;
+	dl->tv_nsec += (long)(RptTm % RPTTMMS) * 1000000L;
+	if (dl->tv_nsec >= 1000000000L) {
+	    dl->tv_sec++;
+	    dl->tv_nsec -= 1000000000L;
+	}
+/*
+ * If the deadline has already passed, skip to the first one that hasn't.
+ */
+	(void) clock_gettime(CLOCK_MONOTONIC, &now);
+	if ((now.tv_sec > dl->tv_sec)
+	||  ((now.tv_sec == dl->tv_sec) && (now.tv_nsec >= dl->tv_nsec))) {
+	    ov = (long)(now.tv_sec - dl->tv_sec) * RPTTMMS
+	       + (now.tv_nsec - dl->tv_nsec) / 1000000L;
+	    sk = (int)(ov / RptTm) + 1;
+	    if (!Fwarn) {
+		(void) fprintf(stderr,
+		    "%s: WARNING: cycle overran the %d.%03d second repeat",
+		    Pn, RptTm / RPTTMMS, RptTm % RPTTMMS);
+		(void) fprintf(stderr,
+		    " interval by %ld.%03ld seconds; %d skipped\n",
+		    ov / RPTTMMS, ov % RPTTMMS, sk);
+	    }
+	    ov = (long)sk * RptTm;
+	    dl->tv_sec += ov / RPTTMMS;
+	    dl->tv_nsec += (ov % RPTTMMS) * 1000000L;
+	    if (dl->tv_nsec >= 1000000000L) {
+		dl->tv_sec++;
+		dl->tv_nsec -= 1000000000L;
+	    }
+	}
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, dl,
+			       (struct timespec *)NULL) == EINTR)
+	    ;
+#else	/* !defined(HAS_CLOCK_NANOSLEEP) */
+	struct timespec rq;
+
+	rq.tv_sec = RptTm / RPTTMMS;
+	rq.tv_nsec = (long)(RptTm % RPTTMMS) * 1000000L;
+	(void) nanosleep(&rq, (struct timespec *)NULL);
+#endif	/* defined(HAS_CLOCK_NANOSLEEP) */
+
+}
+
+
+
+/*
+ * sort_delta() - sort a process' selected files by their delta mode keys
+ *
+ * return: the number of selected files
+ */
+
+static int
+sort_delta(lp, fa, faa)
+	struct lproc *lp;		/* process (may be NULL) */
+	struct lfile ***fa;		/* file pointer array */
+	int *faa;			/* entries allocated to *fa */
+{
+	struct lfile *lf;
+	MALLOC_S len;
+	int n = 0;
+
+	if (!lp)
+	    return(0);
+	for (lf = lp->file; lf; lf = lf->next) {
+	    lf->delta = '\0';
+	    if (!lp->pss || !is_file_sel(lp, lf))
+		continue;
+	    if (n >= *faa) {
+		*faa += 64;
+		len = (MALLOC_S)(*faa * sizeof(struct lfile *));
+		if (*fa)
+		    *fa = (struct lfile **)realloc((MALLOC_P *)*fa, len);
+		else
+		    *fa = (struct lfile **)malloc(len);
+		if (!*fa) {
+		    (void) fprintf(stderr,
+			"%s: no space for %d delta file pointers\n",
+			Pn, *faa);
+		    Exit(1);
+		}
+	    }
+	    (*fa)[n++] = lf;
+	}
+	if (n > 1)
+	    (void) qsort((QSORT_P *)*fa, (size_t)n, sizeof(struct lfile *),
+			 comp_dkey);
+	return(n);
+}
+
+
 /*
  * sv_fmt_str() - save format string
  */
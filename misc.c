@@ -55,6 +55,96 @@ static char copyright[] =
 #define	MAXSYMLINKS	32
 #endif	/* !defined(MAXSYMLINKS) */
 
+#define	NWANYPORT	(-1)		/* network address index port key that
+					 * matches any port */
+#define	NWIDXMIN	64		/* minimum network address index slots
+					 * -- MUST BE A POWER OF 2! */
+
+#if	defined(HASIPv6)
+#define	NWNFAM		2		/* index address families: 0 = AF_INET,
+					 * 1 = AF_INET6 */
+#else	/* !defined(HASIPv6) */
+#define	NWNFAM		1		/* index address families: 0 = AF_INET */
+#endif	/* defined(HASIPv6) */
+
+#define	NWKEYKIND(pr, wa, ap)	(1 << (((pr) << 2) | ((wa) ? 2 : 0) \
+					       | ((ap) ? 1 : 0)))
+					/* network address index key kind bit
+					 * for a protocol index, the wildcard
+					 * address, and any port */
+#define	NWPORTS		65536		/* port numbers */
+#define	NWSCANMAX	32		/* maximum network address list length
+					 * that is_nw_addr() scans instead of
+					 * indexing */
+
+#if	defined(HASNMINTERN)
+#define	NMIARENA	65536		/* interned name arena chunk size */
+#define	NMIBUCKS	1024		/* initial interned name hash buckets
+					 * -- MUST BE A POWER OF 2! */
+#endif	/* defined(HASNMINTERN) */
+
+
+/*
+ * Local structures
+ */
+
+struct nwkey {				/* network address index key */
+	unsigned char a[MAX_AF_ADDR];	/* address (zero = any) */
+	int p;				/* port (NWANYPORT = any) */
+	short fam;			/* address family index */
+	short pr;			/* protocol index (0 = any) */
+};
+
+struct nwslot {				/* network address index slot */
+	struct nwkey k;			/* key */
+	struct nwad *n;			/* first Nwad entry with the key
+					 * (NULL = empty slot) */
+};
+
+#if	defined(HASDOINTHREAD)
+#define	DI_FREE		0		/* dislot is free */
+#define	DI_QUEUED	1		/* dislot request is queued */
+#define	DI_RUNNING	2		/* dislot request is being performed */
+#define	DI_DONE		3		/* dislot request is done */
+
+struct dislot {				/* dointhread() request slot */
+	int (*fn)();			/* function to perform */
+	char arg[MAXPATHLEN+1];		/* function parameter */
+	char rbuf[MAXPATHLEN+1];	/* response buffer */
+	int rbln;			/* response buffer length */
+	int rv;				/* function return value */
+	int en;				/* function errno */
+	int st;				/* state: DI_FREE, DI_QUEUED,
+					 * DI_RUNNING or DI_DONE */
+	int abandoned;			/* the request has timed out; the
+					 * performing thread frees the slot */
+};
+
+struct dishm {				/* memory shared by lsof and its
+					 * dointhread() helper process */
+	pthread_mutex_t mtx;		/* lock */
+	pthread_cond_t wcv;		/* work available (helper threads
+					 * wait) */
+	pthread_cond_t dcv;		/* request done (lsof waits) */
+	pthread_cond_t mcv;		/* more threads wanted, or quit (the
+					 * helper's main thread waits) */
+	int idle;			/* idle helper threads */
+	int nthr;			/* helper threads, including those
+					 * blocked in abandoned requests */
+	int want;			/* helper threads wanted */
+	int quit;			/* the helper process should exit */
+	struct dislot s[HASDOINTHREAD];	/* request slots */
+};
+#endif	/* defined(HASDOINTHREAD) */
+
+#if	defined(HASNMINTERN)
+struct nmintern {			/* interned name */
+	struct nmintern *next;		/* next hash bucket entry */
+	unsigned int h;			/* name hash */
+	char *nm;			/* name */
+};
+#endif	/* defined(HASNMINTERN) */
+
 
 /*
  * Local function prototypes
@@ -66,12 +156,30 @@ _PROTOTYPE(static int dostat,(char *path, char *buf, int len));
 _PROTOTYPE(static int doreadlink,(char *path, char *buf, int len));
 _PROTOTYPE(static int doinchild,(int (*fn)(), char *fp, char *rbuf, int rbln));
 
+#if	defined(HASDOINTHREAD)
+_PROTOTYPE(static int dointhread,(int (*fn)(), char *fp, char *rbuf, int rbln));
+_PROTOTYPE(static int dointhread_gone,(int od));
+_PROTOTYPE(static void dointhread_main,(pid_t ppid));
+_PROTOTYPE(static int dointhread_start,(void));
+_PROTOTYPE(static void *dointhread_thr,(void *arg));
+#endif	/* defined(HASDOINTHREAD) */
+
+_PROTOTYPE(static int hash_nwkey,(struct nwkey *k, int mod));
+_PROTOTYPE(static int is_nwad_match,(struct nwad *n, unsigned char *ia, int p, int af));
+_PROTOTYPE(static void make_nwkey,(struct nwkey *k, unsigned char *a, int p, int fam, int pr));
+_PROTOTYPE(static int nwproto_ix,(char *p));
+
 #if	defined(HASINTSIGNAL)
 _PROTOTYPE(static int handleint,(int sig));
 #else	/* !defined(HASINTSIGNAL) */
 _PROTOTYPE(static void handleint,(int sig));
 #endif	/* defined(HASINTSIGNAL) */
 
+#if	defined(HASNMINTERN)
+_PROTOTYPE(static char *intern_nm,(char *nm));
+_PROTOTYPE(static void report_nmi,(void));
+#endif	/* defined(HASNMINTERN) */
+
 
 /*
  * Local variables
@@ -87,6 +195,44 @@ static int CtSigs[] = { 0, SIGINT, SIGKILL };
 					 * dummy to allow pipe closure to
 					 * cause the child to exit */
 #define	NCTSIGS	(sizeof(CtSigs) / sizeof(int))
+static struct nwslot *Nwix = (struct nwslot *)NULL;
+					/* network address index slots */
+static int Nwixn = 0;			/* Nwix[] slot count */
+static struct nwad **Nwrng = (struct nwad **)NULL;
+					/* network addresses with port ranges,
+					 * in Nwad order */
+static int Nwrngn = 0;			/* Nwrng[] entry count */
+static unsigned char *Nwrpbm = (unsigned char *)NULL;
+					/* bitmap of the ports in Nwrng[]
+					 * ranges */
+static int Nwscan = 0;			/* is_nw_addr() scans the short Nwad
+					 * list */
+static unsigned char Nwza[MAX_AF_ADDR];
+					/* the wildcard network address */
+static unsigned int Nwixk[NWNFAM];	/* kinds of Nwix[] keys, by address
+					 * family: bit (4 * protocol index) +
+					 * 2 for the wildcard address + 1 for
+					 * any port */
+
+#if	defined(HASDOINTHREAD)
+static struct dishm *Dis = (struct dishm *)NULL;
+					/* memory shared with the dointhread()
+					 * helper process */
+static int DiNoThr = 0;			/* dointhread() can't be used, so
+					 * doinchild() uses a pipe-connected
+					 * child process */
+#endif	/* defined(HASDOINTHREAD) */
+
+#if	defined(HASNMINTERN)
+static char *Nmia = (char *)NULL;	/* interned name arena free space */
+static size_t Nmial = 0;		/* interned name arena free length */
+static struct nmintern **Nmib = (struct nmintern **)NULL;
+					/* interned name hash buckets */
+static int Nmibn = 0;			/* Nmib[] bucket count */
+static int Nmin = 0;			/* interned name count */
+static unsigned long Nminb = 0;		/* interned name bytes */
+static unsigned long Nmil = 0;		/* interned name lookups */
+#endif	/* defined(HASNMINTERN) */
 
 
 #if	defined(HASNLIST)
@@ -141,17 +287,48 @@ childx()
 	if (Cpid > 1) {
 
 	/*
-	 * First close the pipes to and from the child.  That should cause the
-	 * child to exit.  Compute alarm time shares.
+	 * First close the pipes to and from the child, or ask the dointhread()
+	 * helper process to exit.  That should cause the child to exit.
+	 * Compute alarm time shares.
 	 */
 	    (void) closePipes();
+
+#if	defined(HASDOINTHREAD)
+	    if (Dis) {
+
+	    /*
+	     * The helper process can't finish exiting while any of its
+	     * threads is blocked in an abandoned request, so don't wait for
+	     * it then.
+	     */
+		(void) pthread_mutex_lock(&Dis->mtx);
+		Dis->quit = 1;
+		(void) pthread_cond_signal(&Dis->mcv);
+		for (sx = 0; sx < HASDOINTHREAD; sx++) {
+		    if (Dis->s[sx].st == DI_RUNNING)
+			break;
+		}
+		(void) pthread_mutex_unlock(&Dis->mtx);
+		if (sx < HASDOINTHREAD) {
+		    if (!Fwarn)
+			(void) fprintf(stderr,
+			    "%s: WARNING -- child process %d may be hung.\n",
+			    Pn, (int)Cpid);
+		    sx = NCTSIGS;
+		} else
+		    sx = 0;
+	    } else
+#endif	/* defined(HASDOINTHREAD) */
+
+	    sx = 0;
+
 	    if ((at = TmLimit / NCTSIGS) < TMLIMMIN)
 		at = TMLIMMIN;
 	/*
 	 * Loop, waiting for the child to exit.  After the first pass, help
 	 * the child exit by sending it signals.
 	 */
-	    for (sx = 0; sx < NCTSIGS; sx++) {
+	    for (; sx < NCTSIGS; sx++) {
 		if (setjmp(Jmp_buf)) {
 
 		/*
@@ -190,6 +367,14 @@ childx()
 	    }
 	    Cpid = 0;
 	}
+
+#if	defined(HASDOINTHREAD)
+	if (Dis) {
+	    (void) munmap((void *)Dis, sizeof(struct dishm));
+	    Dis = (struct dishm *)NULL;
+	}
+#endif	/* defined(HASDOINTHREAD) */
+
 }
 
 
@@ -256,6 +441,15 @@ doinchild(fn, fp, rbuf, rbln)
 		Pn, rbln);
 	    Exit(1);
 	}
+
+#if	defined(HASDOINTHREAD)
+	if (!Fovhd && !DiNoThr) {
+	    rv = dointhread(fn, fp, rbuf, rbln);
+	    if (!DiNoThr)
+		return(rv);
+	}
+#endif	/* defined(HASDOINTHREAD) */
+
 /*
  * Set up to handle an alarm signal; handle an alarm signal; build
  * pipes for exchanging information with a child process; start the
@@ -427,6 +621,304 @@ doinchild(fn, fp, rbuf, rbln)
 }
 
 
+#if	defined(HASDOINTHREAD)
+/*
+ * dointhread() - do a doinchild() function in a thread of a helper process
+ *
+ * The request is placed in a slot of memory shared with the helper process
+ * and handed to an idle helper thread; the helper starts another thread when
+ * none is idle.  A request that isn't done within TmLimit seconds is
+ * abandoned to the thread performing it, which frees the slot when the
+ * function returns and then rejoins the idle threads.  So a blocked function
+ * costs a helper thread, not a new process, and a thread that can't be
+ * interrupted -- e.g., one waiting for a FUSE server -- can't stop lsof from
+ * exiting.
+ *
+ * There are HASDOINTHREAD slots and at most as many helper threads.  When
+ * every slot is held by a blocked thread, requests fail at once with EAGAIN;
+ * since they weren't tried, they mustn't look like ones that timed out.
+ *
+ * When the helper process has gone away, the request fails and DiNoThr is
+ * set, so doinchild() performs it and later requests in its pipe-connected
+ * child process.
+ */
+
+static int
+dointhread(fn, fp, rbuf, rbln)
+	int (*fn)();			/* function to perform */
+	char *fp;			/* function parameter */
+	char *rbuf;			/* response buffer */
+	int rbln;			/* response buffer length */
+{
+	struct timespec dl, ts;
+	int i;
+	struct dislot *sp;
+	int rv = 0;
+
+	if (!Dis && dointhread_start())
+	    return(-1);
+	if (strlen(fp) >= sizeof(sp->arg)) {
+	    errno = ENAMETOOLONG;
+	    return(-1);
+	}
+	if (((rv = pthread_mutex_lock(&Dis->mtx)) == EOWNERDEAD)
+	||  dointhread_gone(0))
+	{
+	    if (rv == EOWNERDEAD)
+		(void) dointhread_gone(1);
+	    errno = ECHILD;
+	    return(-1);
+	}
+	for (i = 0, sp = Dis->s; i < HASDOINTHREAD; i++, sp++) {
+	    if (sp->st == DI_FREE)
+		break;
+	}
+	if (i >= HASDOINTHREAD) {
+	    (void) pthread_mutex_unlock(&Dis->mtx);
+	    errno = EAGAIN;
+	    return(-1);
+	}
+	sp->fn = fn;
+	(void) strcpy(sp->arg, fp);
+	sp->rbln = rbln;
+	sp->abandoned = 0;
+	sp->st = DI_QUEUED;
+	if (Dis->idle)
+	    (void) pthread_cond_signal(&Dis->wcv);
+	else if (Dis->want < HASDOINTHREAD) {
+	    Dis->want++;
+	    (void) pthread_cond_signal(&Dis->mcv);
+	}
+/*
+ * Wait for the request to be done or for the time limit to expire.  Wait a
+ * second at a time, checking that the helper process is still there.
+ */
+	(void) clock_gettime(CLOCK_REALTIME, &dl);
+	dl.tv_sec += TmLimit;
+	rv = 0;
+	while ((sp->st != DI_DONE) && (rv != ETIMEDOUT)) {
+	    (void) clock_gettime(CLOCK_REALTIME, &ts);
+	    if (++ts.tv_sec >= dl.tv_sec)
+		ts = dl;
+	    rv = pthread_cond_timedwait(&Dis->dcv, &Dis->mtx, &ts);
+	    if ((rv == EOWNERDEAD) || ((rv == ETIMEDOUT) && dointhread_gone(0)))
+	    {
+		if (rv == EOWNERDEAD)
+		    (void) dointhread_gone(1);
+		errno = ECHILD;
+		return(-1);
+	    }
+	    if ((rv == ETIMEDOUT) && (ts.tv_sec != dl.tv_sec))
+		rv = 0;
+	}
+	if (sp->st == DI_DONE) {
+	    (void) memcpy((void *)rbuf, (void *)sp->rbuf, (size_t)rbln);
+	    rv = sp->rv;
+	    errno = sp->en;
+	    sp->st = DI_FREE;
+	} else {
+	    if (sp->st == DI_QUEUED)
+		sp->st = DI_FREE;
+	    else
+		sp->abandoned = 1;
+	    rv = 1;
+	    errno = ETIMEDOUT;
+	}
+	(void) pthread_mutex_unlock(&Dis->mtx);
+	return(rv);
+}
+
+
+/*
+ * dointhread_gone() - has the dointhread() helper process gone away?
+ *
+ * If it has, the memory shared with it is released and DiNoThr is set.
+ *
+ * return: 1 if it has gone away; 0 if not
+ */
+
+static int
+dointhread_gone(od)
+	int od;				/* 1 if it died holding the shared lock,
+					 * which EOWNERDEAD has reported */
+{
+	pid_t wpid;
+
+	if (!od) {
+	    while (((wpid = waitpid(Cpid, (int *)NULL, WNOHANG)) < 0)
+	    &&     (errno == EINTR))
+		;
+	    if (!wpid)
+		return(0);
+	}
+	(void) munmap((void *)Dis, sizeof(struct dishm));
+	Dis = (struct dishm *)NULL;
+	Cpid = 0;
+	DiNoThr = 1;
+	return(1);
+}
+
+
+/*
+ * dointhread_main() - the dointhread() helper process' main thread
+ *
+ * It starts helper threads as they are wanted, and exits when lsof asks it
+ * to or has gone away.
+ */
+
+static void
+dointhread_main(ppid)
+	pid_t ppid;			/* lsof's PID */
+{
+	pthread_attr_t pa;
+	pthread_t t;
+	struct timespec ts;
+
+	(void) pthread_attr_init(&pa);
+	(void) pthread_attr_setdetachstate(&pa, PTHREAD_CREATE_DETACHED);
+	(void) pthread_mutex_lock(&Dis->mtx);
+	while (!Dis->quit) {
+	    while (Dis->nthr < Dis->want) {
+		if (pthread_create(&t, &pa, dointhread_thr, (void *)NULL)) {
+		    Dis->want = Dis->nthr;
+		    break;
+		}
+		Dis->nthr++;
+	    }
+	    (void) clock_gettime(CLOCK_REALTIME, &ts);
+	    ts.tv_sec++;
+	    (void) pthread_cond_timedwait(&Dis->mcv, &Dis->mtx, &ts);
+	    if (getppid() != ppid)
+		break;
+	}
+	(void) pthread_mutex_unlock(&Dis->mtx);
+	(void) _exit(0);
+}
+
+
+/*
+ * dointhread_start() - start the dointhread() helper process
+ *
+ * return: 0 if started; 1 if doinchild() must use its pipe-connected child
+ *	   process instead (DiNoThr is set)
+ */
+
+static int
+dointhread_start()
+{
+	pthread_condattr_t ca;
+
+#if	!defined(HAS_CLOSEFROM)
+	int fd;
+#endif	/* !defined(HAS_CLOSEFROM) */
+
+	pthread_mutexattr_t ma;
+	pid_t ppid;
+	struct dishm *sh;
+/*
+ * Allocate and initialize the shared memory.  Its mutex and condition
+ * variables are shared by the two processes.  The mutex is robust, so that
+ * lsof learns of a helper process that died holding it.
+ */
+	if ((sh = (struct dishm *)mmap((void *)NULL, sizeof(struct dishm),
+				       PROT_READ | PROT_WRITE,
+				       MAP_SHARED | MAP_ANONYMOUS, -1, 0))
+	== (struct dishm *)MAP_FAILED)
+	{
+	    DiNoThr = 1;
+	    return(1);
+	}
+	zeromem((char *)sh, sizeof(struct dishm));
+	(void) pthread_mutexattr_init(&ma);
+	(void) pthread_condattr_init(&ca);
+	if (pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED)
+	||  pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST)
+	||  pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED)
+	||  pthread_mutex_init(&sh->mtx, &ma)
+	||  pthread_cond_init(&sh->wcv, &ca)
+	||  pthread_cond_init(&sh->dcv, &ca)
+	||  pthread_cond_init(&sh->mcv, &ca))
+	{
+	    (void) munmap((void *)sh, sizeof(struct dishm));
+	    DiNoThr = 1;
+	    return(1);
+	}
+	(void) pthread_mutexattr_destroy(&ma);
+	(void) pthread_condattr_destroy(&ca);
+	sh->want = 1;
+	Dis = sh;
+/*
+ * Fork the helper process.  It closes the files it inherited, and its threads
+ * block all signals, so that only its main thread reacts to the signals of
+ * childx().
+ */
+	ppid = getpid();
+	if ((Cpid = fork()) == 0) {
+
+#if	defined(HAS_CLOSEFROM)
+	    (void) closefrom(0);
+#else	/* !defined(HAS_CLOSEFROM) */
+	    for (fd = 0; fd < MaxFd; fd++) {
+		(void) close(fd);
+	    }
+#endif	/* defined(HAS_CLOSEFROM) */
+
+	    (void) dointhread_main(ppid);
+	}
+	if (Cpid < 0) {
+	    (void) fprintf(stderr, "%s: can't fork: %s\n",
+		Pn, strerror(errno));
+	    Exit(1);
+	}
+	return(0);
+}
+
+
+/*
+ * dointhread_thr() - dointhread() helper thread
+ */
+
+static void *
+dointhread_thr(arg)
+	void *arg;			/* unused */
+{
+	int i;
+	sigset_t nm;
+	struct dislot *sp;
+
+	(void) sigfillset(&nm);
+	(void) pthread_sigmask(SIG_BLOCK, &nm, (sigset_t *)NULL);
+	(void) pthread_mutex_lock(&Dis->mtx);
+	for (;;) {
+	    for (i = 0, sp = Dis->s; i < HASDOINTHREAD; i++, sp++) {
+		if (sp->st == DI_QUEUED)
+		    break;
+	    }
+	    if (i >= HASDOINTHREAD) {
+		Dis->idle++;
+		(void) pthread_cond_wait(&Dis->wcv, &Dis->mtx);
+		Dis->idle--;
+		continue;
+	    }
+	    sp->st = DI_RUNNING;
+	    (void) pthread_mutex_unlock(&Dis->mtx);
+	    zeromem(sp->rbuf, sp->rbln);
+	    sp->rv = sp->fn(sp->arg, sp->rbuf, sp->rbln);
+	    sp->en = errno;
+	    (void) pthread_mutex_lock(&Dis->mtx);
+	    if (sp->abandoned)
+		sp->st = DI_FREE;
+	    else {
+		sp->st = DI_DONE;
+		(void) pthread_cond_signal(&Dis->dcv);
+	    }
+	}
+	/* NOTREACHED */
+	return((void *)NULL);
+}
+#endif	/* defined(HASDOINTHREAD) */
+
+
 /*
  * dolstat() - do an lstat() function
  */
@@ -507,6 +999,10 @@ enter_dev_ch(m)
 
 	if (!m || *m == '\0')
 	    return;
+
+#if	defined(HASLPARENA)
+	mp = mkstrlpa(m);
+#else	/* !defined(HASLPARENA) */
 	if (!(mp = mkstrcpy(m, (MALLOC_S *)NULL))) {
 	    (void) fprintf(stderr, "%s: no more dev_ch space at PID %d: \n",
 		Pn, Lp->pid);
@@ -515,6 +1011,8 @@ enter_dev_ch(m)
 	}
 	if (Lf->dev_ch)
 	   (void) free((FREE_P *)Lf->dev_ch);
+#endif	/* defined(HASLPARENA) */
+
 	Lf->dev_ch = mp;
 }
 
@@ -753,6 +1251,12 @@ enter_nm(m)
 
 	if (!m || *m == '\0')
 	    return;
+
+#if	defined(HASNMINTERN)
+	mp = intern_nm(m);
+#elif	defined(HASLPARENA)
+	mp = mkstrlpa(m);
+#else	/* !defined(HASNMINTERN) && !defined(HASLPARENA) */
 	if (!(mp = mkstrcpy(m, (MALLOC_S *)NULL))) {
 	    (void) fprintf(stderr, "%s: no more nm space at PID %d for: ",
 		Pn, Lp->pid);
@@ -761,6 +1265,8 @@ enter_nm(m)
 	}
 	if (Lf->nm)
 	    (void) free((FREE_P *)Lf->nm);
+#endif	/* defined(HASNMINTERN) */
+
 	Lf->nm = mp;
 }
 
@@ -775,6 +1281,14 @@ Exit(xv)
 {
 	(void) childx();
 
+#if	defined(HASLPARENA)
+	(void) report_lpa();
+#endif	/* defined(HASLPARENA) */
+
+#if	defined(HASNMINTERN)
+	(void) report_nmi();
+#endif	/* defined(HASNMINTERN) */
+
 #if	defined(HASDCACHE)
 	if (DCrebuilt && !Fwarn)
 	    (void) fprintf(stderr, "%s: WARNING: %s was updated.\n",
@@ -818,6 +1332,9 @@ get_Nl_value(nn, d, v)
 
 /*
  * handleint() - handle an interrupt
+ *
+ * The signal is unblocked before the jump, since setjmp() needn't have saved
+ * the signal mask; otherwise later alarms couldn't be delivered.
  */
 
 #if	defined(HASINTSIGNAL)
@@ -831,10 +1348,39 @@ static void
 handleint(sig)
 	int sig;
 {
+	sigset_t ss;
+
+	(void) sigemptyset(&ss);
+	(void) sigaddset(&ss, sig);
+	(void) sigprocmask(SIG_UNBLOCK, &ss, (sigset_t *)NULL);
 	longjmp(Jmp_buf, 1);
 }
 
 
+/*
+ * hash_nwkey() - hash a network address index key
+ */
+
+static int
+hash_nwkey(k, mod)
+	struct nwkey *k;		/* key */
+	int mod;			/* slot count (power of 2) */
+{
+	unsigned long long h;
+	int i;
+	unsigned int w;
+
+	h = ((unsigned long long)(unsigned int)k->p << 16)
+	  | ((unsigned long long)k->fam << 8) | (unsigned long long)k->pr;
+	for (i = 0; i < MAX_AF_ADDR; i += (int)sizeof(w)) {
+	    (void) memcpy((void *)&w, (void *)&k->a[i], sizeof(w));
+	    h = (h ^ (unsigned long long)w) * 0x9e3779b97f4a7c15ULL;
+	}
+	h ^= h >> 32;
+	return((int)(h & (unsigned long long)(mod - 1)));
+}
+
+
 /*
  * hashbyname() - hash by name
  */
@@ -855,6 +1401,195 @@ hashbyname(nm, mod)
 }
 
 
+#if	defined(HASNMINTERN)
+/*
+ * intern_nm() - find or enter a name in the interned name table
+ *
+ * Interned names are never freed, so all the files with the same name
+ * share one copy for the life of lsof.
+ */
+
+static char *
+intern_nm(nm)
+	char *nm;			/* name */
+{
+	unsigned int h;
+	int i, n;
+	size_t len, sz;
+	struct nmintern *ip, *nx, **nb;
+	char *cp;
+
+	for (cp = nm, h = 2166136261U; *cp; cp++) {
+	    h ^= (unsigned int)(unsigned char)*cp;
+	    h *= 16777619U;
+	}
+	len = (size_t)(cp - nm);
+	Nmil++;
+	if (Nmib) {
+	    for (ip = Nmib[h & (Nmibn - 1)]; ip; ip = ip->next) {
+		if ((ip->h == h) && !strcmp(ip->nm, nm))
+		    return(ip->nm);
+	    }
+	}
+/*
+ * Double the buckets when the names outnumber them.
+ */
+	if (Nmin >= Nmibn) {
+	    n = Nmibn ? (Nmibn * 2) : NMIBUCKS;
+	    if (!(nb = (struct nmintern **)calloc((MALLOC_S)n,
+						  sizeof(struct nmintern *))))
+	    {
+		(void) fprintf(stderr,
+		    "%s: no space for %d interned name buckets\n", Pn, n);
+		Exit(1);
+	    }
+	    for (i = 0; i < Nmibn; i++) {
+		for (ip = Nmib[i]; ip; ip = nx) {
+		    nx = ip->next;
+		    ip->next = nb[ip->h & (n - 1)];
+		    nb[ip->h & (n - 1)] = ip;
+		}
+	    }
+	    if (Nmib)
+		(void) free((FREE_P *)Nmib);
+	    Nmib = nb;
+	    Nmibn = n;
+	}
+/*
+ * Carve the entry and its name from the arena.
+ */
+	sz = (sizeof(struct nmintern) + len + 1 + sizeof(char *) - 1)
+	   & ~(sizeof(char *) - 1);
+	if (sz > Nmial) {
+	    Nmial = (sz > NMIARENA) ? sz : NMIARENA;
+	    if (!(Nmia = (char *)malloc((MALLOC_S)Nmial))) {
+		(void) fprintf(stderr,
+		    "%s: no space for interned name arena\n", Pn);
+		Exit(1);
+	    }
+	}
+	ip = (struct nmintern *)Nmia;
+	Nmia += sz;
+	Nmial -= sz;
+	ip->nm = (char *)(ip + 1);
+	(void) memcpy((void *)ip->nm, (void *)nm, len + 1);
+	ip->h = h;
+	ip->next = Nmib[h & (Nmibn - 1)];
+	Nmib[h & (Nmibn - 1)] = ip;
+	Nmin++;
+	Nminb += (unsigned long)(len + 1);
+	return(ip->nm);
+}
+#endif	/* defined(HASNMINTERN) */
+
+
+/*
+ * index_nwad() - index the Nwad network address list for is_nw_addr()
+ *
+ * Each entry with a single port, or with none, is entered in a hash by its
+ * address family, protocol, address and port.  The first entry of the Nwad
+ * list with a key is the one is_nw_addr() finds, as a scan of the list would.
+ * Entries with a range of ports are few; they remain on a list, which a
+ * bitmap of their ports guards.
+ *
+ * A list of no more than NWSCANMAX entries isn't indexed; is_nw_addr() scans
+ * it faster than it could probe the index.
+ */
+
+void
+index_nwad()
+{
+	int fam, i, j, n, nr, pr;
+	struct nwkey k;
+	struct nwad *np;
+	static int ff[NWNFAM] = {
+		AF_INET
+
+#if	defined(HASIPv6)
+		, AF_INET6
+#endif	/* defined(HASIPv6) */
+
+	};
+
+	if (!Nwad || Nwix || Nwscan)
+	    return;
+/*
+ * Number the entries in list order and count those with port ranges.
+ */
+	for (n = nr = 0, np = Nwad; np; np = np->next) {
+	    np->ix = n++;
+	    if ((np->sport != -1) && (np->sport != np->eport))
+		nr++;
+	}
+	if (n <= NWSCANMAX) {
+	    Nwscan = 1;
+	    return;
+	}
+	for (Nwixn = NWIDXMIN; Nwixn < (n * NWNFAM * 2); Nwixn <<= 1)
+	    ;
+	if (!(Nwix = (struct nwslot *)calloc((MALLOC_S)Nwixn,
+					     sizeof(struct nwslot))))
+	{
+	    (void) fprintf(stderr,
+		"%s: no space for %d network address index slots\n",
+		Pn, Nwixn);
+	    Exit(1);
+	}
+	if (nr) {
+	    if (!(Nwrng = (struct nwad **)malloc(
+			  (MALLOC_S)(nr * sizeof(struct nwad *))))
+	    ||  !(Nwrpbm = (unsigned char *)calloc((MALLOC_S)(NWPORTS / 8), 1)))
+	    {
+		(void) fprintf(stderr,
+		    "%s: no space for %d network address port ranges\n",
+		    Pn, nr);
+		Exit(1);
+	    }
+	}
+	for (np = Nwad; np; np = np->next) {
+	    if ((np->sport != -1) && (np->sport != np->eport)) {
+
+	    /*
+	     * List a port range entry and mark its ports.
+	     */
+		Nwrng[Nwrngn++] = np;
+		for (i = (np->sport < 0) ? 0 : np->sport;
+		     (i <= np->eport) && (i < NWPORTS);
+		     i++)
+		{
+		    Nwrpbm[i >> 3] |= (unsigned char)(1 << (i & 7));
+		}
+		continue;
+	    }
+	/*
+	 * Enter the key of each address family the entry can match, unless an
+	 * earlier entry has it.
+	 */
+	    pr = nwproto_ix(np->proto);
+	    for (fam = 0; fam < NWNFAM; fam++) {
+		if (np->af && (np->af != ff[fam]))
+		    continue;
+		(void) make_nwkey(&k, np->a, np->sport, fam, pr);
+		for (j = hash_nwkey(&k, Nwixn); Nwix[j].n;
+		     j = (j + 1) & (Nwixn - 1))
+		{
+		    if (!memcmp((void *)&Nwix[j].k, (void *)&k, sizeof(k)))
+			break;
+		}
+		if (!Nwix[j].n) {
+		    Nwix[j].k = k;
+		    Nwix[j].n = np;
+		}
+		if (pr >= 0)
+		    Nwixk[fam] |= NWKEYKIND(pr,
+					    !memcmp((void *)k.a, (void *)Nwza,
+						    sizeof(k.a)),
+					    (np->sport == -1));
+	    }
+	}
+}
+
+
 /*
  * is_nw_addr() - is this network address selected?
  */
@@ -866,56 +1601,161 @@ is_nw_addr(ia, p, af)
 	int af;				/* address family -- e.g., AF_INET,
 					 * AF_INET6 */
 {
+	struct nwad *bn = (struct nwad *)NULL;
+	int fam, i, j, pr, pri;
+	struct nwkey k;
 	struct nwad *n;
 
-	if (!(n = Nwad))
+	if (!Nwad)
 	    return(0);
-	for (; n; n = n->next) {
-	    if (n->proto) {
-		if (strcasecmp(n->proto, Lf->iproto) != 0)
-		    continue;
+	if (!Nwix && !Nwscan)
+	    (void) index_nwad();
+	if (Nwscan) {
+	    for (n = Nwad; n; n = n->next) {
+		if (is_nwad_match(n, ia, p, af)) {
+		    n->f = 1;
+		    return(1);
+		}
 	    }
-	    if (af && n->af && af != n->af)
-		continue;
+	    return(0);
+	}
+	if (af == AF_INET)
+	    fam = 0;
 
 #if	defined(HASIPv6)
-	    if (af == AF_INET6) {
-		if (n->a[15] || n->a[14] || n->a[13] || n->a[12]
-		||  n->a[11] || n->a[10] || n->a[9]  || n->a[8]
-		||  n->a[7]  || n->a[6]  || n->a[5]  || n->a[4]
-		||  n->a[3]  || n->a[2]  || n->a[1]  || n->a[0]) {
-		    if (ia[15] != n->a[15] || ia[14] != n->a[14]
-		    ||  ia[13] != n->a[13] || ia[12] != n->a[12]
-		    ||  ia[11] != n->a[11] || ia[10] != n->a[10]
-		    ||  ia[9]  != n->a[9]  || ia[8]  != n->a[8]
-		    ||  ia[7]  != n->a[7]  || ia[6]  != n->a[6]
-		    ||  ia[5]  != n->a[5]  || ia[4]  != n->a[4]
-		    ||  ia[3]  != n->a[3]  || ia[2]  != n->a[2]
-		    ||  ia[1]  != n->a[1]  || ia[0]  != n->a[0])
-			continue;
-		}
-	    } else if (af == AF_INET)
+	else if (af == AF_INET6)
+	    fam = 1;
+	else
+	    return(0);
+#else	/* !defined(HASIPv6) */
+	else
+	    fam = 0;
 #endif	/* defined(HASIPv6) */
 
-	    {
-		if (n->a[3] || n->a[2] || n->a[1] || n->a[0]) {
-		    if (ia[3] != n->a[3] || ia[2] != n->a[2]
-		    ||  ia[1] != n->a[1] || ia[0] != n->a[0])
-			continue;
+/*
+ * Look up the address and the wildcard address, with the port and with any
+ * port, for any protocol and for the file's protocol.  Keep the entry found
+ * that is first in the Nwad list.
+ */
+	pr = nwproto_ix(Lf->iproto);
+	for (pri = 0; pri < 2; pri++) {
+	    if (pri && (pr <= 0))
+		break;
+	    for (i = 0; i < 4; i++) {
+		if (!(Nwixk[fam] & NWKEYKIND(pri ? pr : 0, i & 1, i & 2)))
+		    continue;
+		(void) make_nwkey(&k, (i & 1) ? Nwza : ia,
+				  (i & 2) ? NWANYPORT : p, fam, pri ? pr : 0);
+		for (j = hash_nwkey(&k, Nwixn); (n = Nwix[j].n);
+		     j = (j + 1) & (Nwixn - 1))
+		{
+		    if (!memcmp((void *)&Nwix[j].k, (void *)&k, sizeof(k))) {
+			if (!bn || (n->ix < bn->ix))
+			    bn = n;
+			break;
+		    }
 		}
 	    }
+	}
+/*
+ * Check the port range entries when the port is in one of their ranges.
+ */
+	if (Nwrngn && (p >= 0) && (p < NWPORTS)
+	&&  (Nwrpbm[p >> 3] & (1 << (p & 7))))
+	{
+	    for (i = 0; i < Nwrngn; i++) {
+		n = Nwrng[i];
+		if (bn && (n->ix > bn->ix))
+		    break;
+		if (is_nwad_match(n, ia, p, af)) {
+		    bn = n;
+		    break;
+		}
+	    }
+	}
+	if (bn) {
+	    bn->f = 1;
+	    return(1);
+	}
+	return(0);
+}
+
+
+/*
+ * is_nwad_match() - does a network address match an Nwad entry?
+ */
+
+static int
+is_nwad_match(n, ia, p, af)
+	struct nwad *n;			/* Nwad entry */
+	unsigned char *ia;		/* Internet address */
+	int p;				/* port */
+	int af;				/* address family -- e.g., AF_INET,
+					 * AF_INET6 */
+{
+	if (n->proto) {
+	    if (strcasecmp(n->proto, Lf->iproto) != 0)
+		return(0);
+	}
+	if (af && n->af && af != n->af)
+	    return(0);
 
 #if	defined(HASIPv6)
-	    else
-		continue;
+	if (af == AF_INET6) {
+	    if (n->a[15] || n->a[14] || n->a[13] || n->a[12]
+	    ||  n->a[11] || n->a[10] || n->a[9]  || n->a[8]
+	    ||  n->a[7]  || n->a[6]  || n->a[5]  || n->a[4]
+	    ||  n->a[3]  || n->a[2]  || n->a[1]  || n->a[0]) {
+		if (ia[15] != n->a[15] || ia[14] != n->a[14]
+		||  ia[13] != n->a[13] || ia[12] != n->a[12]
+		||  ia[11] != n->a[11] || ia[10] != n->a[10]
+		||  ia[9]  != n->a[9]  || ia[8]  != n->a[8]
+		||  ia[7]  != n->a[7]  || ia[6]  != n->a[6]
+		||  ia[5]  != n->a[5]  || ia[4]  != n->a[4]
+		||  ia[3]  != n->a[3]  || ia[2]  != n->a[2]
+		||  ia[1]  != n->a[1]  || ia[0]  != n->a[0])
+		    return(0);
+	    }
+	} else if (af == AF_INET)
 #endif	/* defined(HASIPv6) */
 
-	    if (n->sport == -1 || (p >= n->sport && p <= n->eport)) {
-		n->f = 1;
-		return(1);
+	{
+	    if (n->a[3] || n->a[2] || n->a[1] || n->a[0]) {
+		if (ia[3] != n->a[3] || ia[2] != n->a[2]
+		||  ia[1] != n->a[1] || ia[0] != n->a[0])
+		    return(0);
 	    }
 	}
-	return(0);
+
+#if	defined(HASIPv6)
+	else
+	    return(0);
+#endif	/* defined(HASIPv6) */
+
+	return((n->sport == -1) || ((p >= n->sport) && (p <= n->eport)));
+}
+
+
+/*
+ * make_nwkey() - make a network address index key
+ */
+
+static void
+make_nwkey(k, a, p, fam, pr)
+	struct nwkey *k;		/* key to make */
+	unsigned char *a;		/* address */
+	int p;				/* port (-1 = any) */
+	int fam;			/* address family index */
+	int pr;				/* protocol index */
+{
+	int al;
+
+	zeromem((char *)k, sizeof(struct nwkey));
+	al = fam ? MAX_AF_ADDR : 4;
+	(void) memcpy((void *)k->a, (void *)a, (size_t)al);
+	k->p = (p < 0) ? NWANYPORT : p;
+	k->fam = (short)fam;
+	k->pr = (short)pr;
 }
 
 
@@ -1008,6 +1848,30 @@ mkstrcat(s1, l1, s2, l2, s3, l3, clp)
 }
 
 
+/*
+ * nwproto_ix() - get the network address index of a protocol name
+ *
+ * return: 0 = no name
+ *	   1 = TCP; 2 = UDP; 3 = UDPLITE
+ *	  -1 = other
+ */
+
+static int
+nwproto_ix(p)
+	char *p;			/* protocol name */
+{
+	if (!p || !*p)
+	    return(0);
+	if (!strcasecmp(p, "tcp"))
+	    return(1);
+	if (!strcasecmp(p, "udp"))
+	    return(2);
+	if (!strcasecmp(p, "udplite"))
+	    return(3);
+	return(-1);
+}
+
+
 /*
  * is_readable() -- is file readable
  */
@@ -1336,6 +2200,24 @@ readstqinit(addr, buf)
 #endif	/* HASSTREAMS */
 
 
+#if	defined(HASNMINTERN)
+/*
+ * report_nmi() - report interned name statistics, if LPASTATSENV requests
+ *		  them
+ */
+
+static void
+report_nmi()
+{
+	if (!getenv(LPASTATSENV))
+	    return;
+	(void) fprintf(stderr,
+	    "%s: names: %lu lookups, %d distinct names (%lu bytes) interned\n",
+	    Pn, Nmil, Nmin, Nminb);
+}
+#endif	/* defined(HASNMINTERN) */
+
+
 /*
  * safepup() - safely print an unprintable character -- i.e., print it in a
  *	       printable form
@@ -42,7 +42,10 @@ static char copyright[] =
  * Local definitions, structures and function prototypes
  */
 
-#define HCINC		64		/* host cache size increase chunk */
+#define	HCARENA		8192		/* host cache arena chunk size */
+#define	HCBUCKS		256		/* initial host cache bucket count
+					 * !!MUST BE A POWER OF 2!! */
+#define	HCINC		64		/* host name lookup table increment */
 #define PORTHASHBUCKETS	128		/* port hash bucket count
 					 * !!MUST BE A POWER OF 2!! */
 #define	PORTTABTHRESH	10		/* threshold at which we will switch
@@ -55,8 +58,28 @@ struct hostcache {
 	int af;				/* address family -- e.g., AF_INET
 					 * or AF_INET6 */
 	char *name;			/* name */
+	struct hostcache *next;		/* next entry in hash bucket */
+};
+
+#if	defined(HASPARHOSTRSLV)
+struct hostrslv {			/* parallel host name lookup entry */
+	unsigned char a[MAX_AF_ADDR];	/* numeric address */
+	int af;				/* address family */
+	char *name;			/* name found (NULL if none) */
 };
 
+struct hostrslvq {			/* parallel host name lookup queue */
+	pthread_mutex_t mtx;		/* queue lock */
+	pthread_cond_t cv;		/* progress condition */
+	struct hostrslv *e;		/* lookup entries */
+	int n;				/* number of entries */
+	int nx;				/* index of next entry to look up */
+	int nd;				/* number of lookups done */
+	int nthr;			/* number of running threads */
+	int expired;			/* time limit has expired */
+};
+#endif	/* defined(HASPARHOSTRSLV) */
+
 struct porttab {
 	int port;
 	MALLOC_S nl;			/* name length (excluding '\0') */
@@ -85,16 +108,45 @@ static struct porttab **Pth[4] = { NULL, NULL, NULL, NULL };
 
 #define HASHPORT(p)	(((((int)(p)) * 31415) >> 3) & (PORTHASHBUCKETS - 1))
 
+static struct hostcache **Hc = (struct hostcache **)NULL;
+						/* host cache hash buckets */
+static char *Hca = (char *)NULL;		/* host cache arena free space */
+static size_t Hcal = 0;				/* host cache arena free length */
+static int Hcb = 0;				/* host cache bucket count */
+static int Hcn = 0;				/* host cache entry count */
+
+#if	defined(HASPARHOSTRSLV)
+static pthread_mutex_t Hrmtx = PTHREAD_MUTEX_INITIALIZER;
+						/* Hrthr lock */
+static int Hrthr = 0;				/* host name lookup threads in
+						 * progress, including those
+						 * abandoned by earlier
+						 * lkup_hostnms() calls */
+#endif	/* defined(HASPARHOSTRSLV) */
+
 
 #if	!defined(HASNORPC_H)
 _PROTOTYPE(static void fill_portmap,(void));
 _PROTOTYPE(static void update_portmap,(struct porttab *pt, char *pn));
 #endif	/* !defined(HASNORPC_H) */
 
+_PROTOTYPE(static char *alloc_hostcache,(size_t len));
+_PROTOTYPE(static char *enter_hostcache,(unsigned char *ia, int af, int al, char *hn));
 _PROTOTYPE(static void fill_porttab,(void));
+_PROTOTYPE(static int hash_hostaddr,(unsigned char *ia, int af, int al));
+_PROTOTYPE(static void fmt_hostnum,(unsigned char *ia, int af, char *hbuf, size_t hbufl));
+
+#if	defined(HASPARHOSTRSLV)
+_PROTOTYPE(static int comp_hostrslv,(COMP_P *a1, COMP_P *a2));
+_PROTOTYPE(static void free_hostrslvq,(struct hostrslvq *q));
+_PROTOTYPE(static void *lkup_hostnm_thr,(void *arg));
+#endif	/* defined(HASPARHOSTRSLV) */
+
 _PROTOTYPE(static char *lkup_port,(int p, int pr, int src));
 _PROTOTYPE(static char *lkup_svcnam,(int h, int p, int pr, int ss));
 _PROTOTYPE(static int printinaddr,(void));
+_PROTOTYPE(static void size_hostcache,(int n));
+_PROTOTYPE(static char *srch_hostcache,(unsigned char *ia, int af, int al));
 
 
 /*
@@ -355,6 +407,198 @@ fill_porttab()
 }
 
 
+/*
+ * alloc_hostcache() - allocate space from the host cache arena
+ *
+ * Host cache entries and their names live for the whole lsof run, so they
+ * are carved from large chunks that are never freed.
+ */
+
+static char *
+alloc_hostcache(len)
+	size_t len;			/* length required */
+{
+	char *cp;
+	size_t cl;
+
+	len = (len + sizeof(char *) - 1) & ~(sizeof(char *) - 1);
+	if (len > Hcal) {
+	    cl = (len > HCARENA) ? len : HCARENA;
+	    if (!(Hca = (char *)malloc((MALLOC_S)cl))) {
+		(void) fprintf(stderr, "%s: no space for host cache\n", Pn);
+		Exit(1);
+	    }
+	    Hcal = cl;
+	}
+	cp = Hca;
+	Hca += len;
+	Hcal -= len;
+	return(cp);
+}
+
+
+/*
+ * enter_hostcache() - enter a host name in the host cache
+ */
+
+static char *
+enter_hostcache(ia, af, al, hn)
+	unsigned char *ia;		/* Internet address */
+	int af;				/* address family */
+	int al;				/* address length */
+	char *hn;			/* host name */
+{
+	struct hostcache *hc;
+	int h;
+	size_t len;
+/*
+ * Grow the hash buckets when the entries outnumber them.
+ */
+	if (Hcn >= Hcb)
+	    size_hostcache(Hcn + 1);
+/*
+ * Copy the address and the name to the arena and link the entry to its
+ * hash bucket.
+ */
+	len = strlen(hn) + 1;
+	hc = (struct hostcache *)alloc_hostcache(sizeof(struct hostcache) + len);
+	zeromem((char *)hc->a, sizeof(hc->a));
+	(void) memcpy((void *)hc->a, (void *)ia, al);
+	hc->af = af;
+	hc->name = (char *)(hc + 1);
+	(void) memcpy((void *)hc->name, (void *)hn, len);
+	h = hash_hostaddr(ia, af, al);
+	hc->next = Hc[h];
+	Hc[h] = hc;
+	Hcn++;
+	return(hc->name);
+}
+
+
+/*
+ * fmt_hostnum() - format a numeric host address
+ */
+
+static void
+fmt_hostnum(ia, af, hbuf, hbufl)
+	unsigned char *ia;		/* Internet address */
+	int af;				/* address family */
+	char *hbuf;			/* receiving buffer */
+	size_t hbufl;			/* receiving buffer length */
+{
+
+#if	defined(HASIPv6)
+	size_t len;
+
+	if (af == AF_INET6) {
+
+	/*
+	 * Since IPv6 numeric addresses use `:' as a separator, enclose
+	 * them in brackets.
+	 */
+	    hbuf[0] = '[';
+	    if (!inet_ntop(af, ia, hbuf + 1, hbufl - 3)) {
+		(void) snpf(&hbuf[1], (hbufl - 1),
+		    "can't format IPv6 address]");
+	    } else {
+		len = strlen(hbuf);
+		(void) snpf(&hbuf[len], hbufl - len, "]");
+	    }
+	} else
+#endif	/* defined(HASIPv6) */
+
+	if (af == AF_INET)
+	    (void) snpf(hbuf, hbufl, "%u.%u.%u.%u", ia[0], ia[1],
+			ia[2], ia[3]);
+	else
+	    (void) snpf(hbuf, hbufl, "(unknown AF value: %d)", af);
+}
+
+
+/*
+ * hash_hostaddr() - hash an Internet address to a host cache bucket
+ */
+
+static int
+hash_hostaddr(ia, af, al)
+	unsigned char *ia;		/* Internet address */
+	int af;				/* address family */
+	int al;				/* address length */
+{
+	unsigned int h = 2166136261U ^ (unsigned int)af;
+	int i;
+
+	for (i = 0; i < al; i++) {
+	    h = (h ^ ia[i]) * 16777619U;
+	}
+	h ^= h >> 15;
+	return((int)(h & (Hcb - 1)));
+}
+
+
+/*
+ * size_hostcache() - size the host cache hash buckets for an entry count
+ */
+
+static void
+size_hostcache(n)
+	int n;				/* expected entry count */
+{
+	struct hostcache *hc, **ob, *nx;
+	int h, i, nb, obn;
+
+	for (nb = Hcb ? Hcb : HCBUCKS; nb < n; nb <<= 1)
+	    ;
+	if (nb <= Hcb)
+	    return;
+	ob = Hc;
+	obn = Hcb;
+	if (!(Hc = (struct hostcache **)calloc((MALLOC_S)nb,
+					       sizeof(struct hostcache *))))
+	{
+	    (void) fprintf(stderr, "%s: no space for host cache\n", Pn);
+	    Exit(1);
+	}
+/*
+ * Rehash the existing entries.
+ */
+	Hcb = nb;
+	for (i = 0; i < obn; i++) {
+	    for (hc = ob[i]; hc; hc = nx) {
+		nx = hc->next;
+		h = hash_hostaddr(hc->a, hc->af,
+		    (hc->af == AF_INET) ? MIN_AF_ADDR : MAX_AF_ADDR);
+		hc->next = Hc[h];
+		Hc[h] = hc;
+	    }
+	}
+	if (ob)
+	    (void) free((FREE_P *)ob);
+}
+
+
+/*
+ * srch_hostcache() - search the host cache for an address
+ */
+
+static char *
+srch_hostcache(ia, af, al)
+	unsigned char *ia;		/* Internet address */
+	int af;				/* address family */
+	int al;				/* address length */
+{
+	struct hostcache *hc;
+
+	if (!Hcn)
+	    return((char *)NULL);
+	for (hc = Hc[hash_hostaddr(ia, af, al)]; hc; hc = hc->next) {
+	    if ((af == hc->af) && !memcmp((void *)ia, (void *)hc->a, al))
+		return(hc->name);
+	}
+	return((char *)NULL);
+}
+
+
 /*
  * gethostnm() - get host name
  */
@@ -367,32 +611,19 @@ gethostnm(ia, af)
 {
 	int al = MIN_AF_ADDR;
 	char hbuf[256];
-	static struct hostcache *hc = (struct hostcache *)NULL;
-	static int hcx = 0;
-	char *hn, *np;
+	char *hn;
 	struct hostent *he = (struct hostent *)NULL;
-	int i, j;
-	MALLOC_S len;
-	static int nhc = 0;
-/*
- * Search cache.
- */
 
 #if	defined(HASIPv6)
 	if (af == AF_INET6)
 	    al = MAX_AF_ADDR;
 #endif	/* defined(HASIPv6) */
 
-	for (i = 0; i < hcx; i++) {
-	    if (af != hc[i].af)
-		continue;
-	    for (j = 0; j < al; j++) {
-		if (ia[j] != hc[i].a[j])
-		    break;
-	    }
-	    if (j >= al)
-		return(hc[i].name);
-	}
+/*
+ * Search cache.
+ */
+	if ((hn = srch_hostcache(ia, af, al)))
+	    return(hn);
 /*
  * If -n has been specified, construct a numeric address.  Otherwise, look up
  * host name by address.  If that fails, or if there is no name in the returned
@@ -401,63 +632,280 @@ gethostnm(ia, af)
 	if (Fhost)
 	    he = gethostbyaddr((char *)ia, al, af);
 	if (!he || !he->h_name) {
+	    fmt_hostnum(ia, af, hbuf, sizeof(hbuf));
+	    hn = hbuf;
+	} else
+	    hn = (char *)he->h_name;
+	return(enter_hostcache(ia, af, al, hn));
+}
 
-#if	defined(HASIPv6)
-	    if (af == AF_INET6) {
 
-	    /*
-	     * Since IPv6 numeric addresses use `:' as a separator, enclose
-	     * them in brackets.
-	     */
-		hbuf[0] = '[';
-		if (!inet_ntop(af, ia, hbuf + 1, sizeof(hbuf) - 3)) {
-		    (void) snpf(&hbuf[1], (sizeof(hbuf) - 1),
-			"can't format IPv6 address]");
-		} else {
-		    len = strlen(hbuf);
-		    (void) snpf(&hbuf[len], sizeof(hbuf) - len, "]");
-		}
+#if	defined(HASPARHOSTRSLV)
+/*
+ * comp_hostrslv() - compare host name lookup entries for qsort()
+ */
+
+static int
+comp_hostrslv(a1, a2)
+	COMP_P *a1, *a2;
+{
+	struct hostrslv *e1 = (struct hostrslv *)a1;
+	struct hostrslv *e2 = (struct hostrslv *)a2;
+
+	if (e1->af != e2->af)
+	    return((e1->af < e2->af) ? -1 : 1);
+	return(memcmp((void *)e1->a, (void *)e2->a, MAX_AF_ADDR));
+}
+
+
+/*
+ * free_hostrslvq() - free a host name lookup queue
+ */
+
+static void
+free_hostrslvq(q)
+	struct hostrslvq *q;		/* queue */
+{
+	int i;
+
+	for (i = 0; i < q->n; i++) {
+	    if (q->e[i].name)
+		(void) free((FREE_P *)q->e[i].name);
+	}
+	(void) pthread_cond_destroy(&q->cv);
+	(void) pthread_mutex_destroy(&q->mtx);
+	(void) free((FREE_P *)q->e);
+	(void) free((FREE_P *)q);
+}
+
+
+/*
+ * lkup_hostnm_thr() - host name lookup thread
+ *
+ * The last thread to leave a queue that lkup_hostnms() abandoned frees it.
+ */
+
+static void *
+lkup_hostnm_thr(arg)
+	void *arg;			/* lookup queue */
+{
+	struct hostrslv *e;
+	int fq = 0;
+	char hbuf[256];
+	struct hostrslvq *q = (struct hostrslvq *)arg;
+	int rv;
+	struct sockaddr_in sa4;
+
+# if	defined(HASIPv6)
+	struct sockaddr_in6 sa6;
+# endif	/* defined(HASIPv6) */
+
+	struct sockaddr *sa;
+	socklen_t sl;
+
+	(void) pthread_mutex_lock(&q->mtx);
+	while (!q->expired && (q->nx < q->n)) {
+	    e = &q->e[q->nx++];
+	    (void) pthread_mutex_unlock(&q->mtx);
+
+# if	defined(HASIPv6)
+	    if (e->af == AF_INET6) {
+		zeromem((char *)&sa6, sizeof(sa6));
+		sa6.sin6_family = AF_INET6;
+		(void) memcpy((void *)&sa6.sin6_addr, (void *)e->a,
+			      sizeof(sa6.sin6_addr));
+		sa = (struct sockaddr *)&sa6;
+		sl = (socklen_t)sizeof(sa6);
 	    } else
-#endif	/* defined(HASIPv6) */
+# endif	/* defined(HASIPv6) */
 
-	    if (af == AF_INET)
-		(void) snpf(hbuf, sizeof(hbuf), "%u.%u.%u.%u", ia[0], ia[1],
-			    ia[2], ia[3]);
+	    {
+		zeromem((char *)&sa4, sizeof(sa4));
+		sa4.sin_family = AF_INET;
+		(void) memcpy((void *)&sa4.sin_addr, (void *)e->a,
+			      sizeof(sa4.sin_addr));
+		sa = (struct sockaddr *)&sa4;
+		sl = (socklen_t)sizeof(sa4);
+	    }
+	    rv = getnameinfo(sa, sl, hbuf, sizeof(hbuf), (char *)NULL, 0,
+			     NI_NAMEREQD);
+	    (void) pthread_mutex_lock(&q->mtx);
+	    if (!rv && !q->expired)
+		e->name = mkstrcpy(hbuf, (MALLOC_S *)NULL);
+	    if (++q->nd >= q->n)
+		(void) pthread_cond_signal(&q->cv);
+	}
+	if (--q->nthr == 0) {
+	    if (q->expired)
+		fq = 1;
 	    else
-		(void) snpf(hbuf, sizeof(hbuf), "(unknown AF value: %d)", af);
-	    hn = hbuf;
-	} else
-	    hn = (char *)he->h_name;
+		(void) pthread_cond_signal(&q->cv);
+	}
+	(void) pthread_mutex_unlock(&q->mtx);
+	if (fq)
+	    (void) free_hostrslvq(q);
+	(void) pthread_mutex_lock(&Hrmtx);
+	Hrthr--;
+	(void) pthread_mutex_unlock(&Hrmtx);
+	return((void *)NULL);
+}
+
+
 /*
- * Allocate space for name and copy name to it.
+ * lkup_hostnms() - look up the host names of the selected files' Internet
+ *		    addresses in parallel and enter them in the host cache
+ *
+ * At most HASPARHOSTRSLV lookups are in progress at once, and all of them
+ * together are limited to TmLimit seconds.  Addresses whose lookups haven't
+ * finished by then are entered in numeric form, so that printing never
+ * waits for the resolver.
+ *
+ * Threads still blocked in the resolver when the time limit expires count
+ * against HASPARHOSTRSLV until they return, so that repeat mode cycles can't
+ * pile up more of them.
  */
-	if (!(np = mkstrcpy(hn, (MALLOC_S *)NULL))) {
-	    (void) fprintf(stderr, "%s: no space for host name: ", Pn);
-	    safestrprt(hn, stderr, 1);
+
+void
+lkup_hostnms()
+{
+	int af, al, i, j, n, rv;
+	char hbuf[256];
+	struct lfile *lf;
+	struct linaddr *li;
+	struct lproc *lp;
+	MALLOC_S len;
+	int ne = 0;
+	struct hostrslv *e = (struct hostrslv *)NULL;
+	pthread_attr_t pa;
+	struct hostrslvq *q;
+	sigset_t nm, om;
+	pthread_t t;
+	struct timespec ts;
+/*
+ * Collect the Internet addresses of the selected files that aren't already
+ * in the host cache.
+ */
+	for (i = n = 0; i < Nlproc; i++) {
+	    lp = &Lproc[i];
+	    if (!lp->pss)
+		continue;
+	    for (lf = lp->file; lf; lf = lf->next) {
+		if (!is_file_sel(lp, lf))
+		    continue;
+		li = LFCOLD(lf)->li;
+		for (j = 0; j < 2; j++) {
+		    if ((af = li[j].af) == AF_INET) {
+			if (li[j].ia.a4.s_addr == INADDR_ANY)
+			    continue;
+			al = MIN_AF_ADDR;
+		    }
+
+# if	defined(HASIPv6)
+		    else if (af == AF_INET6) {
+			if (IN6_IS_ADDR_UNSPECIFIED(&li[j].ia.a6))
+			    continue;
+			al = MAX_AF_ADDR;
+		    }
+# endif	/* defined(HASIPv6) */
+
+		    else
+			continue;
+		    if (srch_hostcache((unsigned char *)&li[j].ia, af, al))
+			continue;
+		    if (n >= ne) {
+			ne += HCINC;
+			len = (MALLOC_S)(ne * sizeof(struct hostrslv));
+			if (!e)
+			    e = (struct hostrslv *)malloc(len);
+			else
+			    e = (struct hostrslv *)realloc((MALLOC_P *)e, len);
+			if (!e) {
+			    (void) fprintf(stderr,
+				"%s: no space for host name lookups\n", Pn);
+			    Exit(1);
+			}
+		    }
+		    zeromem((char *)&e[n], sizeof(struct hostrslv));
+		    (void) memcpy((void *)e[n].a, (void *)&li[j].ia, al);
+		    e[n++].af = af;
+		}
+	    }
+	}
+	if (!n)
+	    return;
+/*
+ * Reduce the addresses to distinct ones.
+ */
+	(void) qsort((QSORT_P *)e, (size_t)n, sizeof(struct hostrslv),
+		     comp_hostrslv);
+	for (i = 1, j = 0; i < n; i++) {
+	    if (comp_hostrslv((COMP_P *)&e[j], (COMP_P *)&e[i]))
+		e[++j] = e[i];
+	}
+	n = j + 1;
+	size_hostcache(Hcn + n);
+/*
+ * Start the lookup threads.  They inherit a mask that blocks all signals, so
+ * that the SIGALRM of doinchild() is delivered to the main thread.
+ */
+	if (!(q = (struct hostrslvq *)malloc(sizeof(struct hostrslvq)))) {
+	    (void) fprintf(stderr, "%s: no space for host name lookups\n", Pn);
 	    Exit(1);
 	}
+	zeromem((char *)q, sizeof(struct hostrslvq));
+	q->e = e;
+	q->n = n;
+	(void) pthread_mutex_init(&q->mtx, (pthread_mutexattr_t *)NULL);
+	(void) pthread_cond_init(&q->cv, (pthread_condattr_t *)NULL);
+	(void) pthread_attr_init(&pa);
+	(void) pthread_attr_setdetachstate(&pa, PTHREAD_CREATE_DETACHED);
+	(void) sigfillset(&nm);
+	(void) pthread_sigmask(SIG_BLOCK, &nm, &om);
+	(void) pthread_mutex_lock(&q->mtx);
+	(void) pthread_mutex_lock(&Hrmtx);
+	for (i = 0; (Hrthr < HASPARHOSTRSLV) && (i < n); i++) {
+	    if (pthread_create(&t, &pa, lkup_hostnm_thr, (void *)q))
+		break;
+	    q->nthr++;
+	    Hrthr++;
+	}
+	(void) pthread_mutex_unlock(&Hrmtx);
+	(void) pthread_sigmask(SIG_SETMASK, &om, (sigset_t *)NULL);
+	(void) pthread_attr_destroy(&pa);
 /*
- * Add address/name entry to cache.  Allocate cache space in HCINC chunks.
+ * Wait for the lookups to finish or for the time limit to expire.
  */
-	if (hcx >= nhc) {
-	    nhc += HCINC;
-	    len = (MALLOC_S)(nhc * sizeof(struct hostcache));
-	    if (!hc)
-		hc = (struct hostcache *)malloc(len);
-	    else
-		hc = (struct hostcache *)realloc((MALLOC_P *)hc, len);
-	    if (!hc) {
-		(void) fprintf(stderr, "%s: no space for host cache\n", Pn);
-		Exit(1);
-	    }
+	(void) clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += TmLimit;
+	for (rv = 0; q->nthr && (q->nd < q->n) && (rv != ETIMEDOUT);) {
+	    rv = pthread_cond_timedwait(&q->cv, &q->mtx, &ts);
 	}
-	hc[hcx].af = af;
-	for (i = 0; i < al; i++) {
-	    hc[hcx].a[i] = ia[i];
+	q->expired = 1;
+/*
+ * Enter the results in the host cache.  Use the numeric form of addresses
+ * that have no name or whose lookup didn't finish.
+ */
+	for (i = 0; i < n; i++) {
+	    al = (e[i].af == AF_INET) ? MIN_AF_ADDR : MAX_AF_ADDR;
+	    if (e[i].name) {
+		(void) enter_hostcache(e[i].a, e[i].af, al, e[i].name);
+		(void) free((FREE_P *)e[i].name);
+		e[i].name = (char *)NULL;
+	    } else {
+		fmt_hostnum(e[i].a, e[i].af, hbuf, sizeof(hbuf));
+		(void) enter_hostcache(e[i].a, e[i].af, al, hbuf);
+	    }
 	}
-	hc[hcx++].name = np;
-	return(np);
+/*
+ * Threads still blocked in the resolver are abandoned; they reference the
+ * queue, so the last of them frees it.
+ */
+	i = q->nthr;
+	(void) pthread_mutex_unlock(&q->mtx);
+	if (!i)
+	    (void) free_hostrslvq(q);
 }
+#endif	/* defined(HASPARHOSTRSLV) */
 
 
 /*
@@ -902,8 +1350,9 @@ print_file()
 
 # if	!defined(HASNOFSADDR)
 	    if (Fsv & FSV_FA) {
-		cp =  (Lf->fsv & FSV_FA) ? print_kptr(Lf->fsa, buf, sizeof(buf))
-					 : "";
+		cp =  (Lf->fsv & FSV_FA)
+		   ? print_kptr(LFCOLD(Lf)->fsa, buf, sizeof(buf))
+		   : "";
 		if (!PrPass) {
 		    if ((len = strlen(cp)) > FsColW)
 			FsColW = len;
@@ -916,7 +1365,7 @@ print_file()
 # if	!defined(HASNOFSCOUNT)
 	    if (Fsv & FSV_CT) {
 		if (Lf->fsv & FSV_CT) {
-		    (void) snpf(buf, sizeof(buf), "%ld", Lf->fct);
+		    (void) snpf(buf, sizeof(buf), "%ld", LFCOLD(Lf)->fct);
 		    cp = buf;
 		} else
 		    cp = "";
@@ -944,8 +1393,9 @@ print_file()
 
 # if	!defined(HASNOFSNADDR)
 	    if (Fsv & FSV_NI) {
-		cp = (Lf->fsv & FSV_NI) ? print_kptr(Lf->fna, buf, sizeof(buf))
-					: "";
+		cp = (Lf->fsv & FSV_NI)
+		   ? print_kptr(LFCOLD(Lf)->fna, buf, sizeof(buf))
+		   : "";
 		if (!PrPass) {
 		    if ((len = strlen(cp)) > NiColW)
 			NiColW = len;
@@ -1149,12 +1599,13 @@ printinaddr()
 	int nl = Namechl - 1;
 	char *np = Namech;
 	char pbuf[32];
+	struct linaddr *li = LFCOLD(Lf)->li;
 /*
  * Process local network address first.  If there's a foreign address,
  * separate it from the local address with "->".
  */
 	for (i = 0, *np = '\0'; i < 2; i++) {
-	    if (!Lf->li[i].af)
+	    if (!li[i].af)
 		continue;
 	    host = port = (char *)NULL;
 	    if (i) {
@@ -1180,24 +1631,24 @@ addr_too_long:
 	 */
 
 #if	defined(HASIPv6)
-	    if ((Lf->li[i].af == AF_INET6
-	    &&   IN6_IS_ADDR_UNSPECIFIED(&Lf->li[i].ia.a6))
-	    ||  (Lf->li[i].af == AF_INET
-	    &&    Lf->li[i].ia.a4.s_addr == INADDR_ANY))
+	    if ((li[i].af == AF_INET6
+	    &&   IN6_IS_ADDR_UNSPECIFIED(&li[i].ia.a6))
+	    ||  (li[i].af == AF_INET
+	    &&    li[i].ia.a4.s_addr == INADDR_ANY))
 		host ="*";
 	    else
-		host = gethostnm((unsigned char *)&Lf->li[i].ia, Lf->li[i].af);
+		host = gethostnm((unsigned char *)&li[i].ia, li[i].af);
 #else /* !defined(HASIPv6) */
-	    if (Lf->li[i].ia.a4.s_addr == INADDR_ANY)
+	    if (li[i].ia.a4.s_addr == INADDR_ANY)
 		host ="*";
 	    else
-		host = gethostnm((unsigned char *)&Lf->li[i].ia, Lf->li[i].af);
+		host = gethostnm((unsigned char *)&li[i].ia, li[i].af);
 #endif	/* defined(HASIPv6) */
 
 	/*
 	 * Process the port number.
 	 */
-	    if (Lf->li[i].p > 0) {
+	    if (li[i].p > 0) {
 
 		if (Fport
 
@@ -1222,18 +1673,18 @@ addr_too_long:
 		    if ((src = i) && FportMap) {
 
 # if	defined(HASIPv6)
-			if (Lf->li[0].af == AF_INET6) {
-			    if (IN6_IS_ADDR_LOOPBACK(&Lf->li[i].ia.a6)
-			    ||  IN6_ARE_ADDR_EQUAL(&Lf->li[0].ia.a6,
-						   &Lf->li[1].ia.a6)
+			if (li[0].af == AF_INET6) {
+			    if (IN6_IS_ADDR_LOOPBACK(&li[i].ia.a6)
+			    ||  IN6_ARE_ADDR_EQUAL(&li[0].ia.a6,
+						   &li[1].ia.a6)
 			    )
 				src = 0;
 			} else
 # endif	/* defined(HASIPv6) */
 
-			if (Lf->li[0].af == AF_INET) {
-			    if (Lf->li[i].ia.a4.s_addr == htonl(INADDR_LOOPBACK)
-			    ||  Lf->li[0].ia.a4.s_addr == Lf->li[1].ia.a4.s_addr
+			if (li[0].af == AF_INET) {
+			    if (li[i].ia.a4.s_addr == htonl(INADDR_LOOPBACK)
+			    ||  li[0].ia.a4.s_addr == li[1].ia.a4.s_addr
 			    )
 				src = 0;
 			}
@@ -1241,15 +1692,15 @@ addr_too_long:
 #endif	/* !defined(HASNORPC_H) */
 
 		    if (strcasecmp(Lf->iproto, "TCP") == 0)
-			port = lkup_port(Lf->li[i].p, 0, src);
+			port = lkup_port(li[i].p, 0, src);
 		    else if (strcasecmp(Lf->iproto, "UDP") == 0)
-			port = lkup_port(Lf->li[i].p, 1, src);
+			port = lkup_port(li[i].p, 1, src);
 		}
 		if (!port) {
-		    (void) snpf(pbuf, sizeof(pbuf), "%d", Lf->li[i].p);
+		    (void) snpf(pbuf, sizeof(pbuf), "%d", li[i].p);
 		    port = pbuf;
 		}
-	    } else if (Lf->li[i].p == 0)
+	    } else if (li[i].p == 0)
 		port = "*";
 	/*
 	 * Enter the host name.
@@ -2036,10 +2487,10 @@ printname(nl)
 	 */
 	    safestrprt(Lf->nm, stdout, 0);
 	    ps++;
-	    if (!Lf->li[0].af && !Lf->li[1].af)
+	    if (!LFCOLD(Lf)->li[0].af && !LFCOLD(Lf)->li[1].af)
 		goto print_nma;
 	}
-	if (Lf->li[0].af || Lf->li[1].af) {
+	if (LFCOLD(Lf)->li[0].af || LFCOLD(Lf)->li[1].af) {
 	    if (ps)
 		putchar(' ');
 	/*
@@ -2083,21 +2534,28 @@ printname(nl)
 	 * Do a deferred local mount info table search for the file system
 	 * (mounted) directory name and inode number, and mounted device name.
 	 */
+
+#if	defined(HASMNTDEVIX)
+	    mp = find_mntdev(Lf->dev, (char *)NULL);
+#else	/* !defined(HASMNTDEVIX) */
 	    for (mp = readmnt(); mp; mp = mp->next) {
-		if (Lf->dev == mp->dev) {
-		    Lf->fsdir = mp->dir;
-		    Lf->fsdev = mp->fsname;
+		if (Lf->dev == mp->dev)
+		    break;
+	    }
+#endif	/* defined(HASMNTDEVIX) */
+
+	    if (mp) {
+		LFCOLDW(Lf)->fsdir = mp->dir;
+		LFCOLDW(Lf)->fsdev = mp->fsname;
 
 #if	defined(HASFSINO)
-		    Lf->fs_ino = mp->inode;
+		Lf->fs_ino = mp->inode;
 #endif	/* defined(HASFSINO) */
 
-		    break;
-		}
 	    }
 	    Lf->lmi_srch = 0;
 	}
-	if (Lf->fsdir || Lf->fsdev) {
+	if (LFCOLD(Lf)->fsdir || LFCOLD(Lf)->fsdev) {
 
 	/*
 	 * Print the file system directory name, device name, and
@@ -2105,8 +2563,8 @@ printname(nl)
 	 */
 
 #if	!defined(HASNCACHE) || HASNCACHE<2
-	    if (Lf->fsdir) {
-		safestrprt(Lf->fsdir, stdout, 0);
+	    if (LFCOLD(Lf)->fsdir) {
+		safestrprt(LFCOLD(Lf)->fsdir, stdout, 0);
 		ps++;
 	    }
 #endif	/* !defined(HASNCACHE) || HASNCACHE<2 */
@@ -2134,9 +2592,9 @@ printname(nl)
 
 		    if (*cp == '\0')
 			goto print_nma;
-		    if (fp && Lf->fsdir) {
+		    if (fp && LFCOLD(Lf)->fsdir) {
 			if (*cp != '/') {
-			    cp1 = strrchr(Lf->fsdir, '/');
+			    cp1 = strrchr(LFCOLD(Lf)->fsdir, '/');
 			    if (cp1 == (char *)NULL ||  *(cp1 + 1) != '\0')
 				putchar('/');
 			    }
@@ -2167,8 +2625,8 @@ printname(nl)
 		    safestrprt(cp, stdout, 0);
 		    ps++;
 		} else {
-		    if (Lf->fsdir) {
-			safestrprt(Lf->fsdir, stdout, 0);
+		    if (LFCOLD(Lf)->fsdir) {
+			safestrprt(LFCOLD(Lf)->fsdir, stdout, 0);
 			ps++;
 		    }
 		    if (*cp) {
@@ -2179,19 +2637,19 @@ printname(nl)
 		}
 		goto print_nma;
 	    }
-	    if (Lf->fsdir) {
-		safestrprt(Lf->fsdir, stdout, 0);
+	    if (LFCOLD(Lf)->fsdir) {
+		safestrprt(LFCOLD(Lf)->fsdir, stdout, 0);
 		ps++;
 	    }
 # endif	/* HASNCACHE<2 */
 #endif	/* defined(HASNCACHE) */
 
-	    if (Lf->fsdev) {
-		if (Lf->fsdir)
+	    if (LFCOLD(Lf)->fsdev) {
+		if (LFCOLD(Lf)->fsdir)
 		    (void) fputs(" (", stdout);
 		else
 		    (void) putchar('(');
-		safestrprt(Lf->fsdev, stdout, 0);
+		safestrprt(LFCOLD(Lf)->fsdev, stdout, 0);
 		(void) putchar(')');
 		ps++;
 	    }
@@ -2213,14 +2671,16 @@ print_nma:
  * If this file has TCP/IP state information, print it.
  */
 	if (!Ffield && Ftcptpi
-	&&  (Lf->lts.type >= 0
+	&&  (LFCOLD(Lf)->lts.type >= 0
 
 #if	defined(HASTCPTPIQ)
-	||   ((Ftcptpi & TCPTPI_QUEUES) && (Lf->lts.rqs || Lf->lts.sqs))
+	||   ((Ftcptpi & TCPTPI_QUEUES)
+	&&    (LFCOLD(Lf)->lts.rqs || LFCOLD(Lf)->lts.sqs))
 #endif	/* defined(HASTCPTPIQ) */
 
 #if	defined(HASTCPTPIW)
-	||   ((Ftcptpi & TCPTPI_WINDOWS) && (Lf->lts.rws || Lf->lts.wws))
+	||   ((Ftcptpi & TCPTPI_WINDOWS)
+	&&    (LFCOLD(Lf)->lts.rws || LFCOLD(Lf)->lts.wws))
 #endif	/* defined(HASTCPTPIW) */
 
 	)) {
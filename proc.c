@@ -37,7 +37,51 @@ static char copyright[] =
 
 #include "lsof.h"
 
+
+#if	defined(HASLPARENA)
+/*
+ * Local static values
+ */
+
+static struct lpachunk *Lfch = (struct lpachunk *)NULL;
+					/* arena chunk of Lf */
+static MALLOC_S Lfmk = 0;		/* Lfch->used after Lf was carved */
+static unsigned long Lfser = 0;		/* arena serial number of Lf */
+static unsigned long Lpaser = 0;	/* last arena serial number */
+
+static struct {				/* arena statistics */
+	unsigned long na;		/* allocations */
+	unsigned long nab;		/* allocated bytes */
+	unsigned long nc;		/* chunks */
+	unsigned long ncb;		/* chunk bytes */
+	unsigned long nf;		/* freed chunks */
+} Lpast;
+#endif	/* defined(HASLPARENA) */
+
+#if	defined(HASLPARENA)
+_PROTOTYPE(static int resize_lpa,(char *cp, MALLOC_S olen, MALLOC_S len));
+#endif	/* defined(HASLPARENA) */
+
 #if	defined(HASEPTOPTS)
+/*
+ * Endpoint files -- the files link_lfile() found to have endpoint information,
+ * in the order they were linked
+ */
+
+#define	EPTFMIN		64		/* minimum Eptf[] allocation */
+
+typedef struct eptfile {
+	int lpx;			/* Lproc[] index of the file's process */
+	struct lfile *lf;		/* the file */
+	short ept;			/* the file's EPT_* types */
+} eptfile_t;
+
+static eptfile_t *Eptf = (eptfile_t *)NULL;
+					/* endpoint files */
+static int Eptfn = 0;			/* Eptf[] entries in use */
+static int Eptfsz = 0;			/* Eptf[] entries allocated */
+
+_PROTOTYPE(static void enter_eptfile,(short ept));
 _PROTOTYPE(static void prt_pinfo,(pxinfo_t *pp, int ps));
 _PROTOTYPE(static void prt_psxmqinfo,(pxinfo_t *pp, int ps));
 _PROTOTYPE(static void prt_evtfdinfo,(pxinfo_t *pp, int ps));
@@ -60,6 +104,31 @@ add_nma(cp, len)
 
 	if (!cp || !len)
 	    return;
+
+#if	defined(HASLPARENA)
+	if (Lf->nma) {
+	    char *np;
+
+	/*
+	 * Grow the old addition if it's the arena's last allocation.
+	 * Otherwise copy it, and leave as much room again after the copy,
+	 * since endpoint processing can add to one file thousands of times.
+	 */
+	    nl = (int) strlen(Lf->nma);
+	    if (!resize_lpa(Lf->nma, (MALLOC_S)(nl + 1),
+			    (MALLOC_S)(len + nl + 2)))
+	    {
+		np = alloc_lpa((MALLOC_S)(len + nl + 2) * 2);
+		(void) resize_lpa(np, (MALLOC_S)(len + nl + 2) * 2,
+				  (MALLOC_S)(len + nl + 2));
+		(void) strcpy(np, Lf->nma);
+		Lf->nma = np;
+	    }
+	} else {
+	    nl = 0;
+	    Lf->nma = alloc_lpa((MALLOC_S)(len + 1));
+	}
+#else	/* !defined(HASLPARENA) */
 	if (Lf->nma) {
 	    nl = (int) strlen(Lf->nma);
 	    Lf->nma = (char *) realloc((MALLOC_P *)Lf->nma,
@@ -68,6 +137,8 @@ add_nma(cp, len)
 	    nl = 0;
 	    Lf->nma = (char *) malloc((MALLOC_S)(len + 1));
 	}
+#endif	/* defined(HASLPARENA) */
+
 	if (!Lf->nma) {
 	    (void) fprintf(stderr, "%s: no name addition space: PID %ld, FD %s",
 		Pn, (long)Lp->pid, Lf->fd);
@@ -118,6 +189,26 @@ alloc_fflbuf(bp, al, lr)
 #endif	/* defined(HASFSTRUCT) */
 
 
+#if	defined(HASLFILECOLD)
+/*
+ * alloc_lfcold() - give a local file structure its own cold record
+ */
+
+struct lfcold *
+alloc_lfcold(lf)
+	struct lfile *lf;		/* local file structure -- of the
+					 * current process, Lp */
+{
+	struct lfcold *c;
+
+	c = (struct lfcold *)alloc_lpa((MALLOC_S)sizeof(struct lfcold));
+	*c = Lfcold0;
+	lf->cold = c;
+	return(c);
+}
+#endif	/* defined(HASLFILECOLD) */
+
+
 /*
  * alloc_lfile() - allocate local file structure space
  */
@@ -130,6 +221,34 @@ alloc_lfile(nm, num)
 {
 	int fds;
 
+#if	defined(HASLPARENA)
+/*
+ * An unlinked structure left by another process belongs to that process'
+ * arena, which may be gone, so forget it.
+ */
+	if (Lf && (!Lp->arena || (Lp->arena->ser != Lfser)))
+	    Lf = (struct lfile *)NULL;
+	if (Lf) {
+
+	/*
+	 * If reusing a previously allocated structure, give back the arena
+	 * space its strings used -- everything carved after it -- when it
+	 * is in the same chunk.
+	 */
+	    if (Lp->arena == Lfch)
+		Lfch->used = Lfmk;
+
+# if	defined(HASLFILEADD) && defined(CLRLFILEADD)
+	    CLRLFILEADD(Lf)
+# endif	/* defined(HASLFILEADD) && defined(CLRLFILEADD) */
+
+	} else {
+	    Lf = (struct lfile *)alloc_lpa((MALLOC_S)sizeof(struct lfile));
+	    Lfch = Lp->arena;
+	    Lfmk = Lfch->used;
+	    Lfser = Lfch->ser;
+	}
+#else	/* !defined(HASLPARENA) */
 	if (Lf) {
 /*
  * If reusing a previously allocated structure, release any allocated
@@ -154,16 +273,17 @@ alloc_lfile(nm, num)
 		Pn, Lp->pid);
 	    Exit(1);
 	}
+#endif	/* defined(HASLPARENA) */
+
 /*
  * Initialize the structure.
  */
 	Lf->access = Lf->lock = ' ';
+	Lf->delta = '\0';
 	Lf->dev_def = Lf->inp_ty = Lf->is_com = Lf->is_nfs = Lf->is_stream
 		    = Lf->lmi_srch = Lf->nlink_def = Lf->off_def = Lf->sz_def
 		    = Lf->rdev_def
 		    = (unsigned char)0;
-	Lf->li[0].af = Lf->li[1].af = 0;
-	Lf->lts.type = -1;
 	Lf->nlink = 0l;
 
 #if	defined(HASMNTSTAT)
@@ -172,38 +292,65 @@ alloc_lfile(nm, num)
 
 #if	defined(HASEPTOPTS)
 	Lf->chend = 0;
+#endif	/* defined(HASEPTOPTS) */
+
+#if	defined(HASLFILECOLD)
+/*
+ * Point the file to the shared default cold record, setting its non-zero
+ * defaults the first time.
+ */
+	if (!Lfcold0.lts.type) {
+	    Lfcold0.lts.type = -1;
+
+# if	defined(HASEPTOPTS)
+	    Lfcold0.eventfd_id = -1;
+#  if	defined(HASPTYEPT)
+	    Lfcold0.tty_index  = -1;
+#  endif	/* defined(HASPTYEPT) */
+# endif	/* defined(HASEPTOPTS) */
+
+	}
+	Lf->cold = &Lfcold0;
+#else	/* !defined(HASLFILECOLD) */
+	Lf->li[0].af = Lf->li[1].af = 0;
+	Lf->lts.type = -1;
+
+# if	defined(HASEPTOPTS)
 	Lf->eventfd_id = -1;
-#if	defined(HASPTYEPT)
+#  if	defined(HASPTYEPT)
 	Lf->tty_index  = -1;
-#endif	/* defined(HASPTYEPT) */
-#endif	/* defined(HASEPTOPTS) */
+#  endif	/* defined(HASPTYEPT) */
+# endif	/* defined(HASEPTOPTS) */
 
-#if	defined(HASSOOPT)
+# if	defined(HASSOOPT)
 	Lf->lts.kai = Lf->lts.ltm = 0;
 	Lf->lts.opt = Lf->lts.qlen = Lf->lts.qlim = Lf->lts.pqlen
 		    = (unsigned int)0;
 	Lf->lts.rbsz = Lf->lts.sbsz = (unsigned long)0;
 	Lf->lts.qlens = Lf->lts.qlims = Lf->lts.pqlens = Lf->lts.rbszs
 		      = Lf->lts.sbszs = (unsigned char)0;
-#endif	/* defined(HASSOOPT) */
+# endif	/* defined(HASSOOPT) */
 
-#if	defined(HASSOSTATE)
+# if	defined(HASSOSTATE)
 	Lf->lts.ss = 0;
-#endif	/* defined(HASSOSTATE) */
+# endif	/* defined(HASSOSTATE) */
 
-#if	defined(HASTCPOPT)
+# if	defined(HASTCPOPT)
 	Lf->lts.mss = (unsigned long)0;
 	Lf->lts.msss = (unsigned char)0;
 	Lf->lts.topt = (unsigned int)0;
-#endif	/* defined(HASTCPOPT) */
+# endif	/* defined(HASTCPOPT) */
 
-#if	defined(HASTCPTPIQ)
+# if	defined(HASTCPTPIQ)
 	Lf->lts.rqs = Lf->lts.sqs = (unsigned char)0;
-#endif	/* defined(HASTCPTPIQ) */
+# endif	/* defined(HASTCPTPIQ) */
 
-#if	defined(HASTCPTPIW)
+# if	defined(HASTCPTPIW)
 	Lf->lts.rws = Lf->lts.wws = (unsigned char)0;
-#endif	/* defined(HASTCPTPIW) */
+# endif	/* defined(HASTCPTPIW) */
+
+	Lf->fsdir = Lf->fsdev = (char *)NULL;
+#endif	/* defined(HASLFILECOLD) */
 
 #if	defined(HASFSINO)
 	Lf->fs_ino = 0;
@@ -230,7 +377,7 @@ alloc_lfile(nm, num)
 		(void) snpf(Lf->fd, sizeof(Lf->fd), "*%03d", num % 1000);
 	} else
 	    Lf->fd[0] = '\0';
-	Lf->dev_ch = Lf->fsdir = Lf->fsdev = Lf->nm = Lf->nma = (char *)NULL;
+	Lf->dev_ch = Lf->nm = Lf->nma = (char *)NULL;
 	Lf->ch = -1;
 
 #if	defined(HASNCACHE) && HASNCACHE<2
@@ -242,9 +389,13 @@ alloc_lfile(nm, num)
 	Namech[0] = '\0';
 
 #if	defined(HASFSTRUCT)
-	Lf->fct = Lf->ffg = Lf->pof = (long)0;
-	Lf->fna = (KA_T)NULL;
+	Lf->ffg = Lf->pof = (long)0;
 	Lf->fsv = (unsigned char)0;
+
+# if	!defined(HASLFILECOLD)
+	Lf->fct = (long)0;
+	Lf->fna = (KA_T)NULL;
+# endif	/* !defined(HASLFILECOLD) */
 #endif	/* defined(HASFSTRUCT) */
 
 #if	defined(HASLFILEADD) && defined(SETLFILEADD)
@@ -272,6 +423,86 @@ alloc_lfile(nm, num)
 }
 
 
+#if	defined(HASLPARENA)
+/*
+ * alloc_lpa() - allocate space from the arena of the current process
+ */
+
+char *
+alloc_lpa(len)
+	MALLOC_S len;			/* required length */
+{
+	struct lpachunk *ch;
+	MALLOC_S sz;
+	char *cp;
+
+	len = (len + LPAALIGN - 1) & ~((MALLOC_S)LPAALIGN - 1);
+	Lpast.na++;
+	Lpast.nab += (unsigned long)len;
+	if (!(ch = Lp->arena) || ((ch->sz - ch->used) < len)) {
+
+	/*
+	 * Add a chunk, twice the size of the previous one, up to LPAMAX.
+	 */
+	    if (!ch)
+		sz = LPAMIN;
+	    else if ((sz = ch->sz * 2) > LPAMAX)
+		sz = LPAMAX;
+	    if (sz < len)
+		sz = len;
+	    if (!(ch = (struct lpachunk *)malloc(sizeof(struct lpachunk) + sz)))
+	    {
+		(void) fprintf(stderr,
+		    "%s: PID %d, no space for %d arena bytes\n",
+		    Pn, Lp->pid, (int)sz);
+		Exit(1);
+	    }
+	    Lpast.nc++;
+	    Lpast.ncb += (unsigned long)sz;
+	    ch->next = Lp->arena;
+	    ch->ser = Lp->arena ? Lp->arena->ser : ++Lpaser;
+	    ch->sz = sz;
+	    ch->used = 0;
+	    Lp->arena = ch;
+	}
+	cp = (char *)(ch + 1) + ch->used;
+	ch->used += len;
+	return(cp);
+}
+
+
+/*
+ * resize_lpa() - resize the last allocation from the current process' arena
+ *
+ * return: 1 if the allocation was the last and has been resized; 0 otherwise
+ */
+
+static int
+resize_lpa(cp, olen, len)
+	char *cp;			/* allocation */
+	MALLOC_S olen;			/* its length */
+	MALLOC_S len;			/* its new length */
+{
+	struct lpachunk *ch;
+
+	olen = (olen + LPAALIGN - 1) & ~((MALLOC_S)LPAALIGN - 1);
+	len = (len + LPAALIGN - 1) & ~((MALLOC_S)LPAALIGN - 1);
+	if (!(ch = Lp->arena)
+	||  ((cp + olen) != ((char *)(ch + 1) + ch->used))
+	||  ((ch->sz - ch->used + olen) < len))
+	    return(0);
+	if (len > olen) {
+	    ch->used += len - olen;
+	    Lpast.nab += (unsigned long)(len - olen);
+	} else {
+	    ch->used -= olen - len;
+	    Lpast.nab -= (unsigned long)(olen - len);
+	}
+	return(1);
+}
+#endif	/* defined(HASLPARENA) */
+
+
 /*
  * alloc_lproc() - allocate local proc structure space
  */
@@ -324,18 +555,24 @@ alloc_lproc(pid, pgid, ppid, uid, cmd, pss, sf)
 	Lp->pgid = pgid;
 	Lp->ppid = ppid;
 	Lp->file = (struct lfile *)NULL;
-	Lp->sf = (short)sf;
+	Lp->sf = sf;
 	Lp->pss = (short)pss;
 	Lp->uid = (uid_t)uid;
 /*
  * Allocate space for the full command name and copy it there.
  */
+
+#if	defined(HASLPARENA)
+	Lp->arena = (struct lpachunk *)NULL;
+	Lp->cmd = mkstrlpa(cmd);
+#else	/* !defined(HASLPARENA) */
 	if (!(Lp->cmd = mkstrcpy(cmd, (MALLOC_S *)NULL))) {
 	    (void) fprintf(stderr, "%s: PID %d, no space for command name: ",
 		Pn, pid);
 	    safestrprt(cmd, stderr, 1);
 	    Exit(1);
 	}
+#endif	/* defined(HASLPARENA) */
 
 #if	defined(HASZONES)
 /*
@@ -343,6 +580,14 @@ alloc_lproc(pid, pgid, ppid, uid, cmd, pss, sf)
  */
 	Lp->zn = (char *)NULL;
 #endif	/* defined(HASZONES) */
+
+#if	defined(HASMNTNS)
+/*
+ * Clear the mount namespace pointer.  The dialect's mount table search sets
+ * it.
+ */
+	Lp->mntns = (struct mntns *)NULL;
+#endif	/* defined(HASMNTNS) */
  
 #if	defined(HASSELINUX)
 /*
@@ -454,31 +699,31 @@ ent_inaddr(la, lp, fa, fp, af)
 	int m;
 
 	if (la) {
-	    Lf->li[0].af = af;
+	    LFCOLDW(Lf)->li[0].af = af;
 
 #if	defined(HASIPv6)
 	    if (af == AF_INET6)
-		Lf->li[0].ia.a6 = *(struct in6_addr *)la;
+		LFCOLDW(Lf)->li[0].ia.a6 = *(struct in6_addr *)la;
 	    else
 #endif	/* defined(HASIPv6) */
 
-		Lf->li[0].ia.a4 = *(struct in_addr *)la;
-	    Lf->li[0].p = lp;
+		LFCOLDW(Lf)->li[0].ia.a4 = *(struct in_addr *)la;
+	    LFCOLDW(Lf)->li[0].p = lp;
 	} else
-	    Lf->li[0].af = 0;
+	    LFCOLDW(Lf)->li[0].af = 0;
 	if (fa) {
-	    Lf->li[1].af = af;
+	    LFCOLDW(Lf)->li[1].af = af;
 
 #if	defined(HASIPv6)
 	    if (af == AF_INET6)
-		Lf->li[1].ia.a6 = *(struct in6_addr *)fa;
+		LFCOLDW(Lf)->li[1].ia.a6 = *(struct in6_addr *)fa;
 	    else
 #endif	/* defined(HASIPv6) */
 
-		Lf->li[1].ia.a4 = *(struct in_addr *)fa;
-	    Lf->li[1].p = fp;
+		LFCOLDW(Lf)->li[1].ia.a4 = *(struct in_addr *)fa;
+	    LFCOLDW(Lf)->li[1].p = fp;
 	} else
-	    Lf->li[1].af = 0;
+	    LFCOLDW(Lf)->li[1].af = 0;
 /*
  * If network address matching has been selected, check both addresses.
  */
@@ -491,6 +736,37 @@ ent_inaddr(la, lp, fa, fp, af)
 }
 
 
+#if	defined(HASEPTOPTS)
+/*
+ * enter_eptfile() - enter the file at Lf in the endpoint file list
+ */
+
+static void
+enter_eptfile(ept)
+	short ept;			/* the file's EPT_* types */
+{
+	MALLOC_S len;
+
+	if (Eptfn >= Eptfsz) {
+	    Eptfsz = Eptfsz ? (Eptfsz * 2) : EPTFMIN;
+	    len = (MALLOC_S)(Eptfsz * sizeof(eptfile_t));
+	    if (Eptf)
+		Eptf = (eptfile_t *)realloc((MALLOC_P *)Eptf, len);
+	    else
+		Eptf = (eptfile_t *)malloc(len);
+	    if (!Eptf) {
+		(void) fprintf(stderr,
+		    "%s: no space for %d endpoint files\n", Pn, Eptfsz);
+		Exit(1);
+	    }
+	}
+	Eptf[Eptfn].lpx = (int)(Lp - Lproc);
+	Eptf[Eptfn].lf = Lf;
+	Eptf[Eptfn++].ept = ept;
+}
+#endif	/* defined(HASEPTOPTS) */
+
+
 /*
  * examine_lproc() - examine local process
  *
@@ -542,6 +818,30 @@ examine_lproc()
 }
 
 
+/*
+ * find_selidx() - find a selection ID's selection table index
+ *
+ * return: the index, or -1 if the ID isn't in the selection table
+ */
+
+int
+find_selidx(h, id)
+	struct selidx *h;		/* index */
+	unsigned long id;		/* PID, PGID or UID */
+{
+	int j;
+
+	if (!h->n)
+	    return(-1);
+	for (j = SELIDHASH(id, h->sz); h->t[j].ix >= 0; j = (j + 1) & (h->sz - 1))
+	{
+	    if (h->t[j].id == id)
+		return(h->t[j].ix);
+	}
+	return(-1);
+}
+
+
 /*
  * free_lproc() - free lproc entry and its associated malloc'd space
  */
@@ -550,6 +850,35 @@ void
 free_lproc(lp)
 	struct lproc *lp;
 {
+
+#if	defined(HASLPARENA)
+	struct lpachunk *ch, *nch;
+
+# if	defined(HASLFILEADD) && defined(CLRLFILEADD)
+	struct lfile *lf;
+
+	for (lf = lp->file; lf; lf = lf->next) {
+	    CLRLFILEADD(lf)
+	}
+# endif	/* defined(HASLFILEADD) && defined(CLRLFILEADD) */
+
+/*
+ * The files and their strings, and the command names, are all in the
+ * arena.
+ */
+	for (ch = lp->arena; ch; ch = nch) {
+	    nch = ch->next;
+	    (void) free((FREE_P *)ch);
+	    Lpast.nf++;
+	}
+	lp->arena = (struct lpachunk *)NULL;
+	lp->file = (struct lfile *)NULL;
+	lp->cmd = (char *)NULL;
+
+# if	defined(HASTASKS)
+	lp->tcmd = (char *)NULL;
+# endif	/* defined(HASTASKS) */
+#else	/* !defined(HASLPARENA) */
 	struct lfile *lf, *nf;
 
 	for (lf = lp->file; lf; lf = nf) {
@@ -579,12 +908,13 @@ free_lproc(lp)
 	    lp->cmd = (char *)NULL;
 	}
 
-#if	defined(HASTASKS)
+# if	defined(HASTASKS)
 	if (lp->tcmd) {
 	    (void) free((FREE_P *)lp->tcmd);
 	    lp->tcmd = (char *)NULL;
 	}
-#endif	/* defined(HASTASKS) */
+# endif	/* defined(HASTASKS) */
+#endif	/* defined(HASLPARENA) */
 
 }
 
@@ -660,7 +990,7 @@ is_file_sel(lp, lf)
 {
 	if (!lf || !lf->sf)
 	    return(0);
-	if (Lf->sf & SELEXCLF)
+	if (lf->sf & SELEXCLF)
 	    return(0);
 
 #if	defined(HASSECURITY) && defined(HASNOSOCKSECURITY)
@@ -701,7 +1031,7 @@ is_proc_excl(pid, pgid, uid, pss, sf)
 #endif	/* defined(HASTASKS) */
 
 {
-	int i, j;
+	int i;
 
 	*pss = *sf = 0;
 
@@ -722,41 +1052,26 @@ is_proc_excl(pid, pgid, uid, pss, sf)
  * If the excluding of process listing by UID has been specified, see if the
  * owner of this process is excluded.
  */
-	if (Nuidexcl) {
-	    for (i = j = 0; (i < Nuid) && (j < Nuidexcl); i++) {
-		if (!Suid[i].excl)
-		    continue;
-		if (Suid[i].uid == (uid_t)uid)
-		    return(1);
-		j++;
-	    }
-	}
+	if (Nuidexcl
+	&&  ((i = find_selidx(&HbySuid, (unsigned long)(uid_t)uid)) >= 0)
+	&&  Suid[i].excl)
+	    return(1);
 /*
  * If the excluding of process listing by PGID has been specified, see if this
  * PGID is excluded.
  */
-	if (Npgidx) {
-	    for (i = j = 0; (i < Npgid) && (j < Npgidx); i++) {
-		if (!Spgid[i].x)
-		    continue;
-		if (Spgid[i].i == pgid)
-		    return(1);
-		j++;
-	    }
-	}
+	if (Npgidx
+	&&  ((i = find_selidx(&HbySpgid, (unsigned long)pgid)) >= 0)
+	&&  Spgid[i].x)
+	    return(1);
 /*
  * If the excluding of process listing by PID has been specified, see if this
  * PID is excluded.
  */
-	if (Npidx) {
-	    for (i = j = 0; (i < Npid) && (j < Npidx); i++) {
-		if (!Spid[i].x)
-		    continue;
-		if (Spid[i].i == pid)
-		    return(1);
-		j++;
-	    }
-	}
+	if (Npidx
+	&&  ((i = find_selidx(&HbySpid, (unsigned long)pid)) >= 0)
+	&&  Spid[i].x)
+	    return(1);
 /*
  * If the listing of all processes is selected, then this one is not excluded.
  *
@@ -780,18 +1095,14 @@ is_proc_excl(pid, pgid, uid, pss, sf)
  * if this one is included or excluded.
  */
 	if (Npgidi && (Selflags & SELPGID)) {
-	    for (i = j = 0; (i < Npgid) && (j < Npgidi); i++) {
-		if (Spgid[i].x)
-		    continue;
-		if (Spgid[i].i == pgid) {
-		    Spgid[i].f = 1;
-		    *pss = PS_PRI;
-		    *sf = SELPGID;
-		    if (Selflags == SELPGID)
-			return(0);
-		    break;
-		}
-		j++;
+	    if (((i = find_selidx(&HbySpgid, (unsigned long)pgid)) >= 0)
+	    &&  !Spgid[i].x)
+	    {
+		Spgid[i].f = 1;
+		*pss = PS_PRI;
+		*sf = SELPGID;
+		if (Selflags == SELPGID)
+		    return(0);
 	    }
 	    if ((Selflags == SELPGID) && !*sf)
 		return(1);
@@ -801,18 +1112,14 @@ is_proc_excl(pid, pgid, uid, pss, sf)
  * included or excluded.
  */
 	if (Npidi && (Selflags & SELPID)) {
-	    for (i = j = 0; (i < Npid) && (j < Npidi); i++) {
-		if (Spid[i].x)
-		    continue;
-		if (Spid[i].i == pid) {
-		    Spid[i].f = 1;
-		    *pss = PS_PRI;
-		    *sf |= SELPID;
-		    if (Selflags == SELPID)
-			return(0);
-		    break;
-		}
-		j++;
+	    if (((i = find_selidx(&HbySpid, (unsigned long)pid)) >= 0)
+	    &&  !Spid[i].x)
+	    {
+		Spid[i].f = 1;
+		*pss = PS_PRI;
+		*sf |= SELPID;
+		if (Selflags == SELPID)
+		    return(0);
 	    }
 	    if ((Selflags == SELPID) && !*sf)
 		return(1);
@@ -822,18 +1129,14 @@ is_proc_excl(pid, pgid, uid, pss, sf)
  * this process has been included.
  */
 	if (Nuidincl && (Selflags & SELUID)) {
-	    for (i = j = 0; (i < Nuid) && (j < Nuidincl); i++) {
-		if (Suid[i].excl)
-		    continue;
-		if (Suid[i].uid == (uid_t)uid) {
-		    Suid[i].f = 1;
-		    *pss = PS_PRI;
-		    *sf |= SELUID;
-		    if (Selflags == SELUID)
-			return(0);
-		    break;
-		}
-		j++;
+	    if (((i = find_selidx(&HbySuid, (unsigned long)(uid_t)uid)) >= 0)
+	    &&  !Suid[i].excl)
+	    {
+		Suid[i].f = 1;
+		*pss = PS_PRI;
+		*sf |= SELUID;
+		if (Selflags == SELUID)
+		    return(0);
 	    }
 	    if (Selflags == SELUID && (*sf & SELUID) == 0)
 		return(1);
@@ -902,6 +1205,11 @@ is_proc_excl(pid, pgid, uid, pss, sf)
 void
 link_lfile()
 {
+
+#if	defined(HASEPTOPTS)
+	short ept = 0;			/* the file's EPT_* types */
+#endif	/* defined(HASEPTOPTS) */
+
 	if (Lf->sf & SELEXCLF)
 	    return;
 
@@ -914,7 +1222,7 @@ link_lfile()
  */
 	if (FeptE) {
 	    if (Lf->sf & SELPINFO) {
-		Lp->ept |= EPT_PIPE;
+		ept |= EPT_PIPE;
 		Lf->sf &= ~SELPINFO;
 	    }
 
@@ -924,7 +1232,7 @@ link_lfile()
  * process_psxmqinfo() set selection flags.
  */
 	    if (Lf->sf & SELPSXMQINFO) {
-		Lp->ept |= EPT_PSXMQ;
+		ept |= EPT_PSXMQ;
 		Lf->sf &= ~SELPSXMQINFO;
 	    }
 
@@ -935,7 +1243,7 @@ link_lfile()
  * set selection flags.
  */
 	    if (Lf->sf & SELUXSINFO) {
-		Lp->ept |= EPT_UXS;
+		ept |= EPT_UXS;
 		Lf->sf &= ~SELUXSINFO;
 	    }
 # endif	/* defined(HASUXSOCKEPT) */
@@ -947,7 +1255,7 @@ link_lfile()
  * set selection flags.
  */
 	    if (Lf->sf & SELPTYINFO) {
-		Lp->ept |= EPT_PTY;
+		ept |= EPT_PTY;
 		Lf->sf &= ~SELPTYINFO;
 	    }
 # endif	/* defined(HASPTYEPT) */
@@ -958,7 +1266,7 @@ link_lfile()
  * process_netsinfo() set selection flags.
  */
 	    if (Lf->sf & SELNETSINFO) {
-		Lp->ept |= EPT_NETS;
+		ept |= EPT_NETS;
 		Lf->sf &= ~SELNETSINFO;
 	    }
 
@@ -969,7 +1277,7 @@ link_lfile()
  * process_nets6info() set selection flags.
  */
 	    if (Lf->sf & SELNETS6INFO) {
-		Lp->ept |= EPT_NETS6;
+		ept |= EPT_NETS6;
 		Lf->sf &= ~SELNETS6INFO;
 	    }
 # endif	/* defined(HASIPv6) */
@@ -979,9 +1287,18 @@ link_lfile()
  * set selection flags.
  */
 	    if (Lf->sf & SELEVTFDINFO) {
-		Lp->ept |= EPT_EVTFD;
+		ept |= EPT_EVTFD;
 		Lf->sf &= ~SELEVTFDINFO;
 	    }
+
+/*
+ * Note the file's endpoint types in its process and enter the file in the
+ * endpoint file list, so that process_epts() visits it.
+ */
+	    if (ept) {
+		Lp->ept |= ept;
+		(void) enter_eptfile(ept);
+	    }
 	}
 #endif	/* defined(HASEPTOPTS) */
 
@@ -1002,10 +1319,123 @@ link_lfile()
 }
 
 
+#if	defined(HASLPARENA)
+/*
+ * mkstrlpa() - make a copy of a string in the arena of the current process
+ */
+
+char *
+mkstrlpa(src)
+	char *src;			/* source */
+{
+	char *cp;
+	MALLOC_S len;
+
+	len = (MALLOC_S)(src ? strlen(src) : 0);
+	cp = alloc_lpa(len + 1);
+	if (len)
+	    (void) strncpy(cp, src, len);
+	cp[len] = '\0';
+	return(cp);
+}
+#endif	/* defined(HASLPARENA) */
+
+
 #if	defined(HASEPTOPTS)
 /*
- * process_pinfo() -- process pipe info, adding it to selected files and
- *		      selecting pipe end files (if requested)
+ * process_epts() -- process the endpoint files, adding endpoint information
+ *		     to selected files and selecting end point files
+ *
+ * Only the files link_lfile() entered in the endpoint file list are visited.
+ * The first pass adds endpoint information to the selected files and marks
+ * their unselected end point files; the second selects the marked files.
+ *
+ * Lf and Lp are left changed.
+ */
+
+void
+process_epts()
+{
+	eptfile_t *ef;			/* endpoint file */
+	int i;				/* temporary index */
+
+	if (!FeptE)
+	    return;
+	for (i = 0, ef = Eptf; i < Eptfn; i++, ef++) {
+	    Lp = &Lproc[ef->lpx];
+	    Lf = ef->lf;
+	/*
+	 * Pipe, UNIX socket and pseudoterminal files are processed only for
+	 * processes that have been selected for printing.
+	 */
+	    if ((ef->ept & EPT_PIPE) && Lp->pss)
+		(void) process_pinfo(0);
+	    if (ef->ept & EPT_PSXMQ)
+		(void) process_psxmqinfo(0);
+
+# if	defined(HASUXSOCKEPT)
+	    if ((ef->ept & EPT_UXS) && Lp->pss)
+		(void) process_uxsinfo(0);
+# endif	/* defined(HASUXSOCKEPT) */
+
+# if	defined(HASPTYEPT)
+	    if ((ef->ept & EPT_PTY) && Lp->pss)
+		(void) process_ptyinfo(0);
+# endif	/* defined(HASPTYEPT) */
+
+	    if (ef->ept & EPT_NETS)
+		(void) process_netsinfo(0);
+
+# if	defined(HASIPv6)
+	    if (ef->ept & EPT_NETS6)
+		(void) process_nets6info(0);
+# endif	/* defined(HASIPv6) */
+
+	    if (ef->ept & EPT_EVTFD)
+		(void) process_evtfdinfo(0);
+	}
+/*
+ * In a second pass, select the end point files the first pass marked.
+ */
+	for (i = 0, ef = Eptf; i < Eptfn; i++, ef++) {
+	    if (!ef->lf->chend)
+		continue;
+	    Lp = &Lproc[ef->lpx];
+	    Lf = ef->lf;
+	    if (ef->ept & EPT_PIPE)
+		(void) process_pinfo(1);
+	    if (ef->ept & EPT_PSXMQ)
+		(void) process_psxmqinfo(1);
+
+# if	defined(HASUXSOCKEPT)
+	    if (ef->ept & EPT_UXS)
+		(void) process_uxsinfo(1);
+# endif	/* defined(HASUXSOCKEPT) */
+
+# if	defined(HASPTYEPT)
+	    if (ef->ept & EPT_PTY)
+		(void) process_ptyinfo(1);
+# endif	/* defined(HASPTYEPT) */
+
+	    if (ef->ept & EPT_NETS)
+		(void) process_netsinfo(1);
+
+# if	defined(HASIPv6)
+	    if (ef->ept & EPT_NETS6)
+		(void) process_nets6info(1);
+# endif	/* defined(HASIPv6) */
+
+	    if (ef->ept & EPT_EVTFD)
+		(void) process_evtfdinfo(1);
+	}
+	Eptfn = 0;
+}
+
+
+/*
+ * process_pinfo() -- process the pipe info of the file at Lf, adding it to
+ *		      the file if selected, or selecting the file if it's
+ *		      a pipe end (if requested)
  */
 
 void
@@ -1019,54 +1449,52 @@ process_pinfo(f)
 	
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if ((Lf->ntype != N_FIFO) || (Lf->inp_ty != 1))
-		continue;
-	    pp = (pxinfo_t *)NULL;
-	    switch(f) {
-	    case 0:
+	if ((Lf->ntype != N_FIFO) || (Lf->inp_ty != 1))
+	    return;
+	pp = (pxinfo_t *)NULL;
+	switch(f) {
+	case 0:
+
+	/*
+	 * Process already selected pipe file.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 
 	    /*
-	     * Process already selected pipe file.
+	     * This file has been selected by some criterion other than
+	     * its being a pipe.  Look up the pipe's endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
+		do {
+		    if ((pp = find_pepti(Lp->pid, Lf, pp))) {
+
+		    /*
+		     * This pipe endpoint is linked to the selected pipe
+		     * file.  Add its PID and FD to the name column
+		     * addition.
+		     */
+			prt_pinfo(pp, (FeptE == 2));
+			pp = pp->next;
+		    }
+		} while (pp);
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_PIPE)) {
 
-		/*
-		 * This file has been selected by some criterion other than
-		 * its being a pipe.  Look up the pipe's endpoints.
-		 */
-		    do {
-			if ((pp = find_pepti(Lp->pid, Lf, pp))) {
-
-			/*
-			 * This pipe endpoint is linked to the selected pipe
-			 * file.  Add its PID and FD to the name column
-			 * addition.
-			 */
-			    prt_pinfo(pp, (FeptE == 2));
-			    pp = pp->next;
-			}
-		    } while (pp);
-		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_PIPE)) {
-
-		/*
-		 * This is an unselected end point file.  Select it and add
-		 * its end point information to its name column addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    do {
-			if ((pp = find_pepti(Lp->pid, Lf, pp))) {
-			    prt_pinfo(pp, 0);
-			    pp = pp->next;
-			}
-		    } while (pp);
-		}
-		break;
+	    /*
+	     * This is an unselected end point file.  Select it and add
+	     * its end point information to its name column addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		do {
+		    if ((pp = find_pepti(Lp->pid, Lf, pp))) {
+			prt_pinfo(pp, 0);
+			pp = pp->next;
+		    }
+		} while (pp);
 	    }
+	    break;
 	}
 }
 
@@ -1109,8 +1537,9 @@ prt_pinfo(pp, ps)
 
 
 /*
- * process_psxmqinfo() -- posix mq info, adding it to selected files and
- *		          selecting posix mq end files (if requested)
+ * process_psxmqinfo() -- process the posix mq info of the file at Lf, adding
+ *			  it to the file if selected, or selecting the file
+ *			  if it's a posix mq end (if requested)
  */
 
 void
@@ -1124,54 +1553,52 @@ process_psxmqinfo(f)
 
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if (Lf->dev != MqueueDev)
-		continue;
-	    pp = (pxinfo_t *)NULL;
-	    switch(f) {
-	    case 0:
+	if (Lf->dev != MqueueDev)
+	    return;
+	pp = (pxinfo_t *)NULL;
+	switch(f) {
+	case 0:
+
+	/*
+	 * Process already selected posix mq file.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 
 	    /*
-	     * Process already selected posix mq file.
+	     * This file has been selected by some criterion other than
+	     * its being a posix mq.  Look up the posix mq's endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
+		do {
+		    if ((pp = find_psxmqinfo(Lp->pid, Lf, pp))) {
+
+		    /*
+		     * This posix mq endpoint is linked to the selected posix mq
+		     * file.  Add its PID and FD to the name column
+		     * addition.
+		     */
+			prt_psxmqinfo(pp, (FeptE == 2));
+			pp = pp->next;
+		    }
+		} while (pp);
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_PSXMQ)) {
 
-		/*
-		 * This file has been selected by some criterion other than
-		 * its being a posix mq.  Look up the posix mq's endpoints.
-		 */
-		    do {
-			if ((pp = find_psxmqinfo(Lp->pid, Lf, pp))) {
-
-			/*
-			 * This posix mq endpoint is linked to the selected posix mq
-			 * file.  Add its PID and FD to the name column
-			 * addition.
-			 */
-			    prt_psxmqinfo(pp, (FeptE == 2));
-			    pp = pp->next;
-			}
-		    } while (pp);
-		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_PSXMQ)) {
-
-		/*
-		 * This is an unselected end point file.  Select it and add
-		 * its end point information to its name column addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    do {
-		      if ((pp = find_psxmqinfo(Lp->pid, Lf, pp))) {
-			    prt_psxmqinfo(pp, 0);
-			    pp = pp->next;
-			}
-		    } while (pp);
-		}
-		break;
+	    /*
+	     * This is an unselected end point file.  Select it and add
+	     * its end point information to its name column addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		do {
+		  if ((pp = find_psxmqinfo(Lp->pid, Lf, pp))) {
+			prt_psxmqinfo(pp, 0);
+			pp = pp->next;
+		    }
+		} while (pp);
 	    }
+	    break;
 	}
 }
 
@@ -1215,8 +1642,9 @@ prt_psxmqinfo(pp, ps)
 
 
 /*
- * process_evtfdinfo() -- process eventfd info, adding it to selected files and
- *		          selecting envetfd end files (if requested)
+ * process_evtfdinfo() -- process the eventfd info of the file at Lf, adding
+ *			  it to the file if selected, or selecting the file
+ *			  if it's an eventfd end (if requested)
  */
 
 void
@@ -1230,54 +1658,52 @@ process_evtfdinfo(f)
 
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if ((Lf->ntype != N_ANON_INODE) || (Lf->eventfd_id == -1))
-		continue;
-	    pp = (pxinfo_t *)NULL;
-	    switch(f) {
-	    case 0:
+	if ((Lf->ntype != N_ANON_INODE) || (LFCOLD(Lf)->eventfd_id == -1))
+	    return;
+	pp = (pxinfo_t *)NULL;
+	switch(f) {
+	case 0:
+
+	/*
+	 * Process already selected eventfd_id file.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 
 	    /*
-	     * Process already selected eventfd_id file.
+	     * This file has been selected by some criterion other than
+	     * its being a eventfd.  Look up the eventfd's endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
+		do {
+		    if ((pp = find_evtfdinfo(Lp->pid, Lf, pp))) {
+
+		    /*
+		     * This eventfd endpoint is linked to the selected eventfd
+		     * file.  Add its PID and FD to the name column
+		     * addition.
+		     */
+			prt_evtfdinfo(pp, (FeptE == 2));
+			pp = pp->next;
+		    }
+		} while (pp);
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_EVTFD)) {
 
-		/*
-		 * This file has been selected by some criterion other than
-		 * its being a eventfd.  Look up the eventfd's endpoints.
-		 */
-		    do {
-			if ((pp = find_evtfdinfo(Lp->pid, Lf, pp))) {
-
-			/*
-			 * This eventfd endpoint is linked to the selected eventfd
-			 * file.  Add its PID and FD to the name column
-			 * addition.
-			 */
-			    prt_evtfdinfo(pp, (FeptE == 2));
-			    pp = pp->next;
-			}
-		    } while (pp);
-		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_EVTFD)) {
-
-		/*
-		 * This is an unselected end point file.  Select it and add
-		 * its end point information to its name column addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    do {
-			if ((pp = find_evtfdinfo(Lp->pid, Lf, pp))) {
-			    prt_evtfdinfo(pp, 0);
-			    pp = pp->next;
-			}
-		    } while (pp);
-		}
-		break;
+	    /*
+	     * This is an unselected end point file.  Select it and add
+	     * its end point information to its name column addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		do {
+		    if ((pp = find_evtfdinfo(Lp->pid, Lf, pp))) {
+			prt_evtfdinfo(pp, 0);
+			pp = pp->next;
+		    }
+		} while (pp);
 	    }
+	    break;
 	}
 }
 
@@ -1435,7 +1861,7 @@ print_proc()
  */
 	if (Ffield) {
 	    for (Lf = Lp->file; Lf; Lf = Lf->next) {
-		if (is_file_sel(Lp, Lf))
+		if (is_file_sel(Lp, Lf) && (!RptDelta || Lf->delta))
 		    break;
 	    }
 	    if (!Lf)
@@ -1489,6 +1915,8 @@ print_proc()
 	for (Lf = Lp->file; Lf; Lf = Lf->next) {
 	    if (!is_file_sel(Lp, Lf))
 		continue;
+	    if (RptDelta && !Lf->delta)
+		continue;		/* unchanged since the last cycle */
 	    rv = 1;
 	/*
 	 * If no field output selected, print dialect-specific formatted
@@ -1511,6 +1939,10 @@ print_proc()
 		(void) printf("%c%s%c", LSOF_FID_FD, cp, Terminator);
 		lc++;
 	    }
+	    if (FieldSel[LSOF_FIX_DELTA].st && RptDelta) {
+		(void) printf("%c%c%c", LSOF_FID_DELTA, Lf->delta, Terminator);
+		lc++;
+	    }
 	/*
 	 * Print selected fields.
 	 */
@@ -1536,12 +1968,13 @@ print_proc()
 	    if (FieldSel[LSOF_FIX_FA].st && (Fsv & FSV_FA)
 	    &&  (Lf->fsv & FSV_FA)) {
 		(void) printf("%c%s%c", LSOF_FID_FA,
-		    print_kptr(Lf->fsa, (char *)NULL, 0), Terminator);
+		    print_kptr(LFCOLD(Lf)->fsa, (char *)NULL, 0), Terminator);
 		lc++;
 	    }
 	    if (FieldSel[LSOF_FIX_CT].st && (Fsv & FSV_CT)
 	    &&  (Lf->fsv & FSV_CT)) {
-		(void) printf("%c%ld%c", LSOF_FID_CT, Lf->fct, Terminator);
+		(void) printf("%c%ld%c", LSOF_FID_CT, LFCOLD(Lf)->fct,
+		    Terminator);
 		lc++;
 	    }
 	    if (FieldSel[LSOF_FIX_FG].st && (Fsv & FSV_FG)
@@ -1553,7 +1986,7 @@ print_proc()
 	    if (FieldSel[LSOF_FIX_NI].st && (Fsv & FSV_NI)
 	    &&  (Lf->fsv & FSV_NI)) {
 		(void) printf("%c%s%c", LSOF_FID_NI,
-		    print_kptr(Lf->fna, (char *)NULL, 0), Terminator);
+		    print_kptr(LFCOLD(Lf)->fna, (char *)NULL, 0), Terminator);
 		lc++;
 	    }
 #endif	/* defined(HASFSTRUCT) */
@@ -1655,7 +2088,7 @@ print_proc()
 		putchar(Terminator);
 		lc++;
 	    }
-	    if (Lf->lts.type >= 0 && FieldSel[LSOF_FIX_TCPTPI].st) {
+	    if (LFCOLD(Lf)->lts.type >= 0 && FieldSel[LSOF_FIX_TCPTPI].st) {
 		print_tcptpi(0);
 		lc++;
 	    }
@@ -1668,8 +2101,9 @@ print_proc()
 
 #if	defined(HASPTYEPT)
 /*
- * process_ptyinfo() -- process pseudoterminal info, adding it to selected files and
- *		      selecting pseudoterminal end files (if requested)
+ * process_ptyinfo() -- process the pseudoterminal info of the file at Lf,
+ *			adding it to the file if selected, or selecting the
+ *			file if it's a pseudoterminal end (if requested)
  */
 
 void
@@ -1685,64 +2119,62 @@ process_ptyinfo(f)
 
 	if (!FeptE)
 	    return;
-	for (Lf = Lp->file; Lf; Lf = Lf->next) {
-	    if (Lf->rdev_def && is_pty_ptmx(Lf->rdev))
-		mos = 1;
-	    else if (Lf->rdev_def && is_pty_slave(GET_MAJ_DEV(Lf->rdev)))
-		mos = 0;
-	    else
-		continue;
+	if (Lf->rdev_def && is_pty_ptmx(Lf->rdev))
+	    mos = 1;
+	else if (Lf->rdev_def && is_pty_slave(GET_MAJ_DEV(Lf->rdev)))
+	    mos = 0;
+	else
+	    return;
+
+	pp = (pxinfo_t *)NULL;
+	switch(f) {
+	case 0:
 
-	    pp = (pxinfo_t *)NULL;
-	    switch(f) {
-	    case 0:
+	/*
+	 * Process already selected pseudoterminal file.
+	 */
+	    if (is_file_sel(Lp, Lf)) {
 
 	    /*
-	     * Process already selected pseudoterminal file.
+	     * This file has been selected by some criterion other than
+	     * its being a pseudoterminal.  Look up the pseudoterminal's
+	     * endpoints.
 	     */
-		if (is_file_sel(Lp, Lf)) {
+		pc = 1;
+		do {
+		    if ((pp = find_ptyepti(Lp->pid, Lf, !mos, pp))) {
+
+		    /*
+		     * This pseudoterminal endpoint is linked to the
+		     * selected pseudoterminal file.  Add its PID, FD and
+		     * access mode to the name column addition.
+		     */
+			prt_ptyinfo(pp, (mos && pc), (FeptE == 2));
+			pp = pp->next;
+			pc = 0;
+		    }
+		} while (pp);
+	    }
+	    break;
+	case 1:
+	    if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_PTY)) {
 
-		/*
-		 * This file has been selected by some criterion other than
-		 * its being a pseudoterminal.  Look up the pseudoterminal's
-		 * endpoints.
-		 */
-		    pc = 1;
-		    do {
-			if ((pp = find_ptyepti(Lp->pid, Lf, !mos, pp))) {
-
-			/*
-			 * This pseudoterminal endpoint is linked to the
-			 * selected pseudoterminal file.  Add its PID, FD and
-			 * access mode to the name column addition.
-			 */
-			    prt_ptyinfo(pp, (mos && pc), (FeptE == 2));
-			    pp = pp->next;
-			    pc = 0;
-			}
-		    } while (pp);
-		}
-		break;
-	    case 1:
-		if (!is_file_sel(Lp, Lf) && (Lf->chend & CHEND_PTY)) {
-
-		/*
-		 * This is an unselected end point file.  Select it and add
-		 * its end point information to its name column addition.
-		 */
-		    Lf->sf = Selflags;
-		    Lp->pss |= PS_SEC;
-		    pc = 1;
-		    do {
-			if ((pp = find_ptyepti(Lp->pid, Lf, !mos, pp))) {
-			    prt_ptyinfo(pp, (mos && pc), 0);
-			    pp = pp->next;
-			    pc = 0;
-			}
-		    } while (pp);
-		}
-		break;
+	    /*
+	     * This is an unselected end point file.  Select it and add
+	     * its end point information to its name column addition.
+	     */
+		Lf->sf = Selflags;
+		Lp->pss |= PS_SEC;
+		pc = 1;
+		do {
+		    if ((pp = find_ptyepti(Lp->pid, Lf, !mos, pp))) {
+			prt_ptyinfo(pp, (mos && pc), 0);
+			pp = pp->next;
+			pc = 0;
+		    }
+		} while (pp);
 	    }
+	    break;
 	}
 }
 
@@ -1772,7 +2204,7 @@ prt_ptyinfo(pp, prt_edev, ps)
 	}
 	if (prt_edev) {
 	    (void) snpf(nma, sizeof(nma) - 1, "->/dev/pts/%d %d,%.*s,%s%c",
-			Lf->tty_index,
+			LFCOLD(Lf)->tty_index,
 			ep->pid, CmdLim, ep->cmd, &ef->fd[i],
 			ef->access);
 	} else {
@@ -1792,3 +2224,22 @@ prt_ptyinfo(pp, prt_edev, ps)
 	}
 }
 #endif	/* defined(HASPTYEPT) */
+
+
+#if	defined(HASLPARENA)
+/*
+ * report_lpa() - report arena statistics, if LPASTATSENV requests them
+ */
+
+void
+report_lpa()
+{
+	if (!getenv(LPASTATSENV))
+	    return;
+	(void) fprintf(stderr,
+	    "%s: arenas: %lu allocations (%lu bytes) from %lu chunks",
+	    Pn, Lpast.na, Lpast.nab, Lpast.nc);
+	(void) fprintf(stderr, " (%lu bytes); %lu chunks freed\n",
+	    Lpast.ncb, Lpast.nf);
+}
+#endif	/* defined(HASLPARENA) */
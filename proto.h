@@ -68,8 +68,18 @@
 
 
 _PROTOTYPE(extern void add_nma,(char *cp, int len));
+
+# if	defined(HASLFILECOLD)
+_PROTOTYPE(extern struct lfcold *alloc_lfcold,(struct lfile *lf));
+# endif	/* defined(HASLFILECOLD) */
+
 _PROTOTYPE(extern void alloc_lfile,(char *nm, int num));
 _PROTOTYPE(extern void alloc_lproc,(int pid, int pgid, int ppid, UID_ARG uid, char *cmd, int pss, int sf));
+
+# if	defined(HASLPARENA)
+_PROTOTYPE(extern char *alloc_lpa,(MALLOC_S len));
+# endif	/* defined(HASLPARENA) */
+
 _PROTOTYPE(extern void build_IPstates,(void));
 _PROTOTYPE(extern void childx,(void));
 _PROTOTYPE(extern int ck_fd_status,(char *nm, int num));
@@ -88,6 +98,15 @@ _PROTOTYPE(extern int enter_cmd_rx,(char *x));
 _PROTOTYPE(extern void enter_dev_ch,(char *m));
 _PROTOTYPE(extern int enter_dir,(char *d, int descend));
 
+# if	defined(HASDIRPFX)
+_PROTOTYPE(extern int enter_dir_pfx,(char *d));
+# endif	/* defined(HASDIRPFX) */
+
+# if	defined(HASMNTDEVIX)
+_PROTOTYPE(extern struct mounts *find_mntdev,(dev_t dev, char *p));
+# endif	/* defined(HASMNTDEVIX) */
+
+
 # if	defined(HASEOPT)
 _PROTOTYPE(extern int enter_efsys,(char *e, int rdlnk));
 # endif	/* defined(HASEOPT) */
@@ -109,10 +128,12 @@ _PROTOTYPE(extern void ent_inaddr,(unsigned char *la, int lp, unsigned char *fa,
 _PROTOTYPE(extern int examine_lproc,(void));
 _PROTOTYPE(extern void Exit,(int xv)) exiting;
 _PROTOTYPE(extern void find_ch_ino,(void));
+_PROTOTYPE(extern int find_selidx,(struct selidx *h, unsigned long id));
 
 # if	defined(HASEPTOPTS)
 _PROTOTYPE(extern void clear_pinfo,(void));
 _PROTOTYPE(extern pxinfo_t *find_pepti,(int pid, struct lfile *lf, pxinfo_t *pp));
+_PROTOTYPE(extern void process_epts,(void));
 _PROTOTYPE(extern void process_pinfo,(int f));
 _PROTOTYPE(extern void clear_psxmqinfo,(void));
 _PROTOTYPE(extern pxinfo_t *find_psxmqinfo,(int pid, struct lfile *lf, pxinfo_t *pp));
@@ -146,6 +167,10 @@ _PROTOTYPE(extern void free_lproc,(struct lproc *lp));
 _PROTOTYPE(extern void gather_proc_info,(void));
 _PROTOTYPE(extern char *gethostnm,(unsigned char *ia, int af));
 
+# if	defined(HASPARHOSTRSLV)
+_PROTOTYPE(extern void lkup_hostnms,(void));
+# endif	/* defined(HASPARHOSTRSLV) */
+
 # if	!defined(GET_MAX_FD)
 /*
  * This is not strictly a prototype, but GET_MAX_FD is the name of the
@@ -160,6 +185,7 @@ _PROTOTYPE(extern char *gethostnm,(unsigned char *ia, int af));
 
 _PROTOTYPE(extern int hashbyname,(char *nm, int mod));
 _PROTOTYPE(extern void hashSfile,(void));
+_PROTOTYPE(extern void index_nwad,(void));
 _PROTOTYPE(extern void initialize,(void));
 _PROTOTYPE(extern int is_cmd_excl,(char *cmd, short *pss, short *sf));
 _PROTOTYPE(extern int is_file_sel,(struct lproc *lp, struct lfile *lf));
@@ -178,6 +204,11 @@ _PROTOTYPE(extern struct l_dev *lkupdev,(dev_t *dev,dev_t *rdev,int i,int r));
 _PROTOTYPE(extern int main,(int argc, char *argv[]));
 _PROTOTYPE(extern int lstatsafely,(char *path, struct stat *buf));
 _PROTOTYPE(extern char *mkstrcpy,(char *src, MALLOC_S *rlp));
+
+# if	defined(HASLPARENA)
+_PROTOTYPE(extern char *mkstrlpa,(char *src));
+# endif	/* defined(HASLPARENA) */
+
 _PROTOTYPE(extern char *mkstrcat,(char *s1, int l1, char *s2, int l2, char *s3, int l3, MALLOC_S *clp));
 _PROTOTYPE(extern int printdevname,(dev_t *dev, dev_t *rdev, int f, int nty));
 _PROTOTYPE(extern void print_file,(void));
@@ -200,6 +231,15 @@ _PROTOTYPE(extern char *safepup,(unsigned int c, int *cl));
 _PROTOTYPE(extern int safestrlen,(char *sp, int flags));
 _PROTOTYPE(extern void safestrprtn,(char *sp, int len, FILE *fs, int flags));
 _PROTOTYPE(extern void safestrprt,(char *sp, FILE *fs, int flags));
+
+# if	defined(HASLPARENA)
+_PROTOTYPE(extern void report_lpa,(void));
+# endif	/* defined(HASLPARENA) */
+
+# if	defined(HASRPTINCR)
+_PROTOTYPE(extern void save_lproc,(struct lproc *lp));
+# endif	/* defined(HASRPTINCR) */
+
 _PROTOTYPE(extern int statsafely,(char *path, struct stat *buf));
 _PROTOTYPE(extern void stkdir,(char *p));
 _PROTOTYPE(extern void usage,(int xv, int fh, int version));
@@ -69,6 +69,16 @@ int Cmdnx = 0;			/* command name exclusions selected with -c */
 lsof_rx_t *CmdRx = (lsof_rx_t *)NULL;
 				/* command regular expression table */
 
+#if	defined(HASCGROUP)
+cgrplist_t *CgrpArg = (cgrplist_t *)NULL;
+				/* cgroup arguments supplied with -G and +G */
+#endif	/* defined(HASCGROUP) */
+
+#if	defined(HASDIRPFX)
+struct dirpfx *Dirpfx = (struct dirpfx *)NULL;
+				/* directory path prefixes supplied with +B */
+#endif	/* defined(HASDIRPFX) */
+
 #if	defined(HASSELINUX)
 cntxlist_t *CntxArg = (cntxlist_t *)NULL;
 				/* security context arguments supplied with
@@ -236,9 +246,13 @@ struct fieldsel FieldSel[] = {
     { LSOF_FID_ZONE,   0,  LSOF_FNM_ZONE,   &Fzone,   1		 }, /* 28 */
     { LSOF_FID_CNTX,   0,  LSOF_FNM_CNTX,   &Fcntx,   1		 }, /* 29 */
     { LSOF_FID_TERM,   0,  LSOF_FNM_TERM,   NULL,     0		 }, /* 30 */
+    { LSOF_FID_DELTA,  0,  LSOF_FNM_DELTA,  NULL,     0		 }, /* 31 */
     { ' ',	       0,  NULL,	    NULL,     0		 }
 };
 
+struct selidx HbySpgid;		/* Spgid[] index */
+struct selidx HbySpid;		/* Spid[] index */
+struct selidx HbySuid;		/* Suid[] index */
 int Hdr = 0;			/* header print status */
 int IgnTasks = 0;		/* ignore tasks when non-zero */
 char *InodeFmt_d = (char *) NULL;
@@ -247,6 +261,13 @@ char *InodeFmt_x = (char *) NULL;
 				/* INODETYPE hexadecimal printf specification */
 int LastPid = -1;		/* last PID listed (for eliminating duplicates
 				 * in terse output) */
+
+#if	defined(HASLFILECOLD)
+struct lfcold Lfcold0;		/* shared default cold local file
+				 * information -- never written after
+				 * alloc_lfile() initializes it */
+#endif	/* defined(HASLFILECOLD) */
+
 struct lfile *Lf = (struct lfile *)NULL;
 				/* current local file structure */
 struct lproc *Lp = (struct lproc *)NULL;
@@ -322,7 +343,17 @@ int Procsrch = 0;		/* 1 if searching for any proc file system
 
 int PrPass = 0;			/* print pass: 0 = compute column widths
 				 *	       1 = print */
-int RptTm = 0;			/* repeat time -- set by -r */
+int RptDelta = 0;		/* repeat delta mode: list only files
+				 * added, removed or changed since the
+				 * previous cycle -- set by -r's `d' */
+
+#if	defined(HASPROCEVT)
+int RptPev = 0;			/* repeat mode finds changed processes from
+				 * kernel process events -- set by -r's `p' */
+#endif	/* defined(HASPROCEVT) */
+
+int RptTm = 0;			/* repeat time in milliseconds -- set by
+				 * -r */
 int RptMaxCount = 0;		/* count of repeasts: 0 = no limit
 				 * -- set by -r */
 struct l_dev **Sdev = (struct l_dev **)NULL;
@@ -0,0 +1,66 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+
+# The threaded +d/+D directory walk must find the same files as the serial
+# one, which LSOFDIRWALKTHREADS=1 selects.
+
+top=/tmp/${name}-$$
+out=/tmp/${name}-$$-out
+mkdir -p $top $out/sub
+for i in 1 2 3 4 5 6 7 8; do
+    for j in 1 2 3 4 5 6; do
+	mkdir -p $top/d$i/e$j/f
+	for k in 1 2 3 4 5 6 7 8 9 10; do
+	    : > $top/d$i/e$j/f$k
+	done
+	: > $top/d$i/e$j/f/g
+    done
+done
+: > $out/sub/h
+ln -s $out/sub $top/d1/link
+
+# A process with files open at every depth, inside and outside the tree,
+# and one reached only through the symbolic link.
+(
+    cd $top/d3/e2/f
+    exec 3< $top/d1/e1/f1 4< $top/d8/e6/f/g 5< $top/d5/e3/f10 6< $out/sub/h
+    exec 7< $top/d2/e4/f7 8< $top/d7/e5/f/g 9< $top/d4/e1/f3
+    exec sleep 30
+) &
+pid=$!
+
+cleanup()
+{
+    kill $pid 2> /dev/null
+    rm -rf $top $out
+}
+
+sleep 0.3
+for x in "+D $top" "+d $top/d5/e3" "-x l +D $top" "+D $top/d8"; do
+    serial=$(LSOFDIRWALKTHREADS=1 $lsof -w -a -p $pid $x -F fn)
+    threaded=$(LSOFDIRWALKTHREADS=8 $lsof -w -a -p $pid $x -F fn)
+    echo "$x:" >> $report
+    echo "$threaded" >> $report
+    if [ -z "$serial" ] || [ "$serial" != "$threaded" ]; then
+	echo "the serial walk found:" >> $report
+	echo "$serial" >> $report
+	cleanup
+	exit 1
+    fi
+done
+
+# Only -x follows the symbolic link.
+if ! $lsof -w -a -p $pid -x l +D $top -F n | grep -q "^n$top/d1/link/h\$"; then
+    echo "the file behind the symbolic link wasn't found" >> $report
+    cleanup
+    exit 1
+fi
+if $lsof -w -a -p $pid +D $top -F n | grep -q "/h\$"; then
+    echo "the symbolic link was followed without -x" >> $report
+    cleanup
+    exit 1
+fi
+
+cleanup
+exit 0
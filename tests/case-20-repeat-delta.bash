@@ -0,0 +1,49 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+
+f=/tmp/${name}-$$
+: > $f
+
+# Open descriptor 6, later open descriptor 7, later close descriptor 6.
+(
+    exec 6<$f
+    sleep 0.8
+    exec 7<$f
+    sleep 0.8
+    exec 6<&-
+    sleep 3
+) &
+pid=$!
+
+sleep 0.2
+out=$($lsof -r 0.3c10d -p $pid -a -d 6,7 -F fe)
+kill $pid 2> /dev/null
+rm -f $f
+echo "$out" >> $report
+
+# Number each listing and join each descriptor to its change character.
+ch=$(echo "$out" | awk '/^m$/ { n++; next } /^f/ { fd = substr($0, 2) }
+			 /^e/ { print n + 0, fd, substr($0, 2) }')
+echo "$ch" >> $report
+
+if ! echo "$ch" | grep -q '^0 6 +$'; then
+    echo "descriptor 6 wasn't added in the first listing" >> $report
+    exit 1
+fi
+if [ $(echo "$ch" | grep -c ' 6 +$') != 1 ]; then
+    echo "descriptor 6 was added more than once" >> $report
+    exit 1
+fi
+for e in '7 +' '6 -'; do
+    if [ $(echo "$ch" | grep -c "^[1-9][0-9]* $e\$") != 1 ]; then
+	echo "descriptor change \"$e\" wasn't reported once" >> $report
+	exit 1
+    fi
+done
+if [ $(echo "$ch" | wc -l) != 3 ]; then
+    echo "unexpected descriptor changes reported" >> $report
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,20 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+base=$(pwd)
+
+start=$(date +%s%N)
+n=$(${lsof} -r 0.2c5 -p $$ | tee -a $report | grep -e '=======' | wc -l)
+elapsed=$(( ($(date +%s%N) - start) / 1000000 ))
+echo "markers: $n elapsed: ${elapsed}ms" >> $report
+
+if [ $n != 5 ]; then
+    exit 1
+fi
+
+# Five 200ms cycles; whole-second rounding would take at least 5s.
+if [ $elapsed -ge 3000 ]; then
+    exit 1
+fi
+
+exit 0
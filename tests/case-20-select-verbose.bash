@@ -0,0 +1,55 @@
+name=$(basename $0 .bash)
+lsof=$1
+report=$2
+
+# -V must report exactly the PID, PGID and UID selections that matched no
+# process, however long the lists are.
+
+sleep 30 &
+other=$!
+cleanup()
+{
+    kill $other 2> /dev/null
+}
+
+absent=
+n=0
+p=4000000
+while [ $n -lt 3000 ]; do
+    p=$((p + 1))
+    if ! kill -0 $p 2> /dev/null; then
+	absent="$absent${absent:+,}$p"
+	n=$((n + 1))
+    fi
+done
+
+out=$($lsof -V -p $$,$absent,$$,^$other 2> /dev/null | grep "^lsof: ")
+n=$(echo "$out" | grep -c '^lsof: process ID not located: ')
+if [ $n -ne 3000 ]; then
+    echo "$n of 3000 absent PIDs reported as not located" >> $report
+    cleanup
+    exit 1
+fi
+if echo "$out" | grep -q "process ID not located: \($$\|$other\)\$"; then
+    echo "a located or excluded PID was reported as not located" >> $report
+    echo "$out" | grep -v "not located: 40" >> $report
+    cleanup
+    exit 1
+fi
+
+pgid=$(ps -o pgid= -p $$ | tr -d ' ')
+out=$($lsof -V -g $pgid,${absent%%,*} -u $(id -u),3999999 -a 2> /dev/null | grep "^lsof: ")
+echo "$out" >> $report
+cleanup
+if ! echo "$out" | grep -q "^lsof: process group ID not located: ${absent%%,*}\$" ||
+   echo "$out" | grep -q "process group ID not located: $pgid\$"; then
+    echo "wrong PGID selection report" >> $report
+    exit 1
+fi
+if ! echo "$out" | grep -q '^lsof: user ID not located: 3999999$' ||
+   echo "$out" | grep -q "user ID not located: $(id -u)\$"; then
+    echo "wrong UID selection report" >> $report
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1 @@
+cc
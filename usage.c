@@ -385,6 +385,10 @@ usage(xv, fh, version)
 	    (void) fprintf(stderr, " [-A A]");
 #endif	/* defined(HAS_AFS) && defined(HASAOPT) */
 
+#if	defined(HASDIRPFX)
+	    (void) fprintf(stderr, " [+B B]");
+#endif	/* defined(HASDIRPFX) */
+
 	    (void) fprintf(stderr, " [+|-c c] [+|-d s] [+%sD D]%s",
 #if	defined(HASDCACHE)
 		"|-",
@@ -401,7 +405,7 @@ usage(xv, fh, version)
 		);
 
 	    (void) fprintf(stderr,
-		" %s[+|-f%s%s%s%s%s%s]\n [-F [f]] [-g [s]] [-i [i]]",
+		" %s[+|-f%s%s%s%s%s%s]\n [-F [f]] [-g [s]]",
 
 #if	defined(HASEOPT)
 		"[+|-e s] ",
@@ -443,6 +447,12 @@ usage(xv, fh, version)
 
 		);
 
+#if	defined(HASCGROUP)
+	    (void) fprintf(stderr, " [+|-G G]");
+#endif	/* defined(HASCGROUP) */
+
+	    (void) fprintf(stderr, " [-i [i]]");
+
 #if	defined(HASKOPT)
 	    (void) fprintf(stderr, " [-k k]");
 #endif	/* defined(HASKOPT) */
@@ -503,6 +513,11 @@ usage(xv, fh, version)
 	    col = print_in_col(1, "-?|-h list help");
 	    col = print_in_col(col, "-a AND selections (OR)");
 	    col = print_in_col(col, "-b avoid kernel blocks");
+
+#if	defined(HASDIRPFX)
+	    col = print_in_col(col, "+B B  dir B path prefix");
+#endif	/* defined(HASDIRPFX) */
+
 	    col = print_in_col(col,  "-c c  cmd c ^c /c/[bix]");
 	    (void) snpf(buf, sizeof(buf), "+c w  COMMAND width (%d)", CMDL);
 	    col = print_in_col(col, buf);
@@ -537,6 +552,10 @@ usage(xv, fh, version)
 	    col = print_in_col(col, "+|-e s  exempt s *RISKY*");
 #endif	/* defined(HASEOPT) */
 
+#if	defined(HASCGROUP)
+	    col = print_in_col(col, "-G G  cgroup; +G tree");
+#endif	/* defined(HASCGROUP) */
+
 	    (void) snpf(buf, sizeof(buf), "-i select IPv%s files",
 
 #if	defined(HASIPv6)
@@ -810,7 +829,7 @@ usage(xv, fh, version)
 		);
 
 	    (void) fprintf(stderr,
-		"  +|-r [%s] repeat every t seconds (%d); %s",
+		"  +|-r [%s] repeat every t[.ttt] seconds (%d); %s",
 
 #if	defined(HAS_STRFTIME)
 		"t[m<fmt>]",
@@ -829,6 +848,20 @@ usage(xv, fh, version)
 		"for the marker line.\n");
 #endif	/* defined(HAS_STRFTIME) */
 
+	    (void) fprintf(stderr,
+		"       A c<N> suffix stops after N listings; a following\n");
+	    (void) fprintf(stderr,
+		"       d (with -F) lists only files added (e+), removed (e-)\n");
+	    (void) fprintf(stderr,
+		"       or changed (e~).\n");
+
+#if	defined(HASPROCEVT)
+	    (void) fprintf(stderr,
+		"       A following p finds changed processes from kernel\n");
+	    (void) fprintf(stderr,
+		"       process events.\n");
+#endif	/* defined(HASPROCEVT) */
+
 #if	defined(HASTCPUDPSTATE)
 	    (void) fprintf(stderr,
 		"  -s p:s  exclude(^)|select protocol (p = TCP|UDP) states");
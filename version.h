@@ -0,0 +1,12 @@
+#define	LSOF_BLDCMT	""
+#define	LSOF_CC		"cc"
+#define	LSOF_CCV	"12.2.0 (Debian 12.2.0-14+deb12u1) "
+#define	LSOF_CCDATE	"Sun Oct 18 16:51:31 UTC 2026"
+#define	LSOF_CCFLAGS	"-DLINUXV=61153 -DGLIBCV=236 -DHASIPv6 -DNEEDS_NETINET_TCPH -DHASUXSOCKEPT -DHASPTYEPT -DHASSOSTATE -DHASSOOPT -D_FILE_OFFSET_BITS=64 -D_LARGEFILE64_SOURCE -DHAS_STRFTIME -DLSOF_VSTR=\"6.1.153\" -I/usr/include/tirpc -O"
+#define	LSOF_CINFO	""
+#define	LSOF_HOST	"vm"
+#define	LSOF_LDFLAGS	"-L./lib -llsof  -ltirpc -lpthread"
+#define	LSOF_LOGNAME	""
+#define	LSOF_SYSINFO	"Linux vm 6.18.44-fc-v139 #1 SMP PREEMPT_DYNAMIC @0 x86_64 GNU/Linux"
+#define	LSOF_USER	""
+#define	LSOF_VERSION	"4.94.0"